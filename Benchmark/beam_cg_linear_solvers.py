@@ -22,6 +22,7 @@ cg_solvers = [
     {'name':'Id',   'solver':'ConjugateGradientSolver', 'arguments' : {'preconditioning_method':'Identity', 'maximum_number_of_iterations':number_of_cg_iterations, 'residual_tolerance_threshold':threshold}},
     {'name':'Dia',  'solver':'ConjugateGradientSolver', 'arguments' : {'preconditioning_method':'Diagonal', 'maximum_number_of_iterations':number_of_cg_iterations, 'residual_tolerance_threshold':threshold}},
     {'name':'iChol',  'solver':'ConjugateGradientSolver', 'arguments' : {'preconditioning_method':'IncompleteCholesky',  'maximum_number_of_iterations':number_of_cg_iterations, 'residual_tolerance_threshold':threshold}},
+    {'name':'AMG',  'solver':'ConjugateGradientSolver', 'arguments' : {'preconditioning_method':'AlgebraicMultigrid',  'maximum_number_of_iterations':number_of_cg_iterations, 'residual_tolerance_threshold':threshold}},
     # {'name':'iLU',  'solver':'ConjugateGradientSolver', 'arguments' : {'preconditioning_method':'IncompleteLU',  'maximum_number_of_iterations':number_of_cg_iterations, 'residual_tolerance_threshold':threshold}},
 
     # Sofa solvers
@@ -30,6 +31,17 @@ cg_solvers = [
     {'name':'SSOR',  'solver':'PCGLinearSolver', 'arguments': {'tolerance':threshold*threshold, 'iterations':number_of_cg_iterations}, 'precond':'SSORPreconditioner'},
 ]
 
+def thread_scaling_solvers(solver_names, threads):
+    """Duplicate each of the given Caribou CG solvers once per number of threads of its iterations."""
+    solvers = []
+    for s in cg_solvers:
+        if s['name'] not in solver_names or s['solver'] != 'ConjugateGradientSolver':
+            continue
+        for number_of_threads in threads:
+            arguments = dict(s['arguments'], number_of_threads=number_of_threads)
+            solvers.append({'name': '{}{}t'.format(s['name'], number_of_threads), 'solver': s['solver'], 'arguments': arguments})
+    return solvers
+
 def extract_newton_steps(record):
     if 'StaticODESolver::Solve' not in record:
         return []
@@ -52,7 +64,8 @@ def extract_newton_steps(record):
         if 'ConjugateGradient::ComputeGlobalMatrix' in MBKBuild:
             if 'BuildMatrix' in MBKBuild['ConjugateGradient::ComputeGlobalMatrix']:
                 data['Update global matrix'] = MBKBuild['ConjugateGradient::ComputeGlobalMatrix']['BuildMatrix']['total_time']
-                data['Precond Factorize'] = MBKBuild['ConjugateGradient::ComputeGlobalMatrix']['PreconditionerFactorization']['total_time']
+                if 'PreconditionerFactorization' in MBKBuild['ConjugateGradient::ComputeGlobalMatrix']:
+                    data['Precond Factorize'] = MBKBuild['ConjugateGradient::ComputeGlobalMatrix']['PreconditionerFactorization']['total_time']
                 if 'PreconditionerAnalysis' in MBKBuild['ConjugateGradient::ComputeGlobalMatrix']:
                     data['Precond Analysis'] = MBKBuild['ConjugateGradient::ComputeGlobalMatrix']['PreconditionerAnalysis']['total_time']
             else:
@@ -227,10 +240,23 @@ def createScene(root):
 
 
 if __name__ == "__main__":
+    import argparse
     import Sofa.Simulation
     import Sofa.Core
     import SofaRuntime
 
+    parser = argparse.ArgumentParser(description='Benchmark of the conjugate gradient linear solvers on a beam.')
+    parser.add_argument('--threads', type=str, default=None,
+                        help='Comma separated list of number of threads (ex. 1,2,4,8). When set, only the solvers of '
+                             '--solvers are used, each one once per number of threads of the CG iterations '
+                             '(number_of_threads attribute), to measure the scaling of the mean CG iteration time.')
+    parser.add_argument('--solvers', type=str, default='Id,Dia,iChol',
+                        help='Comma separated list of solvers used for the thread-scaling benchmark.')
+    args = parser.parse_args()
+
+    if args.threads is not None:
+        cg_solvers = thread_scaling_solvers(args.solvers.split(','), [int(t) for t in args.threads.split(',')])
+
 
     root = Sofa.Core.Node()
     createScene(root)
@@ -1,7 +1,9 @@
 #!/usr/bin/python3
 
 import numpy as np
+import os
 import re
+import sys
 import SofaRuntime
 import Sofa
 from SofaRuntime import Timer
@@ -23,14 +25,32 @@ cg_solvers = [
     {'name':'Id',   'solver':'ConjugateGradientSolver', 'arguments' : {'preconditioning_method':'Identity', 'maximum_number_of_iterations':number_of_cg_iterations, 'residual_tolerance_threshold':threshold}},
     {'name':'Dia',  'solver':'ConjugateGradientSolver', 'arguments' : {'preconditioning_method':'Diagonal', 'maximum_number_of_iterations':number_of_cg_iterations, 'residual_tolerance_threshold':threshold}},
     {'name':'iChol',  'solver':'ConjugateGradientSolver', 'arguments' : {'preconditioning_method':'IncompleteCholesky',  'maximum_number_of_iterations':number_of_cg_iterations, 'residual_tolerance_threshold':threshold}},
+    {'name':'AMG',  'solver':'ConjugateGradientSolver', 'arguments' : {'preconditioning_method':'AlgebraicMultigrid',  'maximum_number_of_iterations':number_of_cg_iterations, 'residual_tolerance_threshold':threshold}},
     # {'name':'iLU',  'solver':'ConjugateGradientSolver', 'arguments' : {'preconditioning_method':'IncompleteLU',  'maximum_number_of_iterations':number_of_cg_iterations, 'residual_tolerance_threshold':threshold}},
 
+# Pipelined variants
+    {'name':'IdP',    'solver':'ConjugateGradientSolver', 'arguments' : {'preconditioning_method':'Identity', 'variant':'PIPELINED', 'maximum_number_of_iterations':number_of_cg_iterations, 'residual_tolerance_threshold':threshold}},
+    {'name':'DiaP',   'solver':'ConjugateGradientSolver', 'arguments' : {'preconditioning_method':'Diagonal', 'variant':'PIPELINED', 'maximum_number_of_iterations':number_of_cg_iterations, 'residual_tolerance_threshold':threshold}},
+    {'name':'iCholP', 'solver':'ConjugateGradientSolver', 'arguments' : {'preconditioning_method':'IncompleteCholesky', 'variant':'PIPELINED', 'maximum_number_of_iterations':number_of_cg_iterations, 'residual_tolerance_threshold':threshold}},
+
+# Mixed precision (single precision matrix and preconditioner)
+    {'name':'DiaM',   'solver':'ConjugateGradientSolver', 'arguments' : {'preconditioning_method':'Diagonal', 'mixed_precision':True, 'maximum_number_of_iterations':number_of_cg_iterations, 'residual_tolerance_threshold':threshold}},
+    {'name':'iCholM', 'solver':'ConjugateGradientSolver', 'arguments' : {'preconditioning_method':'IncompleteCholesky', 'mixed_precision':True, 'maximum_number_of_iterations':number_of_cg_iterations, 'residual_tolerance_threshold':threshold}},
+
 # Sofa solvers
     {'name':'sNone', 'solver':'CGLinearSolver', 'arguments':  {'tolerance':threshold, 'threshold':1e-25, 'iterations':number_of_cg_iterations}},
     {'name':'bJac',  'solver':'PCGLinearSolver', 'arguments': {'tolerance':threshold*threshold, 'iterations':number_of_cg_iterations}, 'precond':'BlockJacobiPreconditioner'},
     {'name':'SSOR',  'solver':'PCGLinearSolver', 'arguments': {'tolerance':threshold*threshold, 'iterations':number_of_cg_iterations}, 'precond':'SSORPreconditioner'},
 ]
 
+# Thread-scaling runs only keep the solvers listed in this environment variable (see the main section below)
+if 'CG_BENCHMARK_SOLVERS' in os.environ:
+    selected_solvers = os.environ['CG_BENCHMARK_SOLVERS'].split(',')
+    cg_solvers = [s for s in cg_solvers if s['name'] in selected_solvers]
+    for s in cg_solvers:
+        if s['solver'] == 'ConjugateGradientSolver':
+            s['arguments']['number_of_threads'] = 0  # Follow OMP_NUM_THREADS
+
 
 def extract_newton_steps(record):
     if 'StaticODESolver::Solve' not in record:
@@ -54,7 +74,8 @@ def extract_newton_steps(record):
         if 'ConjugateGradient::ComputeGlobalMatrix' in MBKBuild:
             if 'BuildMatrix' in MBKBuild['ConjugateGradient::ComputeGlobalMatrix']:
                 data['Update global matrix'] = MBKBuild['ConjugateGradient::ComputeGlobalMatrix']['BuildMatrix']['total_time']
-                data['Precond Factorize'] = MBKBuild['ConjugateGradient::ComputeGlobalMatrix']['PreconditionerFactorization']['total_time']
+                if 'PreconditionerFactorization' in MBKBuild['ConjugateGradient::ComputeGlobalMatrix']:
+                    data['Precond Factorize'] = MBKBuild['ConjugateGradient::ComputeGlobalMatrix']['PreconditionerFactorization']['total_time']
                 if 'PreconditionerAnalysis' in MBKBuild['ConjugateGradient::ComputeGlobalMatrix']:
                     data['Precond Analysis'] = MBKBuild['ConjugateGradient::ComputeGlobalMatrix']['PreconditionerAnalysis']['total_time']
             else:
@@ -226,6 +247,26 @@ def createScene(root):
 
 
 if __name__ == "__main__":
+    import argparse
+    import subprocess
+
+    parser = argparse.ArgumentParser(description='Benchmark of the conjugate gradient solvers.')
+    parser.add_argument('--threads', type=str, default=None,
+                        help='Comma separated list of number of threads (ex. 1,2,4,8). When set, the scene is run once '
+                             'per number of threads (OMP_NUM_THREADS) to compare the classic and pipelined variants.')
+    parser.add_argument('--solvers', type=str, default='Id,IdP,Dia,DiaP,iChol,iCholP',
+                        help='Comma separated list of solvers used for the thread-scaling runs.')
+    args = parser.parse_args()
+
+    if args.threads is not None:
+        for number_of_threads in args.threads.split(','):
+            env = dict(os.environ)
+            env['OMP_NUM_THREADS'] = number_of_threads
+            env['CG_BENCHMARK_SOLVERS'] = args.solvers
+            print(f"==== {number_of_threads} thread(s) ====", flush=True)
+            subprocess.run([sys.executable, os.path.abspath(__file__)], env=env, check=True)
+        sys.exit(0)
+
     import Sofa.Simulation
     import Sofa.Core
     import SofaRuntime
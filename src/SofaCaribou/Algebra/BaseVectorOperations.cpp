@@ -1,41 +1,99 @@
 #include <SofaCaribou/config.h>
 #include <SofaCaribou/Algebra/BaseVectorOperations.h>
+#include <SofaCaribou/Algebra/EigenVector.h>
 
 DISABLE_ALL_WARNINGS_BEGIN
 #include <sofa/defaulttype/BaseVector.h>
 #include <SofaBaseLinearSolver/FullVector.h>
 DISABLE_ALL_WARNINGS_END
 
+#include <Eigen/Core>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <type_traits>
+#include <vector>
+
 namespace SofaCaribou::Algebra {
 
 namespace { // Anonymous
 template <typename Real>
-auto to_full_vector(const sofa::defaulttype::BaseVector* v) -> const sofa::component::linearsolver::FullVector<Real> * {
-    return dynamic_cast<const sofa::component::linearsolver::FullVector<Real> *>(v);
+using Vector = Eigen::Matrix<Real, Eigen::Dynamic, 1>;
+
+// Number of entries processed by a single thread. Vectors smaller than this are processed by a single thread.
+constexpr std::int64_t block_size = 1 << 14;
+
+// Pointer to the values of the vector when they are stored contiguously as scalars of type Real, null otherwise.
+template <typename Real>
+auto contiguous_storage(const sofa::defaulttype::BaseVector * v) -> Real * {
+    auto * w = const_cast<sofa::defaulttype::BaseVector *>(v);
+    if (auto * full = dynamic_cast<sofa::component::linearsolver::FullVector<Real> *>(w)) {
+        return full->ptr();
+    }
+    if (auto * eigen = dynamic_cast<EigenVector<Vector<Real>> *>(w)) {
+        return eigen->vector().data();
+    }
+    if (auto * eigen = dynamic_cast<EigenVector<Vector<Real> &> *>(w)) {
+        return eigen->vector().data();
+    }
+    if (auto * eigen = dynamic_cast<EigenVector<Eigen::Map<Vector<Real>>> *>(w)) {
+        return eigen->vector().data();
+    }
+    return nullptr;
 }
 
-// Dot product between a SOFA full vector and any BaseVector
-template <typename ReturnValue, typename Real>
-ReturnValue dot(const sofa::component::linearsolver::FullVector<Real> * v1, const sofa::defaulttype::BaseVector * v2) {
-    const auto n = static_cast<sofa::Size>(v1->size());
-    auto value = static_cast<ReturnValue>(0);
-    for (sofa::Index i = 0; i < n; ++i) {
-        value +=  ( v1->element(i) * v2->element(i) );
+// Call the kernel with an Eigen map over the values of the vector. Returns false if its values aren't stored contiguously.
+template <typename Kernel>
+bool with_map(const sofa::defaulttype::BaseVector * v, Kernel && kernel) {
+    const auto n = static_cast<Eigen::Index>(v->size());
+    if (auto * values = contiguous_storage<double>(v)) {
+        kernel(Eigen::Map<Vector<double>>(values, n));
+        return true;
+    }
+    if (auto * values = contiguous_storage<float>(v)) {
+        kernel(Eigen::Map<Vector<float>>(values, n));
+        return true;
     }
+    return false;
+}
 
-    return value;
+// Apply the kernel on every blocks [start, start+size[ of a vector of n entries, in parallel when there are many blocks
+template <typename Kernel>
+void for_each_block(std::int64_t n, Kernel && kernel) {
+    const auto number_of_blocks = (n + block_size - 1) / block_size;
+    #pragma omp parallel for schedule(static) if (number_of_blocks > 1)
+    for (std::int64_t k = 0; k < number_of_blocks; ++k) {
+        const auto start = k*block_size;
+        kernel(k, start, std::min(block_size, n - start));
+    }
 }
 
-// Dot product between a two SOFA full vectors
-template <typename ReturnValue, typename Real1, typename Real2>
-ReturnValue dot(const sofa::component::linearsolver::FullVector<Real1> * v1, const sofa::component::linearsolver::FullVector<Real2> * v2) {
-    const auto n = static_cast<sofa::Size>(v1->size());
-    auto value = static_cast<ReturnValue>(0);
-    for (sofa::Index i = 0; i < n; ++i) {
-        value +=  ( v1->element(i) * v2->element(i) );
+// Sum of the kernel values of every blocks. The partial sums are added in the order of the blocks, which gives the
+// same result whatever the number of threads.
+template <typename Kernel>
+double reduce_blocks(std::int64_t n, Kernel && kernel) {
+    const auto number_of_blocks = (n + block_size - 1) / block_size;
+    if (number_of_blocks <= 1) {
+        return (n > 0) ? kernel(0, n) : 0.;
     }
 
-    return value;
+    std::vector<double> partial_sums (static_cast<std::size_t>(number_of_blocks));
+    for_each_block(n, [&] (std::int64_t k, std::int64_t start, std::int64_t size) {
+        partial_sums[static_cast<std::size_t>(k)] = kernel(start, size);
+    });
+    return std::accumulate(partial_sums.begin(), partial_sums.end(), 0.);
+}
+
+template <typename A, typename B>
+double dot_kernel(const A & a, const B & b) {
+    using Scalar = std::common_type_t<typename A::Scalar, typename B::Scalar>;
+    return reduce_blocks(a.size(), [&] (std::int64_t start, std::int64_t size) {
+        return static_cast<double>(
+            a.segment(start, size).template cast<Scalar>().dot(b.segment(start, size).template cast<Scalar>())
+        );
+    });
 }
 }
 
@@ -43,68 +101,93 @@ ReturnValue dot(const sofa::component::linearsolver::FullVector<Real1> * v1, con
 CARIBOU_API double dot(const sofa::defaulttype::BaseVector * v1, const sofa::defaulttype::BaseVector * v2) {
     caribou_assert(v1->size() == v2->size());
 
-    // todo(jnbrunet2000@gmail.com): This function is awful. I'm sure there is a much much cleaner and faster way
-    //                               to do this. But I'm running out of time.
+    double value = 0;
+    bool done = false;
+    with_map(v1, [&] (const auto & a) {
+        done = with_map(v2, [&] (const auto & b) {
+            value = dot_kernel(a, b);
+        });
+    });
+    if (done) {
+        return value;
+    }
 
-    // Most common case first FullVector<SReal> - FullVector<SReal> :
-    {
-        const auto * full_v1 = to_full_vector<SReal >(v1);
-        const auto * full_v2 = to_full_vector<SReal >(v2);
-        if (full_v1 && full_v2) {
-            return full_v1->dot(*full_v2);
-        }
+    // Generic case (unoptimized!)
+    const auto n = static_cast<sofa::Size>(v1->size());
+    for (sofa::Index i = 0; i < n; ++i) {
+        value +=  ( v1->element(i) * v2->element(i) );
     }
 
-    // Next, we need to find the good virtual type....
+    return value;
+}
 
-    // FullVector<double> - *
-    if (const auto * full_v1 = to_full_vector<double>(v1)) {
-        if (const auto * full_v2 = to_full_vector<double>(v2)) {
-            // FullVector<double> - FullVector<double>
-            return full_v1->dot(*full_v2);
-        } else if (const auto * full_v2 = to_full_vector<float>(v2)) {
-            // FullVector<double> - FullVector<float>
-            return dot<double>(full_v1, full_v2);
-        } else {
-            // FullVector<double> - BaseVector
-            return dot<double>(full_v1, v2);
-        }
+/** Compute the squared euclidean norm of a BaseVector, i.e. scalar = v.dot(v) */
+CARIBOU_API double squared_norm(const sofa::defaulttype::BaseVector * v) {
+    double value = 0;
+    const bool done = with_map(v, [&] (const auto & a) {
+        value = reduce_blocks(a.size(), [&] (std::int64_t start, std::int64_t size) {
+            return static_cast<double>(a.segment(start, size).squaredNorm());
+        });
+    });
+    if (done) {
+        return value;
     }
 
-    // FullVector<float> - *
-    if (const auto * full_v1 = to_full_vector<float>(v1)) {
-        if (const auto * full_v2 = to_full_vector<float>(v2)) {
-            // FullVector<float> - FullVector<float>
-            return full_v1->dot(*full_v2);
-        } else if (const auto * full_v2 = to_full_vector<double>(v2)) {
-            // FullVector<float> - FullVector<double>
-            return dot<double>(full_v1, full_v2);
-        } else {
-            // FullVector<float> - BaseVector
-            return dot<double>(full_v1, v2);
-        }
+    // Generic case (unoptimized!)
+    const auto n = static_cast<sofa::Size>(v->size());
+    for (sofa::Index i = 0; i < n; ++i) {
+        value += v->element(i) * v->element(i);
     }
 
-    // v1 isn't a full vector... Maybe v2 is?
-    // * - FullVector<double>
-    if (const auto * full_v2 = to_full_vector<double>(v2)) {
-        return dot<double>(full_v2, v1);
-    }
+    return value;
+}
+
+/** Compute the euclidean norm of a BaseVector, i.e. scalar = sqrt(v.dot(v)) */
+CARIBOU_API double norm(const sofa::defaulttype::BaseVector * v) {
+    return std::sqrt(squared_norm(v));
+}
 
-    // * - FullVector<float>
-    if (const auto * full_v2 = to_full_vector<float>(v2)) {
-        return dot<double>(full_v2, v1);
+/** Accumulate a scaled BaseVector into another one, i.e. y = y + a*x */
+CARIBOU_API void axpy(double a, const sofa::defaulttype::BaseVector * x, sofa::defaulttype::BaseVector * y) {
+    caribou_assert(x->size() == y->size());
+
+    bool done = false;
+    with_map(y, [&] (auto y_map) {
+        done = with_map(x, [&] (const auto & x_map) {
+            using Scalar = typename decltype(y_map)::Scalar;
+            for_each_block(y_map.size(), [&] (std::int64_t /*k*/, std::int64_t start, std::int64_t size) {
+                y_map.segment(start, size) += static_cast<Scalar>(a) * x_map.segment(start, size).template cast<Scalar>();
+            });
+        });
+    });
+    if (done) {
+        return;
     }
 
     // Generic case (unoptimized!)
-    // * - *
-    const auto n = static_cast<sofa::Size>(v1->size());
-    auto value = static_cast<SReal>(0);
+    const auto n = static_cast<sofa::Size>(y->size());
     for (sofa::Index i = 0; i < n; ++i) {
-        value +=  ( v1->element(i) * v2->element(i) );
+        y->add(i, a*x->element(i));
     }
+}
 
-    return static_cast<double> (value);
+/** Scale a BaseVector, i.e. v = a*v */
+CARIBOU_API void scale(double a, sofa::defaulttype::BaseVector * v) {
+    const bool done = with_map(v, [&] (auto map) {
+        using Scalar = typename decltype(map)::Scalar;
+        for_each_block(map.size(), [&] (std::int64_t /*k*/, std::int64_t start, std::int64_t size) {
+            map.segment(start, size) *= static_cast<Scalar>(a);
+        });
+    });
+    if (done) {
+        return;
+    }
+
+    // Generic case (unoptimized!)
+    const auto n = static_cast<sofa::Size>(v->size());
+    for (sofa::Index i = 0; i < n; ++i) {
+        v->set(i, a*v->element(i));
+    }
 }
 
-} // namespace SofaCaribou::Algebra
\ No newline at end of file
+} // namespace SofaCaribou::Algebra
@@ -5,6 +5,11 @@
 // Various utilities to perform numerical operations on SOFA's BaseVector.
 // These utilities are responsible to automatically find the type of vector
 // and perform the optimal operations on them.
+//
+// The type of the vectors is resolved once per call. When the values of the vectors are stored contiguously (SOFA's
+// FullVector, and Caribou's EigenVector of a dense Eigen vector or of a map over one), the operation is done by
+// vectorized (SIMD) Eigen kernels, split into blocks processed in parallel when OpenMP is available. Any other type of
+// vectors falls back to the virtual accessors of BaseVector.
 
 namespace sofa::defaulttype {
 class BaseVector;
@@ -12,15 +17,19 @@ class BaseVector;
 
 namespace SofaCaribou::Algebra {
 
-
-/**
- * Compute the dot product between two BaseVector, i.e. scalar = v1.dot(v2) *
- *
- * @todo (jnbrunet2000@gmail.com) : this could be much more optimal using delegate functions. For example, we could first
- *                                  get a callback to an optimal dot function for these types of v1 and v2, and later
- *                                  simply reuse this callback. Hence we avoid the need to do multiple virtual checks
- *                                  each time this function is called
- */
+/** Compute the dot product between two BaseVector, i.e. scalar = v1.dot(v2) */
 CARIBOU_API double dot(const sofa::defaulttype::BaseVector * v1, const sofa::defaulttype::BaseVector * v2);
 
-} // namespace SofaCaribou::Algebra
\ No newline at end of file
+/** Compute the squared euclidean norm of a BaseVector, i.e. scalar = v.dot(v) */
+CARIBOU_API double squared_norm(const sofa::defaulttype::BaseVector * v);
+
+/** Compute the euclidean norm of a BaseVector, i.e. scalar = sqrt(v.dot(v)) */
+CARIBOU_API double norm(const sofa::defaulttype::BaseVector * v);
+
+/** Accumulate a scaled BaseVector into another one, i.e. y = y + a*x */
+CARIBOU_API void axpy(double a, const sofa::defaulttype::BaseVector * x, sofa::defaulttype::BaseVector * y);
+
+/** Scale a BaseVector, i.e. v = a*v */
+CARIBOU_API void scale(double a, sofa::defaulttype::BaseVector * v);
+
+} // namespace SofaCaribou::Algebra
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <SofaCaribou/config.h>
+
+namespace SofaCaribou::Algebra {
+
+/**
+ * Interface of the matrices able to clear many rows and columns at once.
+ *
+ * The projective constraints (for example, the fixed constraints) clear the rows and columns of their DOFs one at a
+ * time through the BaseMatrix API (clearRow, clearCol and clearRowCol). For a sparse matrix, each of these calls can
+ * require a search in every outer vectors of the matrix. Between the calls to begin_batched_clearing and
+ * end_batched_clearing, the rows and columns to clear are instead only recorded, and they are all cleared with a
+ * single pass over the matrix when the batch ends.
+ *
+ * Example:
+ * \code{.cpp}
+ *    A->begin_batched_clearing();
+ *    A->clearRowCol(3); // Only recorded
+ *    A->clearRowCol(4); // Only recorded
+ *    A->set(3, 3, 1.);  // Only recorded
+ *    A->end_batched_clearing(); // Clears the rows and columns 3 and 4, then sets A(3,3) = 1
+ * \endcode
+ */
+class BatchedClearing {
+public:
+    virtual ~BatchedClearing() = default;
+
+    /**
+     * Start recording the rows and columns cleared. Until the next call to end_batched_clearing, the calls to clearRow,
+     * clearRows, clearCol, clearCols, clearRowCol, set and add are recorded instead of being applied.
+     */
+    virtual void begin_batched_clearing() = 0;
+
+    /**
+     * Clear all the rows and columns recorded since the last call to begin_batched_clearing, and then apply the
+     * recorded calls to set and add, as if they all had been applied in the order of the calls.
+     */
+    virtual void end_batched_clearing() = 0;
+};
+
+} // namespace SofaCaribou::Algebra
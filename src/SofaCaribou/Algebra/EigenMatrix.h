@@ -1,5 +1,6 @@
 #pragma once
 #include <SofaCaribou/config.h>
+#include <SofaCaribou/Algebra/BatchedClearing.h>
 #include <Caribou/macros.h>
 #include <Caribou/traits.h>
 
@@ -10,6 +11,16 @@ DISABLE_ALL_WARNINGS_END
 #include <Eigen/Core>
 #include <Eigen/Sparse>
 
+#ifdef CARIBOU_WITH_OPENMP
+#include <omp.h>
+#endif
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <vector>
+
 namespace SofaCaribou::Algebra {
 
 /**
@@ -151,7 +162,7 @@ private:
 /// SparseMatrix specialization ///
 ///////////////////////////////////
 template <typename Derived>
-class EigenMatrix<Derived, CLASS_REQUIRES(std::is_base_of_v<Eigen::SparseMatrixBase<std::decay_t<Derived>>, std::decay_t<Derived>>)> : public sofa::defaulttype::BaseMatrix
+class EigenMatrix<Derived, CLASS_REQUIRES(std::is_base_of_v<Eigen::SparseMatrixBase<std::decay_t<Derived>>, std::decay_t<Derived>>)> : public sofa::defaulttype::BaseMatrix, public BatchedClearing
 {
 
 public:
@@ -160,6 +171,7 @@ public:
     using Index = Base::Index;
     using Real = SReal;
     using Scalar = typename EigenType::Scalar;
+    using Triplet = Eigen::Triplet<Scalar, typename EigenType::StorageIndex>;
 
     /**
      * Construct the class using another Eigen matrix. Depending on the template parameter used for the class,
@@ -195,6 +207,43 @@ public:
      */
     inline void set_symmetric(bool is_symmetric) { p_is_symmetric = is_symmetric; }
 
+    /**
+     * Number of triplets above which the matrix is built with a parallel counting sort instead of Eigen's
+     * setFromTriplets when it is initialized (see compress).
+     */
+    inline auto parallel_conversion_threshold() const -> std::size_t {return p_parallel_conversion_threshold;}
+
+    /**
+     * Set the number of triplets above which the matrix is built with a parallel counting sort instead of Eigen's
+     * setFromTriplets when it is initialized (see compress).
+     */
+    inline void set_parallel_conversion_threshold(std::size_t threshold) { p_parallel_conversion_threshold = threshold; }
+
+    /** States if the pattern of the matrix is kept when it is cleared (see set_pattern_frozen). */
+    inline bool pattern_is_frozen() const {return p_pattern_is_frozen;}
+
+    /**
+     * Keep the pattern of the matrix when it is cleared.
+     *
+     * Once the matrix has been initialized (after the first assembly), clear() only sets the values of the stored
+     * coefficients to zero instead of dropping the compressed structure. The next assembly then directly accumulates
+     * into the existing coefficients, without the triplet list and the sort of setFromTriplets.
+     *
+     * In addition, the position of every coefficient added is recorded in the order of the calls to add. When the
+     * matrix is assembled again in the same order (which is the case of the SOFA assembly visitors), each call to add
+     * hence is a direct write into the value array of the matrix, without any search. A coefficient outside of the
+     * current pattern is still inserted, in which case the pattern is compressed and recorded again at the next clear.
+     *
+     * This should only be enabled when the matrix is entirely assembled again after each clear, since the pattern is
+     * the union of the patterns of all the assemblies.
+     */
+    inline void set_pattern_frozen(bool is_frozen) {
+        p_pattern_is_frozen = is_frozen;
+        p_slots.clear();
+        p_next_slot = 0;
+        p_slots_are_valid = (not p_initialized or p_eigen_matrix.isCompressed());
+    }
+
     /**
      * @brief Return the matrix entry (i,j).
      * \warning If the matrix hasn't been initialized by calling compress() or set(), this
@@ -212,8 +261,23 @@ public:
         p_initialized = false;
     }
 
-    /** Set all entries to zero. Keeps the current matrix dimensions. */
+    /**
+     * Set all entries to zero. Keeps the current matrix dimensions. When the pattern is frozen (see set_pattern_frozen),
+     * the stored coefficients are kept and set to zero.
+     */
     inline void  clear() final {
+        if (p_pattern_is_frozen and p_initialized) {
+            if (not p_slots_are_valid) {
+                // The pattern changed during the last assembly, the positions recorded are outdated
+                this->p_eigen_matrix.makeCompressed();
+                p_slots.clear();
+                p_slots_are_valid = true;
+            }
+            std::fill_n(this->p_eigen_matrix.valuePtr(), this->p_eigen_matrix.nonZeros(), static_cast<Scalar>(0));
+            p_next_slot = 0;
+            return;
+        }
+
         p_triplets.clear();
         this->p_eigen_matrix.setZero();
         p_initialized = false;
@@ -232,6 +296,20 @@ public:
             initialize();
         }
 
+        if (p_clearing_is_batched) {
+            p_pending_entries.push_back({i, j, static_cast<Scalar>(v), true, ++p_batch_time});
+            return;
+        }
+
+        if (p_pattern_is_frozen and p_slots_are_valid) {
+            const auto position = find_position(i, j);
+            if (position >= 0) {
+                this->p_eigen_matrix.valuePtr()[position] = static_cast<Scalar>(v);
+                return;
+            }
+            p_slots_are_valid = false; // The coefficient is inserted, the pattern changes
+        }
+
         this->p_eigen_matrix.coeffRef(i, j) = static_cast<Scalar>(v);
     }
 
@@ -248,7 +326,7 @@ public:
         if (not p_initialized) {
             p_triplets.emplace_back(i, j, static_cast<Scalar>(v));
         } else {
-            p_eigen_matrix.coeffRef(i, j) += static_cast<Scalar>(v);
+            accumulate(i, j, static_cast<Scalar>(v));
         }
     }
 
@@ -278,6 +356,11 @@ public:
             initialize();
         }
 
+        if (p_clearing_is_batched) {
+            p_row_cleared_at[row_id] = ++p_batch_time;
+            return;
+        }
+
         using StorageIndex = typename EigenType::StorageIndex;
 
         if constexpr (EigenType::IsRowMajor) {
@@ -302,6 +385,11 @@ public:
             initialize();
         }
 
+        if (p_clearing_is_batched) {
+            std::fill(p_row_cleared_at.begin()+imin, p_row_cleared_at.begin()+imax+1, ++p_batch_time);
+            return;
+        }
+
         using StorageIndex = typename EigenType::StorageIndex;
 
         if constexpr (EigenType::IsRowMajor) {
@@ -330,6 +418,11 @@ public:
             initialize();
         }
 
+        if (p_clearing_is_batched) {
+            p_col_cleared_at[col_id] = ++p_batch_time;
+            return;
+        }
+
         using StorageIndex = typename EigenType::StorageIndex;
 
         if constexpr (not EigenType::IsRowMajor) {
@@ -354,6 +447,11 @@ public:
             initialize();
         }
 
+        if (p_clearing_is_batched) {
+            std::fill(p_col_cleared_at.begin()+imin, p_col_cleared_at.begin()+imax+1, ++p_batch_time);
+            return;
+        }
+
         using StorageIndex = typename EigenType::StorageIndex;
 
         if constexpr (not EigenType::IsRowMajor) {
@@ -382,6 +480,11 @@ public:
             initialize();
         }
 
+        if (p_clearing_is_batched) {
+            p_row_cleared_at[i] = p_col_cleared_at[i] = ++p_batch_time;
+            return;
+        }
+
         using StorageIndex = typename EigenType::StorageIndex;
 
         // Clear the complete inner vector i (the row i or column i if it is in row major or column major respectively)
@@ -415,6 +518,105 @@ public:
         }
     }
 
+    /**
+     * Sets to zero the rows i for which rows[i] is true, and the columns j for which columns[j] is true, with a single
+     * pass over the stored coefficients. An empty mask leaves every rows (or columns) untouched.
+     */
+    void clear_rows_and_columns(const std::vector<bool> & rows, const std::vector<bool> & columns) {
+        if (not p_initialized) {
+            initialize();
+        }
+
+        caribou_assert(rows.empty() or rows.size() == static_cast<std::size_t>(p_eigen_matrix.rows()));
+        caribou_assert(columns.empty() or columns.size() == static_cast<std::size_t>(p_eigen_matrix.cols()));
+
+        const auto & outer_mask = EigenType::IsRowMajor ? rows : columns;
+        const auto & inner_mask = EigenType::IsRowMajor ? columns : rows;
+        const auto outer_size = static_cast<std::int64_t>(p_eigen_matrix.outerSize());
+        const auto * outer_index = p_eigen_matrix.outerIndexPtr();
+        const auto * inner_index = p_eigen_matrix.innerIndexPtr();
+        const auto * inner_non_zeros = p_eigen_matrix.innerNonZeroPtr(); // Null when the matrix is compressed
+        Scalar * values = p_eigen_matrix.valuePtr();
+
+        #pragma omp parallel for schedule(dynamic, 256)
+        for (std::int64_t j = 0; j < outer_size; ++j) {
+            const auto start = outer_index[j];
+            const auto end = inner_non_zeros ? start + inner_non_zeros[j] : outer_index[j+1];
+            if (not outer_mask.empty() and outer_mask[j]) {
+                std::fill(values + start, values + end, static_cast<Scalar>(0));
+            } else if (not inner_mask.empty()) {
+                for (auto k = start; k < end; ++k) {
+                    if (inner_mask[inner_index[k]]) {
+                        values[k] = static_cast<Scalar>(0);
+                    }
+                }
+            }
+        }
+    }
+
+    /** Sets to zero the rows and columns of the given DOFs with a single pass over the stored coefficients. */
+    void clear_rows_and_columns(const std::vector<Index> & dofs) {
+        std::vector<bool> rows (p_eigen_matrix.rows(), false);
+        std::vector<bool> columns (p_eigen_matrix.cols(), false);
+        for (const auto & i : dofs) {
+            rows[i] = columns[i] = true;
+        }
+        clear_rows_and_columns(rows, columns);
+    }
+
+    // BatchedClearing overrides
+    void begin_batched_clearing() final {
+        if (not p_initialized) {
+            initialize();
+        }
+
+        p_clearing_is_batched = true;
+        p_batch_time = 0;
+        p_row_cleared_at.assign(p_eigen_matrix.rows(), 0);
+        p_col_cleared_at.assign(p_eigen_matrix.cols(), 0);
+        p_pending_entries.clear();
+    }
+
+    void end_batched_clearing() final {
+        if (not p_clearing_is_batched) {
+            return;
+        }
+        p_clearing_is_batched = false;
+
+        std::vector<bool> rows (p_row_cleared_at.size()), columns (p_col_cleared_at.size());
+        bool rows_are_cleared = false, columns_are_cleared = false;
+        for (std::size_t i = 0; i < rows.size(); ++i) {
+            rows[i] = (p_row_cleared_at[i] > 0);
+            rows_are_cleared |= rows[i];
+        }
+        for (std::size_t j = 0; j < columns.size(); ++j) {
+            columns[j] = (p_col_cleared_at[j] > 0);
+            columns_are_cleared |= columns[j];
+        }
+        if (not rows_are_cleared) {
+            rows.clear();
+        }
+        if (not columns_are_cleared) {
+            columns.clear();
+        }
+        if (rows_are_cleared or columns_are_cleared) {
+            clear_rows_and_columns(rows, columns);
+        }
+
+        // The entries set or added after the last clearing of their row and column are applied in their order
+        for (const auto & entry : p_pending_entries) {
+            if (p_row_cleared_at[entry.row] > entry.time or p_col_cleared_at[entry.col] > entry.time) {
+                continue;
+            }
+            if (entry.is_set) {
+                set(entry.row, entry.col, entry.value);
+            } else {
+                accumulate(entry.row, entry.col, entry.value);
+            }
+        }
+        p_pending_entries.clear();
+    }
+
     /** Get a const reference to the underlying Eigen matrix  */
     const Derived & matrix() const {return p_eigen_matrix;}
 private:
@@ -424,14 +626,14 @@ private:
      */
     template <typename Scalar, unsigned int N, unsigned int C>
     void add_block(Index i, Index j, const sofa::defaulttype::Mat<N, C, Scalar> & m) {
-        using StorageIndex = typename Eigen::SparseMatrix<typename EigenType::Scalar>::StorageIndex;
+        using StorageIndex = typename EigenType::StorageIndex;
         for (unsigned int k=0;k<N;++k) {
             for (unsigned int l=0;l<C;++l) {
                 const auto value = static_cast<typename EigenType::Scalar>(m[k][l]);
                 if (not p_initialized) {
                     p_triplets.emplace_back(static_cast<StorageIndex>(i+k), static_cast<StorageIndex>(j+l), value);
                 } else {
-                    p_eigen_matrix.coeffRef(i+k, j+l) += value;
+                    accumulate(i+k, j+l, value);
                 }
             }
         }
@@ -443,14 +645,192 @@ private:
      *        if the entries to be added were zero before hand.
      */
     void initialize() {
-        p_eigen_matrix.setFromTriplets(p_triplets.begin(), p_triplets.end());
+        if (p_triplets.size() >= p_parallel_conversion_threshold) {
+            set_from_triplets_by_counting_sort();
+        } else {
+            p_eigen_matrix.setFromTriplets(p_triplets.begin(), p_triplets.end());
+        }
         p_triplets.clear();
+        if (p_pattern_is_frozen) {
+            // The triplets won't be used anymore since the pattern is kept
+            p_triplets.shrink_to_fit();
+        }
         p_initialized = true;
+        p_slots.clear();
+        p_next_slot = 0;
+        p_slots_are_valid = true;
+    }
+
+    /**
+     * Build the compressed matrix from the triplets with a two-pass counting sort, done in parallel when OpenMP is
+     * available:
+     *   1. Count the triplets of every outer vectors (columns in column major, rows in row major);
+     *   2. Prefix sum of the counts, which gives the first position of every outer vectors;
+     *   3. Scatter the indices of the triplets at the position of their outer vector;
+     *   4. Sort each outer vector by inner index and merge the duplicates.
+     * Unlike setFromTriplets, which inserts every triplet into a temporary transposed matrix on a single thread, only
+     * an array of triplet indices is allocated on top of the triplets. These indices are 32-bit as long as the number
+     * of triplets allows it, which halves this array. The duplicates are summed in the order of the triplets, hence the
+     * result is exactly the same as the one of setFromTriplets, whatever the number of threads.
+     */
+    void set_from_triplets_by_counting_sort() {
+        if (p_triplets.size() <= static_cast<std::size_t>(std::numeric_limits<std::uint32_t>::max())) {
+            set_from_triplets_by_counting_sort<std::uint32_t>();
+        } else {
+            set_from_triplets_by_counting_sort<std::size_t>();
+        }
+    }
+
+    /**
+     * Counting sort conversion of the triplets (see set_from_triplets_by_counting_sort()), where TripletIndex is the
+     * unsigned integer type used to store the triplet indices and the positions of the outer vectors.
+     */
+    template <typename TripletIndex>
+    void set_from_triplets_by_counting_sort() {
+        using StorageIndex = typename EigenType::StorageIndex;
+        const auto number_of_triplets = static_cast<std::int64_t>(p_triplets.size());
+        const auto outer_size = static_cast<std::int64_t>(p_eigen_matrix.outerSize());
+        const Triplet * triplets = p_triplets.data();
+        const auto outer_of = [triplets] (std::size_t k) { return EigenType::IsRowMajor ? triplets[k].row() : triplets[k].col(); };
+        const auto inner_of = [triplets] (std::size_t k) { return EigenType::IsRowMajor ? triplets[k].col() : triplets[k].row(); };
+
+        // 1. Number of triplets of every outer vectors
+        std::vector<TripletIndex> offsets (outer_size+1, 0);
+        #pragma omp parallel for schedule(static)
+        for (std::int64_t k = 0; k < number_of_triplets; ++k) {
+            #pragma omp atomic
+            offsets[outer_of(k)+1]++;
+        }
+
+        // 2. Position of the first triplet of every outer vectors
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+        // 3. Scatter the triplet indices
+        std::vector<TripletIndex> order (number_of_triplets);
+        std::vector<TripletIndex> cursor (offsets.begin(), offsets.end()-1);
+        #pragma omp parallel for schedule(static)
+        for (std::int64_t k = 0; k < number_of_triplets; ++k) {
+            TripletIndex position;
+            #pragma omp atomic capture
+            position = cursor[outer_of(k)]++;
+            order[position] = static_cast<TripletIndex>(k);
+        }
+
+        // 4. Sort every outer vectors by inner index (the ties being sorted by triplet index) and count the unique entries
+        std::vector<StorageIndex> outer_index (outer_size+1, 0);
+        #pragma omp parallel for schedule(dynamic, 256)
+        for (std::int64_t j = 0; j < outer_size; ++j) {
+            const auto begin = order.begin() + static_cast<std::ptrdiff_t>(offsets[j]);
+            const auto end   = order.begin() + static_cast<std::ptrdiff_t>(offsets[j+1]);
+            std::sort(begin, end, [&inner_of] (TripletIndex a, TripletIndex b) {
+                return inner_of(a) < inner_of(b) or (inner_of(a) == inner_of(b) and a < b);
+            });
+
+            StorageIndex number_of_unique_entries = 0;
+            for (auto it = begin; it != end; ++it) {
+                if (it == begin or inner_of(*it) != inner_of(*(it-1))) {
+                    ++number_of_unique_entries;
+                }
+            }
+            outer_index[j+1] = number_of_unique_entries;
+        }
+        std::partial_sum(outer_index.begin(), outer_index.end(), outer_index.begin());
+
+        // 5. Fill the compressed storage, summing up the duplicates
+        p_eigen_matrix.setZero();
+        p_eigen_matrix.makeCompressed();
+        p_eigen_matrix.resizeNonZeros(static_cast<Eigen::Index>(outer_index[outer_size]));
+        std::copy(outer_index.begin(), outer_index.end(), p_eigen_matrix.outerIndexPtr());
+        StorageIndex * inner_indices = p_eigen_matrix.innerIndexPtr();
+        Scalar * values = p_eigen_matrix.valuePtr();
+
+        #pragma omp parallel for schedule(dynamic, 256)
+        for (std::int64_t j = 0; j < outer_size; ++j) {
+            auto position = outer_index[j];
+            for (auto k = offsets[j]; k < offsets[j+1]; ++k) {
+                const auto t = order[k];
+                if (k > offsets[j] and inner_of(t) == inner_indices[position-1]) {
+                    values[position-1] += triplets[t].value();
+                } else {
+                    inner_indices[position] = static_cast<StorageIndex>(inner_of(t));
+                    values[position] = triplets[t].value();
+                    ++position;
+                }
+            }
+        }
+    }
+
+    /**
+     * Position of the coefficient (i, j) in the value array of the compressed matrix, or -1 if it isn't stored.
+     */
+    Eigen::Index find_position(Index i, Index j) const {
+        using StorageIndex = typename EigenType::StorageIndex;
+        const auto outer = EigenType::IsRowMajor ? i : j;
+        const auto inner = EigenType::IsRowMajor ? j : i;
+        const auto start = p_eigen_matrix.outerIndexPtr()[outer];
+        const auto end   = p_eigen_matrix.outerIndexPtr()[outer+1];
+        const auto id = p_eigen_matrix.data().searchLowerIndex(start, end, static_cast<StorageIndex>(inner));
+        return ((id<end) && (p_eigen_matrix.data().index(id)==inner)) ? static_cast<Eigen::Index>(id) : -1;
     }
 
+    /**
+     * Adds v to the coefficient (i, j) of an initialized matrix. When the pattern is frozen, the position of the
+     * coefficient is taken from the one recorded for the same call during the previous assembly.
+     */
+    inline void accumulate(Index i, Index j, const Scalar & v) {
+        if (p_clearing_is_batched) {
+            p_pending_entries.push_back({i, j, v, false, ++p_batch_time});
+            return;
+        }
+
+        if (p_pattern_is_frozen and p_slots_are_valid) {
+            if (p_next_slot < p_slots.size()) {
+                const auto & slot = p_slots[p_next_slot];
+                if (slot.row == i and slot.col == j) {
+                    p_eigen_matrix.valuePtr()[slot.position] += v;
+                    ++p_next_slot;
+                    return;
+                }
+            }
+
+            // Not the same call than during the previous assembly, record the new position from here
+            const auto position = find_position(i, j);
+            if (position >= 0) {
+                p_slots.resize(p_next_slot);
+                p_slots.push_back({i, j, position});
+                ++p_next_slot;
+                p_eigen_matrix.valuePtr()[position] += v;
+                return;
+            }
+
+            p_slots_are_valid = false; // The coefficient is inserted, the pattern changes
+        }
+
+        p_eigen_matrix.coeffRef(i, j) += v;
+    }
+
+    ///< Call to set or add recorded during a batched clearing.
+    struct PendingEntry {
+        Index row;
+        Index col;
+        Scalar value;
+        bool is_set;
+        std::size_t time;
+    };
+
+    ///< Position of a coefficient in the value array of the compressed matrix, recorded during an assembly.
+    struct Slot {
+        Index row;
+        Index col;
+        Eigen::Index position;
+    };
+
     ///< Triplets are used to store matrix entries before the call to 'compress'.
     /// Duplicates entries are summed up.
-    std::vector<Eigen::Triplet<typename EigenType::Scalar>> p_triplets;
+    std::vector<Triplet> p_triplets;
+
+    ///< Number of triplets above which the matrix is initialized with the (parallel) counting sort conversion.
+    std::size_t p_parallel_conversion_threshold = 1 << 20;
 
     ///< Whether or not the matrix has been initialized with triplets yet. This will determined the behavior
     /// of the add and set methods. When the matrix hasn't been initialized, the add and set methods will simply append
@@ -463,6 +843,31 @@ private:
     ///< States if the matrix is symmetric. Note that this value isn't set automatically, the user must
     ///< explicitly specify it using set_symmetric(true). When it is true, some optimizations will be enabled.
     bool p_is_symmetric = false;
+
+    ///< States if the pattern of the matrix is kept when it is cleared (see set_pattern_frozen).
+    bool p_pattern_is_frozen = false;
+
+    ///< Positions of the coefficients in the order of the calls to add during the last assembly (frozen pattern only).
+    std::vector<Slot> p_slots;
+
+    ///< Index of the next recorded position expected during the current assembly.
+    std::size_t p_next_slot = 0;
+
+    ///< False when a coefficient was inserted since the last clear, in which case the recorded positions are outdated.
+    bool p_slots_are_valid = true;
+
+    ///< True between the calls to begin_batched_clearing and end_batched_clearing.
+    bool p_clearing_is_batched = false;
+
+    ///< Number of calls recorded since the beginning of the batched clearing, used to order them.
+    std::size_t p_batch_time = 0;
+
+    ///< Time of the last clearing of every rows and columns during the batched clearing (0 if it wasn't cleared).
+    std::vector<std::size_t> p_row_cleared_at;
+    std::vector<std::size_t> p_col_cleared_at;
+
+    ///< Calls to set and add recorded during the batched clearing.
+    std::vector<PendingEntry> p_pending_entries;
 };
 
 } // namespace SofaCaribou::Algebra
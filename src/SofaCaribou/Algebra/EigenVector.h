@@ -11,6 +11,8 @@ DISABLE_ALL_WARNINGS_END
 
 #include <Eigen/Dense>
 
+#include <optional>
+
 namespace SofaCaribou::Algebra {
 
 /**
@@ -102,4 +104,34 @@ private:
     Derived p_eigen_vector;
 };
 
+/**
+ * Get a view over the values of a BaseVector wrapping either an Eigen vector of type Vector (EigenVector<Vector>), or a
+ * map over the memory of such a vector (EigenVector<Eigen::Map<Vector>>). The latter is used for example to share the
+ * memory of a mechanical object (see map_mechanical_vector).
+ *
+ * @return The view, or nothing if v isn't one of these types of vector.
+ */
+template <typename Vector>
+auto eigen_vector_view(sofa::defaulttype::BaseVector * v) -> std::optional<Eigen::Map<Vector>> {
+    if (auto * w = dynamic_cast<EigenVector<Vector> *>(v)) {
+        return Eigen::Map<Vector>(w->vector().data(), w->vector().size());
+    }
+    if (auto * w = dynamic_cast<EigenVector<Eigen::Map<Vector>> *>(v)) {
+        return Eigen::Map<Vector>(w->vector().data(), w->vector().size());
+    }
+    return std::nullopt;
+}
+
+/** @see eigen_vector_view */
+template <typename Vector>
+auto eigen_vector_view(const sofa::defaulttype::BaseVector * v) -> std::optional<Eigen::Map<const Vector>> {
+    if (const auto * w = dynamic_cast<const EigenVector<Vector> *>(v)) {
+        return Eigen::Map<const Vector>(w->vector().data(), w->vector().size());
+    }
+    if (const auto * w = dynamic_cast<const EigenVector<Eigen::Map<Vector>> *>(v)) {
+        return Eigen::Map<const Vector>(w->vector().data(), w->vector().size());
+    }
+    return std::nullopt;
+}
+
 } // namespace SofaCaribou::Algebra
@@ -0,0 +1,80 @@
+#include <SofaCaribou/Algebra/MechanicalVectorMap.h>
+
+DISABLE_ALL_WARNINGS_BEGIN
+#include <sofa/core/behavior/MechanicalState.h>
+#include <sofa/core/behavior/MultiMatrixAccessor.h>
+#include <sofa/core/objectmodel/BaseContext.h>
+#include <sofa/defaulttype/VecTypes.h>
+DISABLE_ALL_WARNINGS_END
+
+#include <type_traits>
+
+namespace SofaCaribou::Algebra {
+
+using Vector = Eigen::Matrix<FLOATING_POINT_TYPE, Eigen::Dynamic, 1>;
+
+namespace { // Anonymous
+template <typename DataTypes>
+bool map_vector(sofa::core::behavior::BaseMechanicalState * state, sofa::core::VecDerivId id, FLOATING_POINT_TYPE * & data, Eigen::Index & size) {
+    using Deriv = typename DataTypes::Deriv;
+    using Real = typename DataTypes::Real;
+    static constexpr auto N = DataTypes::deriv_total_size;
+
+    auto * mechanical_state = dynamic_cast<sofa::core::behavior::MechanicalState<DataTypes> *>(state);
+    if (not mechanical_state) {
+        return false;
+    }
+
+    if constexpr (std::is_same_v<Real, FLOATING_POINT_TYPE> and sizeof(Deriv) == N*sizeof(Real)) {
+        auto * vector_data = mechanical_state->write(id);
+        if (not vector_data) {
+            return false;
+        }
+        auto & vector = *vector_data->beginEdit();
+        data = vector.empty() ? nullptr : &(vector[0][0]);
+        size = static_cast<Eigen::Index>(vector.size() * N);
+        vector_data->endEdit();
+        return data != nullptr;
+    } else {
+        return false;
+    }
+}
+}
+
+auto map_mechanical_vector(sofa::core::objectmodel::BaseContext * context,
+                           const sofa::core::behavior::MultiMatrixAccessor & accessor,
+                           sofa::core::MultiVecDerivId id) -> Eigen::Map<Vector> {
+    using namespace sofa::defaulttype;
+    FLOATING_POINT_TYPE * data = nullptr;
+    Eigen::Index size = 0;
+
+    auto * state = (context) ? context->getMechanicalState() : nullptr;
+    if (not state or accessor.getGlobalOffset(state) != 0) {
+        return {nullptr, 0};
+    }
+
+    // The system must only contain the DOFs of this mechanical object
+    const auto n = static_cast<Eigen::Index>(accessor.getGlobalDimension());
+    if (static_cast<Eigen::Index>(state->getMatrixSize()) != n) {
+        return {nullptr, 0};
+    }
+
+    const auto vector_id = id.getId(state);
+    if (vector_id.isNull()) {
+        return {nullptr, 0};
+    }
+
+    const bool mapped =
+        map_vector<Vec1Types>(state, vector_id, data, size) or
+        map_vector<Vec2Types>(state, vector_id, data, size) or
+        map_vector<Vec3Types>(state, vector_id, data, size) or
+        map_vector<Vec6Types>(state, vector_id, data, size);
+
+    if (not mapped or size != n) {
+        return {nullptr, 0};
+    }
+
+    return {data, size};
+}
+
+} // namespace SofaCaribou::Algebra
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <SofaCaribou/config.h>
+
+DISABLE_ALL_WARNINGS_BEGIN
+#include <sofa/core/MultiVecId.h>
+DISABLE_ALL_WARNINGS_END
+
+#include <Eigen/Core>
+
+namespace sofa::core::objectmodel {
+class BaseContext;
+}
+
+namespace sofa::core::behavior {
+class MultiMatrixAccessor;
+}
+
+namespace SofaCaribou::Algebra {
+
+/**
+ * Get a map over the memory of the vector id of the mechanical object of the given context, such that a global system
+ * vector can directly share the memory of this mechanical object instead of being copied from (or into) it.
+ *
+ * This is only possible when the global system has a single top-level mechanical object (the one of the context), and
+ * when its derivatives are stored as contiguous scalars of type FLOATING_POINT_TYPE (the vector template types Vec1,
+ * Vec2, Vec3 and Vec6). The mapped mechanical objects don't need to be taken into account since their contribution is
+ * accumulated into the vectors of their top-level mechanical object.
+ *
+ * @param context The context in which the mechanical object is found.
+ * @param accessor The multi-matrix accessor of the global system, once its matrices have been set up.
+ * @param id The vector id.
+ * @return The map, or a map of size zero over a null pointer when the memory can't be shared.
+ *
+ * @note The map is only valid as long as the vector of the mechanical object isn't reallocated (when its size changes).
+ */
+CARIBOU_API auto map_mechanical_vector(sofa::core::objectmodel::BaseContext * context,
+                                       const sofa::core::behavior::MultiMatrixAccessor & accessor,
+                                       sofa::core::MultiVecDerivId id) -> Eigen::Map<Eigen::Matrix<FLOATING_POINT_TYPE, Eigen::Dynamic, 1>>;
+
+} // namespace SofaCaribou::Algebra
@@ -0,0 +1,201 @@
+#pragma once
+
+#include <SofaCaribou/config.h>
+#include <Caribou/macros.h>
+
+DISABLE_ALL_WARNINGS_BEGIN
+#include <sofa/defaulttype/BaseMatrix.h>
+#include <sofa/defaulttype/BaseVector.h>
+DISABLE_ALL_WARNINGS_END
+
+#include <utility>
+#include <vector>
+
+namespace SofaCaribou::Algebra {
+
+/**
+ * Index map between the degrees of freedom (DOFs) of the global system and the ones of a reduced system where the
+ * constrained DOFs have been eliminated.
+ *
+ * The free DOFs keep their relative order, such that the reduced system is the sub-matrix of the global system formed
+ * by the rows and columns of the free DOFs.
+ */
+class ReducedIndexMap {
+public:
+    using Index = sofa::defaulttype::BaseMatrix::Index;
+
+    /**
+     * Build the map from the list of constrained flags of every DOFs of the global system.
+     * @param is_constrained is_constrained[i] is true if the global DOF i is constrained.
+     * @return True if the map changed.
+     */
+    bool set_constrained_dofs(const std::vector<bool> & is_constrained) {
+        const auto n = static_cast<Index>(is_constrained.size());
+        const auto previous_reduced_index = std::move(p_reduced_index);
+        p_reduced_index.resize(n);
+        p_global_index.clear();
+        p_global_index.reserve(n);
+        for (Index i = 0; i < n; ++i) {
+            if (is_constrained[i]) {
+                p_reduced_index[i] = -1;
+            } else {
+                p_reduced_index[i] = static_cast<Index>(p_global_index.size());
+                p_global_index.emplace_back(i);
+            }
+        }
+
+        return p_reduced_index != previous_reduced_index;
+    }
+
+    /** Number of DOFs of the global system. */
+    inline auto global_size() const -> Index { return static_cast<Index>(p_reduced_index.size()); }
+
+    /** Number of DOFs of the reduced system (the free DOFs). */
+    inline auto reduced_size() const -> Index { return static_cast<Index>(p_global_index.size()); }
+
+    /** Index in the reduced system of the global DOF i, or -1 if it is constrained. */
+    inline auto reduced_index(Index i) const -> Index { return p_reduced_index[i]; }
+
+    /** Index in the global system of the reduced DOF i. */
+    inline auto global_index(Index i) const -> Index { return p_global_index[i]; }
+
+    /** Copy the entries of the free DOFs of the global vector into the reduced vector. */
+    void gather(const sofa::defaulttype::BaseVector * global, sofa::defaulttype::BaseVector * reduced) const {
+        caribou_assert(global->size() == global_size() and reduced->size() == reduced_size());
+        for (Index i = 0; i < reduced_size(); ++i) {
+            reduced->set(i, global->element(p_global_index[i]));
+        }
+    }
+
+    /** Copy the entries of the reduced vector into the global vector. Constrained DOFs are set to zero. */
+    void scatter(const sofa::defaulttype::BaseVector * reduced, sofa::defaulttype::BaseVector * global) const {
+        caribou_assert(global->size() == global_size() and reduced->size() == reduced_size());
+        global->clear();
+        for (Index i = 0; i < reduced_size(); ++i) {
+            global->set(p_global_index[i], reduced->element(i));
+        }
+    }
+
+private:
+    ///< Index in the reduced system of every global DOFs (-1 for constrained DOFs)
+    std::vector<Index> p_reduced_index;
+
+    ///< Index in the global system of every reduced DOFs
+    std::vector<Index> p_global_index;
+};
+
+/**
+ * Global system matrix view that assembles directly into a reduced matrix.
+ *
+ * This matrix has the size of the global system, and can hence be given to the SOFA components and visitors that
+ * assemble the global system matrix (force fields, mappings, projective constraints, etc.). Every coefficient (i, j)
+ * added to it is added at the position (reduced_index(i), reduced_index(j)) of the reduced matrix, and dropped if i or
+ * j is a constrained DOF. Clearing the rows and columns of constrained DOFs (as done by the projective constraints) is
+ * therefore a no-op, and the structural non-zeros of these rows and columns never reach the reduced matrix.
+ *
+ * Example:
+ * \code{.cpp}
+ *    ReducedIndexMap map;
+ *    map.set_constrained_dofs(is_constrained);
+ *
+ *    EigenMatrix<Eigen::SparseMatrix<double>> A_reduced (map.reduced_size(), map.reduced_size());
+ *    ReducedMatrix A (&A_reduced, &map);
+ *    A.add(i, j, v); // Adds v to A_reduced(map.reduced_index(i), map.reduced_index(j)), if both are free DOFs
+ * \endcode
+ */
+class ReducedMatrix : public sofa::defaulttype::BaseMatrix {
+public:
+    using Base = sofa::defaulttype::BaseMatrix;
+    using Index = Base::Index;
+    using Real = SReal;
+
+    /**
+     * @param reduced_matrix The reduced matrix in which the coefficients are assembled. Its size must be the reduced
+     *                       size of the index map.
+     * @param map The index map between the global and reduced systems.
+     */
+    ReducedMatrix(Base * reduced_matrix, const ReducedIndexMap * map)
+    : p_reduced_matrix(reduced_matrix), p_map(map) {}
+
+    /** Get the reduced matrix. */
+    inline auto reduced_matrix() const -> Base * { return p_reduced_matrix; }
+
+    // Abstract methods overrides
+    inline Index rowSize() const final { return p_map->global_size(); }
+    inline Index colSize() const final { return p_map->global_size(); }
+
+    /** Return the entry (i,j) of the global system, which is zero when i or j is a constrained DOF. */
+    inline Real element(Index i, Index j) const final {
+        const auto ri = p_map->reduced_index(i);
+        const auto rj = p_map->reduced_index(j);
+        return (ri < 0 or rj < 0) ? Real(0) : p_reduced_matrix->element(ri, rj);
+    }
+
+    /** The size of the global system is given by the index map. This only clears the reduced matrix. */
+    inline void resize(Index nbRow, Index nbCol) final {
+        caribou_assert(nbRow == rowSize() and nbCol == colSize());
+        p_reduced_matrix->clear();
+    }
+
+    inline void clear() final { p_reduced_matrix->clear(); }
+
+    inline void set(Index i, Index j, double v) final {
+        const auto ri = p_map->reduced_index(i);
+        const auto rj = p_map->reduced_index(j);
+        if (ri >= 0 and rj >= 0) {
+            p_reduced_matrix->set(ri, rj, v);
+        }
+    }
+
+    inline void add(Index i, Index j, double v) final {
+        const auto ri = p_map->reduced_index(i);
+        const auto rj = p_map->reduced_index(j);
+        if (ri >= 0 and rj >= 0) {
+            p_reduced_matrix->add(ri, rj, v);
+        }
+    }
+
+    inline void clearRow(Index i) final {
+        const auto ri = p_map->reduced_index(i);
+        if (ri >= 0) {
+            p_reduced_matrix->clearRow(ri);
+        }
+    }
+
+    inline void clearRows(Index imin, Index imax) final {
+        for (Index i = imin; i <= imax; ++i) {
+            clearRow(i);
+        }
+    }
+
+    inline void clearCol(Index j) final {
+        const auto rj = p_map->reduced_index(j);
+        if (rj >= 0) {
+            p_reduced_matrix->clearCol(rj);
+        }
+    }
+
+    inline void clearCols(Index imin, Index imax) final {
+        for (Index j = imin; j <= imax; ++j) {
+            clearCol(j);
+        }
+    }
+
+    inline void clearRowCol(Index i) final {
+        const auto ri = p_map->reduced_index(i);
+        if (ri >= 0) {
+            p_reduced_matrix->clearRowCol(ri);
+        }
+    }
+
+    inline void compress() final { p_reduced_matrix->compress(); }
+
+private:
+    ///< The reduced matrix in which the coefficients are assembled.
+    Base * p_reduced_matrix;
+
+    ///< The index map between the global and reduced systems.
+    const ReducedIndexMap * p_map;
+};
+
+} // namespace SofaCaribou::Algebra
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <SofaCaribou/config.h>
+
+#include <Eigen/Core>
+#include <Eigen/Sparse>
+
+#include <cstdint>
+
+namespace SofaCaribou::Algebra {
+
+/**
+ * Compute a fingerprint (a 64-bit FNV-1a hash) of the sparsity pattern of a sparse matrix.
+ *
+ * Only the structure of the matrix is hashed (its dimensions, and the outer and inner index arrays), not its values.
+ * Two matrices having the same fingerprint can hence be assumed to share the same symbolic analysis (ordering and
+ * symbolic factorization). Explicitly stored zeros are part of the pattern. The matrix doesn't have to be compressed.
+ *
+ * The cost is a single pass over the inner indices, which is negligible when compared to a symbolic analysis.
+ */
+template <typename Scalar, int Options, typename StorageIndex>
+auto pattern_fingerprint(const Eigen::SparseMatrix<Scalar, Options, StorageIndex> & A) -> std::uint64_t {
+    std::uint64_t hash = 14695981039346656037ULL;
+    const auto combine = [&hash] (std::uint64_t value) {
+        hash ^= value;
+        hash *= 1099511628211ULL;
+    };
+
+    combine(static_cast<std::uint64_t>(A.rows()));
+    combine(static_cast<std::uint64_t>(A.cols()));
+
+    const StorageIndex * outer = A.outerIndexPtr();
+    const StorageIndex * inner = A.innerIndexPtr();
+    const StorageIndex * inner_non_zeros = A.innerNonZeroPtr(); // Null when the matrix is compressed
+    for (Eigen::Index j = 0; j < A.outerSize(); ++j) {
+        const auto begin = outer[j];
+        const auto end = inner_non_zeros ? begin + inner_non_zeros[j] : outer[j+1];
+        combine(static_cast<std::uint64_t>(end - begin));
+        for (auto k = begin; k < end; ++k) {
+            combine(static_cast<std::uint64_t>(inner[k]));
+        }
+    }
+
+    return hash;
+}
+
+/**
+ * Compute a fingerprint of the pattern of a dense matrix, which only depends on its dimensions.
+ */
+template <typename Derived>
+auto pattern_fingerprint(const Eigen::MatrixBase<Derived> & A) -> std::uint64_t {
+    return (static_cast<std::uint64_t>(A.rows()) << 32u) ^ static_cast<std::uint64_t>(A.cols());
+}
+
+} // namespace SofaCaribou::Algebra
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <SofaCaribou/config.h>
+
+#include <Eigen/Core>
+
+DISABLE_ALL_WARNINGS_BEGIN
+#include <sofa/core/MechanicalParams.h>
+#include <sofa/core/behavior/BaseMechanicalState.h>
+DISABLE_ALL_WARNINGS_END
+
+namespace SofaCaribou::forcefield {
+
+/**
+ * Interface of a force field that can compute the product of its tangent stiffness matrix with a vector directly
+ * from contiguous buffers, without going through the vectors of its mechanical state.
+ *
+ * This is used by matrix-free solvers (for example, the ConjugateGradientSolver without preconditioner) to avoid
+ * the scene graph traversal of the mechanical visitors at every iterations. The buffers are the flattened
+ * derivative vectors of the mechanical state, i.e. the component d of the node n is at the index n*D + d where D is
+ * the number of degrees of freedom per node.
+ */
+class DirectProductForcefield {
+public:
+    using Vector = Eigen::Matrix<FLOATING_POINT_TYPE, Eigen::Dynamic, 1>;
+
+    virtual ~DirectProductForcefield() = default;
+
+    /**
+     * Get the mechanical state on which the direct product is applied. The size of the buffers given to add_dforce
+     * will be the matrix size of this mechanical state.
+     */
+    [[nodiscard]]
+    virtual auto direct_product_state() const -> const sofa::core::behavior::BaseMechanicalState * = 0;
+
+    /**
+     * Accumulate the force differential df += kFactor * (dF/dx) * dx in a contiguous buffer. This must do the same
+     * thing as ForceField::addDForce, the k factor (including the Rayleigh damping) being taken from the mechanical
+     * parameters.
+     *
+     * @param mparams Mechanical parameters containing the k factor.
+     * @param dx The flattened displacement vector.
+     * @param df The flattened force differential vector in which the result is accumulated.
+     */
+    virtual void add_dforce(const sofa::core::MechanicalParams * mparams, const Vector & dx, Vector & df) = 0;
+};
+
+} // namespace SofaCaribou::forcefield
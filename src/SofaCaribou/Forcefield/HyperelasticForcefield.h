@@ -5,6 +5,7 @@
 
 #include <SofaCaribou/config.h>
 #include <SofaCaribou/Material/HyperelasticMaterial.h>
+#include <SofaCaribou/Forcefield/DirectProductForcefield.h>
 
 DISABLE_ALL_WARNINGS_BEGIN
 #include <sofa/version.h>
@@ -52,7 +53,7 @@ struct GaussContainer<GaussNode, caribou::Dynamic> {
 };
 
 template <typename Element>
-class HyperelasticForcefield : public ForceField<typename SofaVecType<caribou::geometry::traits<Element>::Dimension>::Type> {
+class HyperelasticForcefield : public ForceField<typename SofaVecType<caribou::geometry::traits<Element>::Dimension>::Type>, public DirectProductForcefield {
 public:
     SOFA_CLASS(SOFA_TEMPLATE(HyperelasticForcefield, Element), SOFA_TEMPLATE(ForceField, typename SofaVecType<caribou::geometry::traits<Element>::Dimension>::Type));
 
@@ -137,6 +138,17 @@ public:
         Data<VecDeriv>& /*d_df*/,
         const Data<VecDeriv>& /*d_dx*/) override;
 
+    [[nodiscard]] auto
+    direct_product_state() const -> const sofa::core::behavior::BaseMechanicalState * override {
+        return this->mstate.get();
+    }
+
+    CARIBOU_API
+    void add_dforce(
+        const MechanicalParams* mparams,
+        const DirectProductForcefield::Vector & dx,
+        DirectProductForcefield::Vector & df) override;
+
     CARIBOU_API
     SReal getPotentialEnergy(
         const MechanicalParams* /* mparams */,
@@ -239,6 +251,13 @@ private:
     /** Get the set of Gauss integration nodes of the given element */
     virtual auto get_gauss_nodes(const std::size_t & element_id, const Element & element) const -> GaussContainer;
 
+    /**
+     * Accumulate the product df += -kFactor * K * dx of the stiffness matrix (of which only the upper triangular part
+     * is stored) with the flattened vector dx. This is the kernel of both addDForce and add_dforce.
+     */
+    template <typename DisplacementVector, typename ForceVector>
+    void add_stiffness_product(typename ForceVector::Scalar kFactor, const DisplacementVector & dx, ForceVector & df) const;
+
     // Data members
     Link<sofa::core::topology::BaseMeshTopology> d_topology_container;
     Link<material::HyperelasticMaterial<DataTypes>> d_material;
@@ -222,21 +222,48 @@ void HyperelasticForcefield<Element>::addDForce(
 
     sofa::helper::AdvancedTimer::stepBegin("HyperelasticForcefield::addDForce");
 
+    add_stiffness_product(kFactor, DX, DF);
+
+    sofa::helper::AdvancedTimer::stepEnd("HyperelasticForcefield::addDForce");
+}
+
+template <typename Element>
+void HyperelasticForcefield<Element>::add_dforce(
+    const MechanicalParams* mparams,
+    const DirectProductForcefield::Vector & dx,
+    DirectProductForcefield::Vector & df)
+{
+    if (not K_is_up_to_date) {
+        update_stiffness();
+    }
+
+    const auto kFactor = static_cast<FLOATING_POINT_TYPE> (mparams->kFactorIncludingRayleighDamping(this->rayleighStiffness.getValue()));
+
+    sofa::helper::AdvancedTimer::stepBegin("HyperelasticForcefield::add_dforce");
+
+    add_stiffness_product(kFactor, dx, df);
+
+    sofa::helper::AdvancedTimer::stepEnd("HyperelasticForcefield::add_dforce");
+}
+
+template <typename Element>
+template <typename DisplacementVector, typename ForceVector>
+void HyperelasticForcefield<Element>::add_stiffness_product(typename ForceVector::Scalar kFactor, const DisplacementVector & dx, ForceVector & df) const
+{
+    using Scalar = typename ForceVector::Scalar;
     for (int k = 0; k < p_K.outerSize(); ++k) {
         for (typename Eigen::SparseMatrix<Real>::InnerIterator it(p_K, k); it; ++it) {
             const auto i = it.row();
             const auto j = it.col();
-            const auto v = -1 * it.value() * kFactor;
+            const auto v = -1 * static_cast<Scalar>(it.value()) * kFactor;
             if (i != j) {
-                DF[i] += v*DX[j];
-                DF[j] += v*DX[i];
+                df[i] += v*dx[j];
+                df[j] += v*dx[i];
             } else {
-                DF[i] += v*DX[i];
+                df[i] += v*dx[i];
             }
         }
     }
-
-    sofa::helper::AdvancedTimer::stepEnd("HyperelasticForcefield::addDForce");
 }
 
 template <typename Element>
@@ -45,17 +45,41 @@ void BackwardEulerODESolver::solve(const sofa::core::ExecParams *params, SReal d
     sofa::core::MechanicalParams mechanical_parameters (*params);
     sofa::simulation::common::VectorOperations vop( &mechanical_parameters, this->getContext() );
     vop.v_realloc(p_previous_x_id, false /* interactionForceField */, true /* propagate [to mapped MO] */);
-    vop.v_eq(p_previous_x_id, x_id); // x_0 = x
-
     vop.v_realloc(p_previous_v_id, false /* interactionForceField */, true /* propagate [to mapped MO] */);
-    vop.v_eq(p_previous_v_id, v_id); // v_0 = v
 
     // Allocate the acceleration vector
     vop.v_realloc(p_a_id, false /* interactionForceField */, true /* propagate [to mapped MO] */);
-    vop.v_clear(p_a_id);
 
-    // Let the NR do its job
-    NewtonRaphsonSolver::solve(params, dt, x_id, v_id);
+    // Start a time step from the current position and velocity
+    const auto begin_time_step = [&]() {
+        vop.v_eq(p_previous_x_id, x_id); // x_0 = x
+        vop.v_eq(p_previous_v_id, v_id); // v_0 = v
+        vop.v_clear(p_a_id);
+    };
+
+    if (not adaptive_stepping() or not has_valid_linear_solver()) {
+        begin_time_step();
+
+        // Let the NR do its job
+        newton_solve(params, dt, x_id, v_id);
+        return;
+    }
+
+    // Adaptive time stepping: the time step is split in sub-steps of duration (end - begin)*dt. When the Newton
+    // iterations of a sub-step don't converge, the position and velocity of its beginning are restored.
+    // Note that the context time isn't advanced between the sub-steps: it is only advanced by the animation loop once
+    // the whole time step is solved, hence time-dependent components see the time of the beginning of the step.
+    solve_adaptively(
+        [&](FLOATING_POINT_TYPE begin, FLOATING_POINT_TYPE end) {
+            begin_time_step();
+            newton_solve(params, (end - begin)*dt, x_id, v_id);
+        },
+        [&]() {
+            vop.v_eq(x_id, p_previous_x_id); // x = x_0
+            vop.v_eq(v_id, p_previous_v_id); // v = v_0
+            MechanicalPropagateOnlyPositionAndVelocityVisitor(&mechanical_parameters).execute(this->getContext());
+        }
+    );
 }
 
 
@@ -138,8 +162,11 @@ void BackwardEulerODESolver::assemble_rhs_vector(const MechanicalParams &    mec
     .execute(this->getContext());
 
     // 5. Copy force vectors from every top level (unmapped) mechanical objects into the given system vector f
-    MechanicalMultiVectorToBaseVectorVisitor(&mechanical_parameters, f_id /* source */, f /* destination */, &matrix_accessor)
-    .execute(this->getContext());
+    //    (unless f already shares the memory of the mechanical object)
+    if (not system_vectors_are_shared()) {
+        MechanicalMultiVectorToBaseVectorVisitor(&mechanical_parameters, f_id /* source */, f /* destination */, &matrix_accessor)
+        .execute(this->getContext());
+    }
 }
 
 // Assemble A in A [da] = F
@@ -166,7 +193,7 @@ void BackwardEulerODESolver::assemble_system_matrix(const MechanicalParams & mec
     Timer::stepEnd("AssembleGlobalMatrix");
 
     Timer::stepBegin("ConstrainGlobalMatrix");
-    visitor::ConstrainGlobalMatrix(&m_params, &matrix_accessor).execute(this->getContext());
+    visitor::ConstrainGlobalMatrix(&m_params, &matrix_accessor, A).execute(this->getContext());
     Timer::stepEnd("ConstrainGlobalMatrix");
 
     // Step 2. Mechanical mappings
@@ -198,8 +225,11 @@ void BackwardEulerODESolver::propagate_solution_increment(const MechanicalParams
     auto constraint_solvers = this->getContext()->getObjects<sofa::core::behavior::ConstraintSolver>(Direction::Local);
 
 
-    // 2. Copy vectors from the global system vector into every top level (unmapped) mechanical objects.
-    MechanicalMultiVectorFromBaseVectorVisitor(&mechanical_parameters, dx_id, dx, &matrix_accessor).execute(this->getContext());
+    // 2. Copy vectors from the global system vector into every top level (unmapped) mechanical objects
+    //    (unless dx already shares the memory of the mechanical object).
+    if (not system_vectors_are_shared()) {
+        MechanicalMultiVectorFromBaseVectorVisitor(&mechanical_parameters, dx_id, dx, &matrix_accessor).execute(this->getContext());
+    }
 
     // 3. a_{i+1}^n = a_{i}^n + da
     MechanicalVOpVisitor(&mechanical_parameters, p_a_id, p_a_id, dx_id).execute(this->getContext());
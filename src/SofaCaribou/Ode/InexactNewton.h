@@ -0,0 +1,43 @@
+#pragma once
+
+#include <SofaCaribou/config.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace SofaCaribou::ode {
+
+/**
+ * Forcing term of an inexact Newton iteration (Eisenstat & Walker, 1996, choice 2 with gamma = 0.9 and alpha = 2):
+ *
+ *     eta_k = gamma (|R_k| / |R_k-1|)^alpha
+ *
+ * It is safeguarded against a too fast decrease (eta_k >= gamma eta_k-1^alpha when the latter is larger than 0.1), and
+ * against over-solving the last iterations: the linear residual never has to be lower than half the Newton residual
+ * at which the iterations will stop.
+ *
+ * @param R_squared_norm The squared norm of the current Newton residual |R_k|^2
+ * @param R_previous_squared_norm The squared norm of the previous Newton residual |R_k-1|^2
+ * @param previous_forcing_term The forcing term of the previous Newton iteration
+ * @param maximum_forcing_term The upper bound of the forcing term
+ * @param squared_target_residual The squared norm of the Newton residual at which the iterations stop (zero if none)
+ */
+inline auto eisenstat_walker_forcing_term(FLOATING_POINT_TYPE R_squared_norm, FLOATING_POINT_TYPE R_previous_squared_norm,
+                                          FLOATING_POINT_TYPE previous_forcing_term, FLOATING_POINT_TYPE maximum_forcing_term,
+                                          FLOATING_POINT_TYPE squared_target_residual) -> FLOATING_POINT_TYPE {
+    constexpr FLOATING_POINT_TYPE gamma = 0.9;
+    FLOATING_POINT_TYPE forcing_term = gamma * R_squared_norm / R_previous_squared_norm;
+
+    const FLOATING_POINT_TYPE safeguard = gamma * previous_forcing_term * previous_forcing_term;
+    if (safeguard > 0.1) {
+        forcing_term = std::max(forcing_term, safeguard);
+    }
+
+    if (squared_target_residual > 0) {
+        forcing_term = std::max(forcing_term, 0.5 * std::sqrt(squared_target_residual / R_squared_norm));
+    }
+
+    return std::min(forcing_term, maximum_forcing_term);
+}
+
+} // namespace SofaCaribou::ode
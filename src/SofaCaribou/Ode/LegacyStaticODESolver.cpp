@@ -3,6 +3,7 @@
 #include <iomanip>
 #include <chrono>
 
+#include <SofaCaribou/Ode/InexactNewton.h>
 #include <SofaCaribou/Solver/ConjugateGradientSolver.h>
 
 DISABLE_ALL_WARNINGS_BEGIN
@@ -43,8 +44,27 @@ LegacyStaticODESolver::LegacyStaticODESolver()
         "warm_start",
         "For iterative linear solvers, use the previous solution has a warm start. "
         "Note that for the first newton step, the current position is used as the warm start."))
+    , d_linear_solver_tolerance_strategy(initData(&d_linear_solver_tolerance_strategy,
+        "linear_solver_tolerance_strategy",
+        R"(
+        Define the tolerance of the ConjugateGradientSolver at each Newton iteration.
+            FIXED:            The CG always uses its own residual tolerance threshold. (default)
+            EISENSTAT_WALKER: Inexact Newton. The relative residual tolerance of the CG (forcing term) is computed from
+                              the ratio of the last two Newton residuals, such that the first Newton iterations are
+                              roughly solved. The CG never iterates more than with its own threshold. Only used when
+                              newton_iterations is greater than 1.
+        )"))
+    , d_maximum_forcing_term(initData(&d_maximum_forcing_term,
+        (double) 0.5,
+        "maximum_forcing_term",
+        "Upper bound of the relative residual tolerance of the CG with the EISENSTAT_WALKER strategy. It is also used "
+        "as the tolerance of the first Newton iteration."))
     , d_converged(initData(&d_converged, false, "converged", "Whether or not the last call to solve converged", true /*is_displayed_in_gui*/, true /*is_read_only*/))
-{}
+{
+    d_linear_solver_tolerance_strategy.setValue(sofa::helper::OptionsGroup(std::vector < std::string > {
+        "FIXED", "EISENSTAT_WALKER"
+    }));
+}
 
 void LegacyStaticODESolver::solve(const sofa::core::ExecParams* params, double /*dt*/, sofa::core::MultiVecCoordId xResult, sofa::core::MultiVecDerivId /*vResult*/) {
     using namespace sofa::helper::logging;
@@ -66,6 +86,7 @@ void LegacyStaticODESolver::solve(const sofa::core::ExecParams* params, double /
     const auto & residual_tolerance_threshold = d_residual_tolerance_threshold.getValue();
     const auto & newton_iterations = d_newton_iterations.getValue();
     const auto & warm_start = d_warm_start.getValue();
+    const auto & maximum_forcing_term = d_maximum_forcing_term.getValue();
     const auto & print_log = f_printLog.getValue();
     auto info = MessageDispatcher::info(Message::Runtime, ComponentInfo::SPtr(new ComponentInfo(this->getClassName())), SOFA_FILE_INFO);
 
@@ -74,6 +95,12 @@ void LegacyStaticODESolver::solve(const sofa::core::ExecParams* params, double /
     auto linear_solver = context->get<LinearSolver>(context->getTags(), sofa::core::objectmodel::BaseContext::SearchDown);
     auto cg_linear_solver = dynamic_cast<SofaCaribou::solver::ConjugateGradientSolver *>(linear_solver);
 
+    // Inexact Newton (only with the caribou's CG)
+    const bool inexact_newton = (
+        cg_linear_solver and newton_iterations > 1 and
+        d_linear_solver_tolerance_strategy.getValue().getSelectedItem() == "EISENSTAT_WALKER"
+    );
+
     // Incremental displacement of one iteration
     dx.realloc( &vop );
 
@@ -95,11 +122,13 @@ void LegacyStaticODESolver::solve(const sofa::core::ExecParams* params, double /
         info << "Context               : " << dynamic_cast<sofa::simulation::Node *>(this->getContext())->getPathName() << "\n";
         info << "Max iterations        : " << newton_iterations << "\n";
         info << "Residual tolerance    : " << residual_tolerance_threshold << "\n";
-        info << "Correction tolerance  : " << correction_tolerance_threshold << "\n\n";
+        info << "Correction tolerance  : " << correction_tolerance_threshold << "\n";
+        info << "Inexact Newton        : " << (inexact_newton ? "Eisenstat-Walker" : "no") << "\n\n";
     }
 
     unsigned n_it=0;
     double dx_squared_norm, du_squared_norm, R_squared_norm = 0, Rn_squared_norm = 0;
+    FLOATING_POINT_TYPE forcing_term = maximum_forcing_term;
     const auto squared_residual_threshold = residual_tolerance_threshold*residual_tolerance_threshold;
     const auto squared_correction_threshold = correction_tolerance_threshold*correction_tolerance_threshold;
     bool converged = false, diverged = false;
@@ -121,6 +150,12 @@ void LegacyStaticODESolver::solve(const sofa::core::ExecParams* params, double /
         p_iterative_linear_solver_squared_rhs_norms.reserve(newton_iterations);
     }
 
+    // Resize vectors containing the forcing terms of the CG
+    p_forcing_terms.clear();
+    if (inexact_newton) {
+        p_forcing_terms.reserve(newton_iterations);
+    }
+
 
     sofa::helper::AdvancedTimer::stepBegin("StaticODESolver::Solve");
 
@@ -148,6 +183,7 @@ void LegacyStaticODESolver::solve(const sofa::core::ExecParams* params, double /
 
     // Compute the initial residual
     R_squared_norm = force.dot(force);
+    Rn_squared_norm = R_squared_norm;
     p_squared_initial_residual = R_squared_norm;
 
     if (residual_tolerance_threshold > 0 && R_squared_norm <= residual_tolerance_threshold) {
@@ -187,6 +223,10 @@ void LegacyStaticODESolver::solve(const sofa::core::ExecParams* params, double /
         sofa::helper::AdvancedTimer::stepBegin("MBKSolve");
 
         // Calls methods "setSystemRHVector", "setSystemLHVector" and "solveSystem" of the LinearSolver component
+        if (inexact_newton) {
+            cg_linear_solver->set_forcing_term(forcing_term);
+            p_forcing_terms.emplace_back(forcing_term);
+        }
         matrix.solve(dx, force);
         sofa::helper::AdvancedTimer::stepEnd("MBKSolve");
 
@@ -249,6 +289,9 @@ void LegacyStaticODESolver::solve(const sofa::core::ExecParams* params, double /
             if (cg_linear_solver) {
                 info << "  CG iterations = " << std::setw(5) << cg_linear_solver->squared_residuals().size();
             }
+            if (inexact_newton) {
+                info << "  Forcing term = " << std::scientific << std::setw(12) << forcing_term << std::defaultfloat;
+            }
             info << "  Time = " << iteration_time/1000/1000 << " ms";
             info << "\n";
         }
@@ -296,6 +339,13 @@ void LegacyStaticODESolver::solve(const sofa::core::ExecParams* params, double /
             break;
         }
 
+        // Compute the forcing term of the next CG solve
+        if (inexact_newton) {
+            const FLOATING_POINT_TYPE squared_target_residual = (residual_tolerance_threshold > 0) ? squared_residual_threshold*p_squared_residuals[0] : 0;
+            forcing_term = eisenstat_walker_forcing_term(R_squared_norm, Rn_squared_norm, forcing_term,
+                                                         maximum_forcing_term, squared_target_residual);
+        }
+
         // Save the last residual to check the growing residual criterion at the next step
         Rn_squared_norm = R_squared_norm;
 
@@ -305,6 +355,11 @@ void LegacyStaticODESolver::solve(const sofa::core::ExecParams* params, double /
 
     } // End while (not converged and not diverged and n_it < newton_iterations)
 
+    // Give back its own convergence criterion to the CG
+    if (inexact_newton) {
+        cg_linear_solver->set_forcing_term(0);
+    }
+
     n_it--; // Reset to the actual index of the last iteration completed
 
     if (not converged and not diverged and n_it == (newton_iterations-1)) {
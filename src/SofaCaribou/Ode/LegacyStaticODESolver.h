@@ -6,6 +6,7 @@ DISABLE_ALL_WARNINGS_BEGIN
 #include <sofa/core/behavior/OdeSolver.h>
 #include <sofa/simulation/MechanicalMatrixVisitor.h>
 #include <sofa/core/behavior/MultiVec.h>
+#include <sofa/helper/OptionsGroup.h>
 DISABLE_ALL_WARNINGS_END
 
 namespace SofaCaribou::ode {
@@ -61,6 +62,14 @@ public:
         return p_iterative_linear_solver_squared_rhs_norms;
     }
 
+    /*!
+     * List of the forcing terms (relative residual tolerances) given to the CG at every newton iterations of the
+     * last solve call (only filled with the EISENSTAT_WALKER strategy).
+     */
+    auto forcing_terms() const -> const std::vector<FLOATING_POINT_TYPE> & {
+        return p_forcing_terms;
+    }
+
     /// Given a displacement as computed by the linear system inversion, how much will it affect the velocity
     ///
     /// This method is used to compute the compliance for contact corrections
@@ -142,6 +151,8 @@ protected:
     Data<double> d_residual_tolerance_threshold;
     Data<bool> d_shoud_diverge_when_residual_is_growing;
     Data<bool> d_warm_start;
+    Data<sofa::helper::OptionsGroup> d_linear_solver_tolerance_strategy;
+    Data<double> d_maximum_forcing_term;
 
     /// OUTPUTS
     ///< Whether or not the last call to solve converged
@@ -170,6 +181,9 @@ private:
     ///< List of squared right-hand side norms (||b||^2) of every newton iterations before the call
     ///< to the solve method of the iterative linear solver.
     std::vector<FLOATING_POINT_TYPE> p_iterative_linear_solver_squared_rhs_norms;
+
+    ///< List of the forcing terms given to the CG at every newton iterations of the last solve call.
+    std::vector<FLOATING_POINT_TYPE> p_forcing_terms;
 };
 
 
@@ -1,17 +1,26 @@
 #include <SofaCaribou/Ode/NewtonRaphsonSolver.h>
 
+#include <algorithm>
 #include <iomanip>
 #include <chrono>
+#include <functional>
+#include <random>
 
 DISABLE_ALL_WARNINGS_BEGIN
+#include <sofa/core/BaseMapping.h>
+#include <sofa/core/behavior/BaseMechanicalState.h>
 #include <sofa/helper/AdvancedTimer.h>
 #include <sofa/simulation/MechanicalOperations.h>
+#include <sofa/simulation/MechanicalVisitor.h>
 #include <sofa/simulation/Node.h>
 #include <sofa/simulation/VectorOperations.h>
 DISABLE_ALL_WARNINGS_BEGIN
 
+#include <SofaCaribou/Ode/InexactNewton.h>
 #include <SofaCaribou/Solver/LinearSolver.h>
 #include <SofaCaribou/Algebra/BaseVectorOperations.h>
+#include <SofaCaribou/Algebra/EigenVector.h>
+#include <SofaCaribou/Algebra/MechanicalVectorMap.h>
 
 namespace SofaCaribou::ode {
 
@@ -47,6 +56,105 @@ NewtonRaphsonSolver::NewtonRaphsonSolver()
     "be avoided altogether, or computed only one time at the beginning of the simulation. Else, it can be done at the "
     "beginning of the time step, or even at each reformation of the system matrix if necessary. The default is to "
     "analyze the pattern at each time step."))
+, d_linear_solver_tolerance_strategy(initData(&d_linear_solver_tolerance_strategy,
+    "linear_solver_tolerance_strategy",
+    R"(
+    Define the tolerance of iterative linear solvers (for example, the ConjugateGradientSolver) at each Newton iteration.
+        FIXED:            The linear solver always uses its own residual tolerance threshold. (default)
+        EISENSTAT_WALKER: Inexact Newton. The relative residual tolerance of the linear solver (forcing term) is
+                          computed from the ratio of the last two Newton residuals, such that the first Newton
+                          iterations are roughly solved. The linear solver never iterates more than with its own
+                          threshold. Only used when newton_iterations is greater than 1.
+    )"))
+, d_maximum_forcing_term(initData(&d_maximum_forcing_term,
+    (double) 0.5,
+    "maximum_forcing_term",
+    "Upper bound of the relative residual tolerance of the linear solver with the EISENSTAT_WALKER strategy. It is "
+    "also used as the tolerance of the first Newton iteration."))
+, d_low_rank_update_ratio(initData(&d_low_rank_update_ratio,
+    (double) 0,
+    "low_rank_update_ratio",
+    "When greater than zero, the factors of the system matrix are updated instead of being recomputed when the matrix "
+    "only differs from the previously factorized one by a symmetric modification of rank lower than this ratio times "
+    "the size of the system (for example, when a few elements were cut). Only used by linear solvers supporting "
+    "low-rank updates (LLTSolver and LDLTSolver with the Eigen backend)."))
+, d_eliminate_constrained_dofs(initData(&d_eliminate_constrained_dofs,
+    false,
+    "eliminate_constrained_dofs",
+    "Eliminate the degrees of freedom fixed by projective constraints (for example, a FixedConstraint) from the "
+    "system instead of zeroing their rows and columns. The linear solver then works on a smaller system that doesn't "
+    "contain the structural non-zeros of the constrained rows and columns."))
+, d_jacobian_update_strategy(initData(&d_jacobian_update_strategy,
+    "jacobian_update_strategy",
+    R"(
+    Define when the system matrix (the jacobian) is assembled and factorized.
+        FULL_NEWTON:     At every Newton iteration. (default)
+        MODIFIED_NEWTON: The current factorization is kept, across Newton iterations and time steps, as long as the
+                         ratio |R_k|/|R_k-1| of the last two Newton residuals is lower than the maximum contraction
+                         rate. The system matrix is assembled and factorized again at the next iteration otherwise.
+                         Only used when newton_iterations is greater than 1.
+        QUASI_NEWTON:    Same as MODIFIED_NEWTON, but the increments computed with the current factorization are
+                         corrected by L-BFGS secant updates built from the last increments and residuals.
+                         Only used when newton_iterations is greater than 1.
+    )"))
+, d_maximum_contraction_rate(initData(&d_maximum_contraction_rate,
+    (double) 0.5,
+    "maximum_contraction_rate",
+    "Maximum ratio |R_k|/|R_k-1| between the last two Newton residuals for which the current factorization is kept "
+    "with the MODIFIED_NEWTON strategy."))
+, d_quasi_newton_history_size(initData(&d_quasi_newton_history_size,
+    (unsigned) 10,
+    "quasi_newton_history_size",
+    "Maximum number of secant pairs (increment and residual change of a Newton iteration) used by the QUASI_NEWTON "
+    "strategy."))
+, d_line_search_strategy(initData(&d_line_search_strategy,
+    "line_search_strategy",
+    R"(
+    Define the length of the step taken along the solution increment of each Newton iteration.
+        NONE:         The full increment is always applied. (default)
+        BACKTRACKING: The length of the step is reduced by the step reduction factor until the residual norm
+                      decreased enough, i.e. |R(alpha)| <= (1 - c alpha) |R_k| with alpha the step length and c the
+                      sufficient decrease factor. Only used when newton_iterations is greater than 1.
+    )"))
+, d_line_search_iterations(initData(&d_line_search_iterations,
+    (unsigned) 10,
+    "line_search_iterations",
+    "Maximum number of step length reductions of the line search at each Newton iteration. The last step length is "
+    "kept when this number is reached."))
+, d_line_search_step_reduction(initData(&d_line_search_step_reduction,
+    (double) 0.5,
+    "line_search_step_reduction",
+    "Factor (between 0 and 1) by which the step length is multiplied at each iteration of the line search."))
+, d_line_search_sufficient_decrease(initData(&d_line_search_sufficient_decrease,
+    (double) 1e-4,
+    "line_search_sufficient_decrease",
+    "Factor c of the sufficient decrease condition |R(alpha)| <= (1 - c alpha) |R_k| of the line search."))
+, d_adaptive_stepping(initData(&d_adaptive_stepping,
+    false,
+    "adaptive_stepping",
+    "Split the time step in smaller increments when the Newton iterations don't converge, and enlarge them again when "
+    "they converge in few iterations. The increments are fractions of the load increment of the time step for the "
+    "StaticODESolver, and of the time step duration for the BackwardEulerODESolver. The positions and velocities are "
+    "restored before retrying a smaller increment. Only used when newton_iterations is greater than 1."))
+, d_minimum_step(initData(&d_minimum_step,
+    (double) 1e-3,
+    "minimum_step",
+    "Smallest increment (fraction of the time step) tried by the adaptive stepping before giving up."))
+, d_step_growth_factor(initData(&d_step_growth_factor,
+    (double) 2,
+    "step_growth_factor",
+    "Factor by which the increment of the adaptive stepping is enlarged after converging in at most "
+    "target_newton_iterations iterations."))
+, d_step_reduction_factor(initData(&d_step_reduction_factor,
+    (double) 0.5,
+    "step_reduction_factor",
+    "Factor (between 0 and 1) by which the increment of the adaptive stepping is reduced after a failure of the "
+    "Newton iterations."))
+, d_target_newton_iterations(initData(&d_target_newton_iterations,
+    (unsigned) 4,
+    "target_newton_iterations",
+    "The increment of the adaptive stepping is enlarged when the Newton iterations converged in at most this number "
+    "of iterations."))
 , l_linear_solver(initLink(
     "linear_solver",
     "Linear solver used for the resolution of the system."))
@@ -56,6 +164,11 @@ NewtonRaphsonSolver::NewtonRaphsonSolver()
     "Whether or not the last call to solve converged",
     true /*is_displayed_in_gui*/,
     true /*is_read_only*/))
+, d_accepted_steps(initData(&d_accepted_steps,
+    "accepted_steps",
+    "Increments (fractions of the time step) accepted by the adaptive stepping during the last call to solve.",
+    true /*is_displayed_in_gui*/,
+    true /*is_read_only*/))
 {
     d_pattern_analysis_strategy.setValue(sofa::helper::OptionsGroup(std::vector < std::string > {
         "NEVER", "BEGINNING_OF_THE_SIMULATION", "BEGINNING_OF_THE_TIME_STEP", "ALWAYS"
@@ -63,9 +176,30 @@ NewtonRaphsonSolver::NewtonRaphsonSolver()
 
     // Select the default value
     set_pattern_analysis_strategy(PatternAnalysisStrategy::BEGINNING_OF_THE_TIME_STEP);
+
+    d_linear_solver_tolerance_strategy.setValue(sofa::helper::OptionsGroup(std::vector < std::string > {
+        "FIXED", "EISENSTAT_WALKER"
+    }));
+
+    // Select the default value
+    set_linear_solver_tolerance_strategy(LinearSolverToleranceStrategy::FIXED);
+
+    d_jacobian_update_strategy.setValue(sofa::helper::OptionsGroup(std::vector < std::string > {
+        "FULL_NEWTON", "MODIFIED_NEWTON", "QUASI_NEWTON"
+    }));
+
+    // Select the default value
+    set_jacobian_update_strategy(JacobianUpdateStrategy::FULL_NEWTON);
+
+    d_line_search_strategy.setValue(sofa::helper::OptionsGroup(std::vector < std::string > {
+        "NONE", "BACKTRACKING"
+    }));
+
+    // Select the default value
+    set_line_search_strategy(LineSearchStrategy::NONE);
 }
 
-void NewtonRaphsonSolver::solve(const ExecParams *params, SReal dt, MultiVecCoordId x_id, MultiVecDerivId v_id) {
+void NewtonRaphsonSolver::newton_solve(const ExecParams *params, SReal dt, MultiVecCoordId x_id, MultiVecDerivId v_id) {
     using namespace sofa::helper::logging;
     using namespace std::chrono;
     using std::chrono::steady_clock;
@@ -115,6 +249,18 @@ void NewtonRaphsonSolver::solve(const ExecParams *params, SReal dt, MultiVecCoor
     const auto & residual_tolerance_threshold = d_residual_tolerance_threshold.getValue();
     const auto & absolute_residual_tolerance_threshold = d_absolute_residual_tolerance_threshold.getValue();
     const auto & newton_iterations = d_newton_iterations.getValue();
+    const auto & maximum_forcing_term = d_maximum_forcing_term.getValue();
+    const auto & low_rank_update_ratio = d_low_rank_update_ratio.getValue();
+    const auto & eliminate_constrained_dofs = d_eliminate_constrained_dofs.getValue();
+    const bool inexact_newton = (linear_solver_tolerance_strategy() == LinearSolverToleranceStrategy::EISENSTAT_WALKER and newton_iterations > 1);
+    const bool quasi_newton = (jacobian_update_strategy() == JacobianUpdateStrategy::QUASI_NEWTON and newton_iterations > 1);
+    const bool modified_newton = (jacobian_update_strategy() == JacobianUpdateStrategy::MODIFIED_NEWTON and newton_iterations > 1) or quasi_newton;
+    const auto & quasi_newton_history_size = d_quasi_newton_history_size.getValue();
+    const auto & maximum_contraction_rate = d_maximum_contraction_rate.getValue();
+    const bool line_search = (line_search_strategy() == LineSearchStrategy::BACKTRACKING and newton_iterations > 1);
+    const auto & line_search_iterations = d_line_search_iterations.getValue();
+    const auto & line_search_step_reduction = d_line_search_step_reduction.getValue();
+    const auto & line_search_sufficient_decrease = d_line_search_sufficient_decrease.getValue();
     const auto & print_log = f_printLog.getValue();
     auto info = MessageDispatcher::info(Message::Runtime, ComponentInfo::SPtr(new ComponentInfo(this->getClassName())), SOFA_FILE_INFO);
 
@@ -132,10 +278,6 @@ void NewtonRaphsonSolver::solve(const ExecParams *params, SReal dt, MultiVecCoor
     vop.v_realloc(dx_id, false /* interactionForceField */, false /* propagate [to mapped MO] */);
     vop.v_clear(dx_id);
 
-    // Total displacement increment since the beginning
-    vop.v_realloc(p_U_id, false /* interactionForceField */, false /* propagate [to mapped MO] */);
-    vop.v_clear(p_U_id);
-
     // Set implicit param to true to trigger nonlinear stiffness matrix recomputation
     mop->setImplicit(true);
 
@@ -147,12 +289,19 @@ void NewtonRaphsonSolver::solve(const ExecParams *params, SReal dt, MultiVecCoor
         info << "Residual tolerance (abs) : " << absolute_residual_tolerance_threshold << "\n";
         info << "Residual tolerance (rel) : " << residual_tolerance_threshold << "\n";
         info << "Correction tolerance     : " << correction_tolerance_threshold << "\n";
+        info << "Inexact Newton           : " << (inexact_newton ? "Eisenstat-Walker" : "no") << "\n";
+        info << "Modified Newton          : " << (modified_newton ? "yes" : "no") << "\n";
+        info << "Quasi-Newton (L-BFGS)    : " << (quasi_newton ? "yes" : "no") << "\n";
+        info << "Low-rank updates ratio   : " << low_rank_update_ratio << "\n";
+        info << "Line search              : " << (line_search ? "backtracking" : "no") << "\n";
+        info << "Eliminate constrained DOF: " << (eliminate_constrained_dofs ? "yes" : "no") << "\n";
         info << "Linear solver            : " << l_linear_solver->getPathName() << "\n\n";
     }
 
     // Local variables used for the iterations
     unsigned n_it=0;
-    double dx_squared_norm, du_squared_norm, R_squared_norm = 0;
+    double dx_squared_norm, du_squared_norm, R_squared_norm = 0, R_previous_squared_norm = 0;
+    FLOATING_POINT_TYPE forcing_term = maximum_forcing_term;
     const auto squared_residual_threshold = residual_tolerance_threshold*residual_tolerance_threshold;
     const auto squared_correction_threshold = correction_tolerance_threshold*correction_tolerance_threshold;
     const auto squared_absolute_residual_tolerance_threshold = absolute_residual_tolerance_threshold*absolute_residual_tolerance_threshold;
@@ -167,6 +316,20 @@ void NewtonRaphsonSolver::solve(const ExecParams *params, SReal dt, MultiVecCoor
     p_times.clear();
     p_times.reserve(newton_iterations);
 
+    // Resize vectors containing the forcing terms of the linear solver
+    p_forcing_terms.clear();
+    if (inexact_newton) {
+        p_forcing_terms.reserve(newton_iterations);
+    }
+
+    // Resize vectors containing the step lengths of the line search
+    p_step_lengths.clear();
+    if (line_search) {
+        p_step_lengths.reserve(newton_iterations);
+    }
+
+    p_number_of_factorizations = 0;
+
     // Start the advanced timer
     sofa::helper::ScopedAdvancedTimer timer ("BackwardEuler::Solve");
 
@@ -182,32 +345,147 @@ void NewtonRaphsonSolver::solve(const ExecParams *params, SReal dt, MultiVecCoor
     // accumulate the mechanical objects and mappings. This one will not really
     // compute the mechanical graph (not explicitly at least). Hence the following
     // @todo (jnbrunet2000@gmail.com) Create a CaribouMultiMatrixAccessor for that.
-    sofa::component::linearsolver::DefaultMultiMatrixAccessor accessor;
+    // The accessor is kept from one time step to the other, and is only built again
+    // when the mechanical states (or their sizes) and mappings of the sub-graph change.
+    const auto build_accessor = [&]() {
+        sofa::helper::ScopedAdvancedTimer _t_("BuildMechanicalGraph");
+        p_accessor->clear();
+
+        // Step 1   Get dimension of each top level mechanical states using
+        //          BaseMechanicalState::getMatrixSize(), and accumulate mechanical
+        //          objects and mapping matrices
+        mop.getMatrixDimension(nullptr, nullptr, p_accessor.get());
+
+        // Step 2   Does nothing more than to accumulate from the previous step a list of
+        //          "MatrixRef = <MechanicalState*, MatrixIndex>" where MatrixIndex is the
+        //          (i,i) position of the given top level MechanicalState* inside the global
+        //          system matrix. This global matrix hence contains one sub-matrix per top
+        //          level mechanical state.
+        p_accessor->setupMatrices();
+        p_accessor_matrix = nullptr;
+    };
+
+    auto mechanical_graph = mechanical_graph_signature();
+    const bool mechanical_graph_changed = (not p_accessor or mechanical_graph != p_mechanical_graph);
+    if (mechanical_graph_changed) {
+        if (not p_accessor) {
+            p_accessor = std::make_unique<sofa::component::linearsolver::DefaultMultiMatrixAccessor>();
+        }
+        build_accessor();
+        p_mechanical_graph = std::move(mechanical_graph);
+    }
 
-    // Step 1   Get dimension of each top level mechanical states using
-    //          BaseMechanicalState::getMatrixSize(), and accumulate mechanical
-    //          objects and mapping matrices
-    mop.getMatrixDimension(nullptr, nullptr, &accessor);
+    // The matrices of the mapped mechanical states are only zeroed when the accessor is built
+    const bool has_mapped_states = has_mapped_mechanical_states();
+    auto & accessor = *p_accessor;
     const auto n = static_cast<sofa::Size>(accessor.getGlobalDimension());
 
-    // Step 2   Does nothing more than to accumulate from the previous step a list of
-    //          "MatrixRef = <MechanicalState*, MatrixIndex>" where MatrixIndex is the
-    //          (i,i) position of the given top level MechanicalState* inside the global
-    //          system matrix. This global matrix hence contains one sub-matrix per top
-    //          level mechanical state.
-    accessor.setupMatrices();
+    // (Re)allocate a global system vector only if it doesn't already have the right size
+    const auto allocate = [&](std::unique_ptr<sofa::defaulttype::BaseVector> & v, sofa::Size size) {
+        if (not v or static_cast<sofa::Size>(v->size()) != size) {
+            v.reset(linear_solver->create_new_vector(size));
+        }
+    };
 
     // Step 3   Let the linear solver create the system matrix and vector buffers
-    //          using the previously computed system size n
-    p_A.reset(linear_solver->create_new_matrix(n, n));
-    p_A->clear();
-
-    p_DX.reset(linear_solver->create_new_vector(n));
+    //          using the previously computed system size n. When the system only contains
+    //          the DOFs of a single mechanical object, the vectors directly share the memory
+    //          of its force and increment vectors, which avoids copying them back and forth.
+    {
+        using Vector = Eigen::Matrix<FLOATING_POINT_TYPE, Eigen::Dynamic, 1>;
+        using MappedVector = SofaCaribou::Algebra::EigenVector<Eigen::Map<Vector>>;
+        auto F = SofaCaribou::Algebra::map_mechanical_vector(context, accessor, f_id);
+        auto DX = SofaCaribou::Algebra::map_mechanical_vector(context, accessor, dx_id);
+        const bool vectors_were_shared = p_system_vectors_are_shared;
+        p_system_vectors_are_shared = (F.data() and DX.data());
+        if (p_system_vectors_are_shared) {
+            p_DX = std::make_unique<MappedVector>(DX);
+            p_F = std::make_unique<MappedVector>(F);
+        } else {
+            if (vectors_were_shared) {
+                p_DX.reset();
+                p_F.reset();
+            }
+            allocate(p_DX, n);
+            allocate(p_F, n);
+        }
+    }
     p_DX->clear();
-
-    p_F.reset(linear_solver->create_new_vector(n));
     p_F->clear();
 
+    // Total displacement increment since the beginning
+    allocate(p_U, n);
+    p_U->clear();
+
+    // Secant pairs of the quasi-Newton strategy. They are only valid for the current time step.
+    p_number_of_secant_pairs = 0;
+    if (quasi_newton) {
+        p_secant_increments.resize(quasi_newton_history_size + 1);
+        p_secant_residual_changes.resize(quasi_newton_history_size + 1);
+        p_secant_inverse_curvatures.resize(quasi_newton_history_size + 1);
+        for (std::size_t i = 0; i <= quasi_newton_history_size; ++i) {
+            allocate(p_secant_increments[i], n);
+            allocate(p_secant_residual_changes[i], n);
+        }
+        allocate(p_quasi_newton_F, n);
+    }
+
+    // Step 4   When the constrained DOFs are eliminated, the system matrix only contains the rows and
+    //          columns of the free DOFs. It is assembled through a global view that maps the global
+    //          indices to the reduced ones, and the vectors are gathered to (scattered from) the reduced
+    //          vectors around the linear solve.
+    auto system_size = n;
+    bool constrained_dofs_changed = false;
+    if (eliminate_constrained_dofs) {
+        sofa::helper::ScopedAdvancedTimer _t_("FindConstrainedDofs");
+        constrained_dofs_changed = find_constrained_dofs(mechanical_parameters, accessor, dx_id, p_DX.get());
+        if (constrained_dofs_changed) {
+            p_factorization_is_reusable = false;
+        }
+        system_size = static_cast<sofa::Size>(p_reduced_index_map.reduced_size());
+
+        allocate(p_reduced_DX, system_size);
+        p_reduced_DX->clear();
+
+        allocate(p_reduced_F, system_size);
+        p_reduced_F->clear();
+    }
+
+    // The system matrix is kept from one time step to the other as long as the system doesn't change, which lets the
+    // Caribou linear solvers keep its compressed pattern and directly accumulate into it during the next assemblies.
+    // It is only cleared right before being assembled again: iterative solvers keep a reference to the factorized
+    // matrix, hence its coefficients must stay untouched while the factorization is reused.
+    if (not p_A or mechanical_graph_changed or constrained_dofs_changed or static_cast<sofa::Size>(p_A->rowSize()) != system_size) {
+        p_A.reset(linear_solver->create_new_matrix(system_size, system_size));
+        p_reduced_A_view.reset();
+        p_factorization_is_reusable = false;
+    }
+
+    // The factorization of the previous time step can only be kept when the system didn't change
+    if (not modified_newton or mechanical_graph_changed or system_size != p_factorized_system_size) {
+        p_factorization_is_reusable = false;
+    }
+    p_factorized_system_size = system_size;
+
+    if (eliminate_constrained_dofs and not p_reduced_A_view) {
+        p_reduced_A_view = std::make_unique<SofaCaribou::Algebra::ReducedMatrix>(p_A.get(), &p_reduced_index_map);
+    }
+    sofa::defaulttype::BaseMatrix * assembled_A = eliminate_constrained_dofs ? p_reduced_A_view.get() : p_A.get();
+    sofa::defaulttype::BaseVector * system_F  = eliminate_constrained_dofs ? p_reduced_F.get()  : p_F.get();
+    sofa::defaulttype::BaseVector * system_DX = eliminate_constrained_dofs ? p_reduced_DX.get() : p_DX.get();
+
+    if (print_log and eliminate_constrained_dofs) {
+        info << "Eliminated " << (n - system_size) << " constrained DOFs out of " << n << "\n";
+    }
+
+
+    // With the adaptive load stepping, only the fraction of the load increment of the time step that was reached
+    // so far is solved, i.e. R(x) = (1 - end) R_0 where R_0 is the residual at the beginning of the time step.
+    const auto remove_unsolved_load_fraction = [&]() {
+        if (p_unsolved_load_fraction > 0 and p_initial_F) {
+            SofaCaribou::Algebra::axpy(-p_unsolved_load_fraction, p_initial_F.get(), p_F.get());
+        }
+    };
 
     // ###########################################################################
     // #                             First residual                              #
@@ -219,10 +497,17 @@ void NewtonRaphsonSolver::solve(const ExecParams *params, SReal dt, MultiVecCoor
     // Step 1   Assemble the force vector
     sofa::helper::AdvancedTimer::stepBegin("ComputeForce");
     this->assemble_rhs_vector(mechanical_parameters, accessor, f_id, p_F.get());
+    if (p_capture_initial_residual) {
+        allocate(p_initial_F, n);
+        p_initial_F->clear();
+        SofaCaribou::Algebra::axpy(1., p_F.get(), p_initial_F.get());
+    }
+    remove_unsolved_load_fraction();
     sofa::helper::AdvancedTimer::stepEnd("ComputeForce");
 
     // Step 2   Compute the initial residual
-    R_squared_norm = SofaCaribou::Algebra::dot(p_F.get(), p_F.get());
+    R_squared_norm = SofaCaribou::Algebra::squared_norm(p_F.get());
+    R_previous_squared_norm = R_squared_norm;
     p_squared_initial_residual = R_squared_norm;
 
     if (absolute_residual_tolerance_threshold > 0 && R_squared_norm <= squared_absolute_residual_tolerance_threshold) {
@@ -244,56 +529,129 @@ void NewtonRaphsonSolver::solve(const ExecParams *params, SReal dt, MultiVecCoor
         sofa::helper::ScopedAdvancedTimer step_timer ("NewtonStep");
         t = steady_clock::now();
 
-        // Part 1. Assemble the system matrix.
-        {
-            sofa::helper::ScopedAdvancedTimer _t_("MBKBuild");
-            p_A->clear();
-            this->assemble_system_matrix(mechanical_parameters, accessor, p_A.get());
-        }
+        // With the modified Newton strategy, the current factorization is kept (and the system matrix isn't even
+        // assembled) as long as the residual contracted fast enough during the previous iteration
+        const bool reuse_factorization = modified_newton and p_factorization_is_reusable;
 
-        // Part 2. Analyze the pattern of the matrix in order to compute a permutation matrix.
-        {
-            // Let's see if we should (re)-analyze the pattern of the system matrix
-            if (
-                    pattern_strategy != PatternAnalysisStrategy::NEVER and (
-                        pattern_strategy == PatternAnalysisStrategy::ALWAYS or
-                        (
-                            (pattern_strategy == PatternAnalysisStrategy::BEGINNING_OF_THE_TIME_STEP or pattern_strategy == PatternAnalysisStrategy::BEGINNING_OF_THE_SIMULATION)
-                            and not p_has_already_analyzed_the_pattern
-                        )
-                   )
-                ) {
-
-                sofa::helper::ScopedAdvancedTimer _t_("MBKAnalyze");
-
-                if (not linear_solver->analyze_pattern(p_A.get())) {
-                    info << "[DIVERGED] Failed to analyze the pattern of the system matrix.";
-                    diverged = true;
-                    break;
+        if (not reuse_factorization) {
+            // Part 1. Assemble the system matrix.
+            {
+                sofa::helper::ScopedAdvancedTimer _t_("MBKBuild");
+
+                // The accessor keeps the mapped matrices (and the global matrix) of its previous assembly, hence it is
+                // built again unless it fills the same global matrix without any mapped mechanical state
+                if (has_mapped_states or assembled_A != p_accessor_matrix) {
+                    build_accessor();
+                    p_accessor_matrix = assembled_A;
                 }
 
-                p_has_already_analyzed_the_pattern = true;
+                assembled_A->clear();
+                this->assemble_system_matrix(mechanical_parameters, accessor, assembled_A);
             }
-        }
 
-        // Part 3. Factorize the matrix.
-        {
-            sofa::helper::ScopedAdvancedTimer _t_("MBKFactorize");
-            if (not linear_solver->factorize(p_A.get())) {
-                info << "[DIVERGED] Failed to factorize the system matrix.";
-                diverged = true;
-                break;
+            // Part 2. Analyze the pattern of the matrix in order to compute a permutation matrix.
+            {
+                // Let's see if we should (re)-analyze the pattern of the system matrix
+                if (
+                        pattern_strategy != PatternAnalysisStrategy::NEVER and (
+                            pattern_strategy == PatternAnalysisStrategy::ALWAYS or
+                            (
+                                (pattern_strategy == PatternAnalysisStrategy::BEGINNING_OF_THE_TIME_STEP or pattern_strategy == PatternAnalysisStrategy::BEGINNING_OF_THE_SIMULATION)
+                                and not p_has_already_analyzed_the_pattern
+                            )
+                       )
+                    ) {
+
+                    sofa::helper::ScopedAdvancedTimer _t_("MBKAnalyze");
+
+                    if (not linear_solver->analyze_pattern(p_A.get())) {
+                        info << "[DIVERGED] Failed to analyze the pattern of the system matrix.";
+                        diverged = true;
+                        break;
+                    }
+
+                    p_has_already_analyzed_the_pattern = true;
+                }
+            }
+
+            // Part 3. Factorize the matrix.
+            {
+                sofa::helper::ScopedAdvancedTimer _t_("MBKFactorize");
+
+                // When the system matrix only slightly changed since the last factorization (for example, a few
+                // elements were cut), the linear solver may update its current factors instead of computing new ones
+                bool factorized;
+                if (low_rank_update_ratio > 0) {
+                    const auto maximum_rank = static_cast<unsigned int>(low_rank_update_ratio * system_size);
+                    factorized = linear_solver->refactorize(p_A.get(), maximum_rank);
+                } else {
+                    factorized = linear_solver->factorize(p_A.get());
+                }
+
+                if (not factorized) {
+                    info << "[DIVERGED] Failed to factorize the system matrix.";
+                    diverged = true;
+                    break;
+                }
             }
+
+            p_factorization_is_reusable = true;
+            p_number_of_factorizations++;
+
+            // The secant pairs were built on top of the previous factorization
+            p_number_of_secant_pairs = 0;
         }
 
         // Part 4. Solve the unknown increment.
         {
             sofa::helper::ScopedAdvancedTimer _t_("MBKSolve");
-            if (not linear_solver->solve(p_F.get(), p_DX.get())) {
+            if (inexact_newton) {
+                linear_solver->set_forcing_term(forcing_term);
+                p_forcing_terms.emplace_back(forcing_term);
+            }
+
+            // With the quasi-Newton strategy, the linear solver only applies the initial inverse jacobian H_0 (the
+            // current factorization) of the L-BFGS two-loop recursion, dx = H_k R_k:
+            //     q = R_k ;   a_i = (s_i . q) / (y_i . s_i) ;   q -= a_i y_i      for i = k-1, ..., k-m
+            //     r = H_0 q ; b_i = (y_i . r) / (y_i . s_i) ;   r += (a_i - b_i) s_i  for i = k-m, ..., k-1
+            // where m is the number of secant pairs.
+            const sofa::defaulttype::BaseVector * F = p_F.get();
+            std::vector<FLOATING_POINT_TYPE> a (p_number_of_secant_pairs);
+            if (quasi_newton) {
+                // Keep R_k to compute the residual change of the next secant pair y_k = R_k - R_k+1
+                auto & y = p_secant_residual_changes[p_number_of_secant_pairs];
+                y->clear();
+                SofaCaribou::Algebra::axpy(1., p_F.get(), y.get());
+
+                auto * q = p_quasi_newton_F.get();
+                q->clear();
+                SofaCaribou::Algebra::axpy(1., p_F.get(), q);
+                for (auto i = p_number_of_secant_pairs; i-- > 0;) {
+                    a[i] = p_secant_inverse_curvatures[i] * SofaCaribou::Algebra::dot(p_secant_increments[i].get(), q);
+                    SofaCaribou::Algebra::axpy(-a[i], p_secant_residual_changes[i].get(), q);
+                }
+                F = q;
+            }
+
+            if (eliminate_constrained_dofs) {
+                p_reduced_index_map.gather(F, system_F);
+                F = system_F;
+            }
+            if (not linear_solver->solve(F, system_DX)) {
                 info << "[DIVERGED] Failed to solve the unknown increment.";
                 diverged = true;
                 break;
             }
+            if (eliminate_constrained_dofs) {
+                p_reduced_index_map.scatter(system_DX, p_DX.get());
+            }
+
+            if (quasi_newton) {
+                for (std::size_t i = 0; i < p_number_of_secant_pairs; ++i) {
+                    const auto b = p_secant_inverse_curvatures[i] * SofaCaribou::Algebra::dot(p_secant_residual_changes[i].get(), p_DX.get());
+                    SofaCaribou::Algebra::axpy(a[i] - b, p_secant_increments[i].get(), p_DX.get());
+                }
+            }
         }
 
         // Part 5. Propagating the solution increment and update geometry.
@@ -308,22 +666,80 @@ void NewtonRaphsonSolver::solve(const ExecParams *params, SReal dt, MultiVecCoor
             sofa::helper::AdvancedTimer::stepBegin("UpdateForce");
             p_F->clear();
             this->assemble_rhs_vector(mechanical_parameters, accessor, f_id, p_F.get());
+            remove_unsolved_load_fraction();
             sofa::helper::AdvancedTimer::stepEnd("UpdateForce");
 
             // Part 7. Compute the updated force residual.
             sofa::helper::AdvancedTimer::stepBegin("UpdateResidual");
-            R_squared_norm = SofaCaribou::Algebra::dot(p_F.get(), p_F.get());
+            R_squared_norm = SofaCaribou::Algebra::squared_norm(p_F.get());
             sofa::helper::AdvancedTimer::stepEnd("UpdateResidual");
+
+            // Part 7.1 Line search. The increment dx was fully applied (alpha = 1). As long as the residual didn't
+            //          decrease enough, the step is shortened to alpha' = rho alpha by propagating the difference
+            //          (alpha' - alpha) dx, and the residual is updated. The increment vector always holds the total
+            //          increment applied (alpha dx) at the end of an iteration of the search.
+            if (line_search) {
+                sofa::helper::ScopedAdvancedTimer _t_("LineSearch");
+                FLOATING_POINT_TYPE alpha = 1;
+                for (unsigned int k = 0; k < line_search_iterations; ++k) {
+                    const FLOATING_POINT_TYPE sufficient_decrease = 1 - line_search_sufficient_decrease*alpha;
+                    if (R_squared_norm <= sufficient_decrease*sufficient_decrease*R_previous_squared_norm) {
+                        break;
+                    }
+
+                    const FLOATING_POINT_TYPE next_alpha = line_search_step_reduction*alpha;
+
+                    // alpha dx  ->  (alpha' - alpha) dx
+                    SofaCaribou::Algebra::scale((next_alpha - alpha) / alpha, p_DX.get());
+                    this->propagate_solution_increment(mechanical_parameters, accessor, p_DX.get(), x_id, v_id, dx_id);
+
+                    // (alpha' - alpha) dx  ->  alpha' dx
+                    SofaCaribou::Algebra::scale(next_alpha / (next_alpha - alpha), p_DX.get());
+                    alpha = next_alpha;
+
+                    p_F->clear();
+                    this->assemble_rhs_vector(mechanical_parameters, accessor, f_id, p_F.get());
+                    remove_unsolved_load_fraction();
+                    R_squared_norm = SofaCaribou::Algebra::squared_norm(p_F.get());
+                }
+                p_step_lengths.emplace_back(alpha);
+            }
+
+            // Part 7.2 Secant pair of the quasi-Newton strategy, s_k = dx (the increment applied) and
+            //          y_k = R_k - R_k+1. The pair is dropped if it doesn't satisfy the curvature condition y.s > 0,
+            //          and the oldest pair is dropped when the history is full.
+            if (quasi_newton and quasi_newton_history_size > 0) {
+                const auto k = p_number_of_secant_pairs;
+                auto & s = p_secant_increments[k];
+                auto & y = p_secant_residual_changes[k];
+                s->clear();
+                SofaCaribou::Algebra::axpy(1., p_DX.get(), s.get());
+                SofaCaribou::Algebra::axpy(-1., p_F.get(), y.get());
+
+                const auto curvature = SofaCaribou::Algebra::dot(y.get(), s.get());
+                if (curvature > EPSILON*SofaCaribou::Algebra::norm(y.get())*SofaCaribou::Algebra::norm(s.get())) {
+                    p_secant_inverse_curvatures[k] = 1. / curvature;
+                    if (k < quasi_newton_history_size) {
+                        p_number_of_secant_pairs++;
+                    } else {
+                        std::rotate(p_secant_increments.begin(), p_secant_increments.begin() + 1, p_secant_increments.end());
+                        std::rotate(p_secant_residual_changes.begin(), p_secant_residual_changes.begin() + 1, p_secant_residual_changes.end());
+                        std::rotate(p_secant_inverse_curvatures.begin(), p_secant_inverse_curvatures.begin() + 1, p_secant_inverse_curvatures.end());
+                    }
+                }
+            }
+
+            // With the modified Newton strategy, the factorization is dropped when the residual didn't contract enough
+            if (modified_newton and R_squared_norm > maximum_contraction_rate*maximum_contraction_rate*R_previous_squared_norm) {
+                p_factorization_is_reusable = false;
+            }
         }
 
         // Part 8. Compute the updated displacement residual.
         sofa::helper::AdvancedTimer::stepBegin("UpdateU");
-        vop.v_peq(p_U_id, dx_id); // U += dx
-        vop.v_dot(dx_id, dx_id);  // dx.dot(dx)
-        dx_squared_norm = vop.finish();
-
-        vop.v_dot(p_U_id, p_U_id); // U.dot(U)
-        du_squared_norm = vop.finish();
+        SofaCaribou::Algebra::axpy(1., p_DX.get(), p_U.get()); // U += dx
+        dx_squared_norm = SofaCaribou::Algebra::squared_norm(p_DX.get()); // dx.dot(dx)
+        du_squared_norm = SofaCaribou::Algebra::squared_norm(p_U.get());  // U.dot(U)
         sofa::helper::AdvancedTimer::stepEnd("UpdateU");
 
         // Part 9. Stop timers and print step information.
@@ -342,6 +758,15 @@ void NewtonRaphsonSolver::solve(const ExecParams *params, SReal dt, MultiVecCoor
                  << "  |R|/|R0| = "   << std::setw(12) << sqrt(R_squared_norm  / p_squared_residuals[0])
                  << "  |du| / |U| = " << std::setw(12) << sqrt(dx_squared_norm / du_squared_norm)
                  << std::defaultfloat;
+            if (inexact_newton) {
+                info << "  Forcing term = " << std::scientific << std::setw(12) << forcing_term << std::defaultfloat;
+            }
+            if (reuse_factorization) {
+                info << "  (reused factorization)";
+            }
+            if (line_search) {
+                info << "  Step length = " << std::scientific << std::setw(12) << p_step_lengths.back() << std::defaultfloat;
+            }
             info << "  Time = " << iteration_time/1000/1000 << " ms";
             info << "\n";
         }
@@ -389,10 +814,34 @@ void NewtonRaphsonSolver::solve(const ExecParams *params, SReal dt, MultiVecCoor
             break;
         }
 
+        // Part 11. Compute the forcing term of the next linear solve.
+        if (inexact_newton) {
+            FLOATING_POINT_TYPE squared_target_residual = 0;
+            if (residual_tolerance_threshold > 0) {
+                squared_target_residual = std::max(squared_target_residual, squared_residual_threshold*p_squared_residuals[0]);
+            }
+            if (absolute_residual_tolerance_threshold > 0) {
+                squared_target_residual = std::max(squared_target_residual, squared_absolute_residual_tolerance_threshold);
+            }
+            forcing_term = eisenstat_walker_forcing_term(R_squared_norm, R_previous_squared_norm, forcing_term,
+                                                         maximum_forcing_term, squared_target_residual);
+        }
+        R_previous_squared_norm = R_squared_norm;
+
         // Clear up the solution
         vop.v_clear(dx_id);
     } // End while (not converged and not diverged and n_it < newton_iterations)
 
+    // A factorization that led to a divergence is never reused
+    if (diverged) {
+        p_factorization_is_reusable = false;
+    }
+
+    // Give back its own convergence criterion to the linear solver
+    if (inexact_newton) {
+        linear_solver->set_forcing_term(0);
+    }
+
     n_it--; // Reset to the actual index of the last iteration completed
 
     if (not converged and not diverged and n_it == (newton_iterations-1)) {
@@ -407,8 +856,91 @@ void NewtonRaphsonSolver::solve(const ExecParams *params, SReal dt, MultiVecCoor
     sofa::helper::AdvancedTimer::valSet("nb_iterations", n_it+1);
 }
 
+void NewtonRaphsonSolver::solve(const ExecParams *params, SReal dt, MultiVecCoordId x_id, MultiVecDerivId v_id) {
+    if (not adaptive_stepping() or not has_valid_linear_solver()) {
+        newton_solve(params, dt, x_id, v_id);
+        return;
+    }
+
+    // Adaptive load stepping: the load increment of the time step is applied by fractions. The state is saved before
+    // solving each fraction, and restored if the Newton iterations didn't converge.
+    sofa::core::MechanicalParams mechanical_parameters (*params);
+    sofa::simulation::common::VectorOperations vop( &mechanical_parameters, this->getContext() );
+    vop.v_realloc(p_saved_x_id, false /* interactionForceField */, true /* propagate [to mapped MO] */);
+    vop.v_realloc(p_saved_v_id, false /* interactionForceField */, true /* propagate [to mapped MO] */);
+
+    solve_adaptively(
+        [&](FLOATING_POINT_TYPE begin, FLOATING_POINT_TYPE end) {
+            vop.v_eq(p_saved_x_id, x_id);
+            vop.v_eq(p_saved_v_id, v_id);
+
+            // The residual R_0 of the time step is taken at the state of its beginning
+            p_capture_initial_residual = (begin == 0);
+            p_unsolved_load_fraction = 1 - end;
+            newton_solve(params, dt, x_id, v_id);
+        },
+        [&]() {
+            vop.v_eq(x_id, p_saved_x_id);
+            vop.v_eq(v_id, p_saved_v_id);
+            sofa::simulation::MechanicalPropagateOnlyPositionAndVelocityVisitor(&mechanical_parameters).execute(this->getContext());
+        }
+    );
+
+    p_capture_initial_residual = false;
+    p_unsolved_load_fraction = 0;
+}
+
+void NewtonRaphsonSolver::solve_adaptively(const std::function<void(FLOATING_POINT_TYPE, FLOATING_POINT_TYPE)> & solve_increment,
+                                           const std::function<void()> & restore_state) {
+    const auto & minimum_step = d_minimum_step.getValue();
+    const auto & step_growth_factor = d_step_growth_factor.getValue();
+    const auto & step_reduction_factor = d_step_reduction_factor.getValue();
+    const auto & target_newton_iterations = d_target_newton_iterations.getValue();
+
+    sofa::helper::vector<double> accepted_steps;
+    bool converged = true;
+
+    // The step found at the end of the previous time step is tried first
+    FLOATING_POINT_TYPE step = std::max(std::min(p_adaptive_step, FLOATING_POINT_TYPE(1)), FLOATING_POINT_TYPE(minimum_step));
+    FLOATING_POINT_TYPE progress = 0;
+    while (progress < 1) {
+        const FLOATING_POINT_TYPE end = (step >= 1 - progress) ? 1 : progress + step;
+        solve_increment(progress, end);
+
+        if (d_converged.getValue()) {
+            accepted_steps.emplace_back(end - progress);
+            progress = end;
+
+            // Newton converged easily, try a larger step next time
+            if (p_squared_residuals.size() <= target_newton_iterations) {
+                step = std::min(step*step_growth_factor, FLOATING_POINT_TYPE(1));
+            }
+        } else {
+            restore_state();
+
+            if (end - progress <= minimum_step) {
+                msg_warning() << "The adaptive stepping failed to converge with the minimum step of " << minimum_step
+                              << " (" << progress << " of the time step was solved).";
+                converged = false;
+                break;
+            }
+
+            // Newton diverged, retry from the restored state with a smaller step
+            step = std::max((end - progress)*step_reduction_factor, FLOATING_POINT_TYPE(minimum_step));
+            msg_info_when(f_printLog.getValue()) << "Newton diverged, reducing the step to " << step << ".";
+        }
+    }
+
+    p_adaptive_step = step;
+    d_accepted_steps.setValue(accepted_steps);
+    d_converged.setValue(converged);
+}
+
 void NewtonRaphsonSolver::init() {
     p_has_already_analyzed_the_pattern = false;
+    p_factorization_is_reusable = false;
+    p_A.reset();
+    p_accessor.reset();
 
     if (not has_valid_linear_solver()) {
         // No linear solver specified, let's try to find one in the current node
@@ -462,6 +994,71 @@ void NewtonRaphsonSolver::init() {
 
 void NewtonRaphsonSolver::reset() {
     p_has_already_analyzed_the_pattern = false;
+    p_factorization_is_reusable = false;
+    p_A.reset();
+    p_accessor.reset();
+    p_adaptive_step = 1;
+}
+
+bool NewtonRaphsonSolver::find_constrained_dofs(const sofa::core::MechanicalParams & mechanical_parameters,
+                                                const sofa::core::behavior::MultiMatrixAccessor & matrix_accessor,
+                                                MultiVecDerivId & dx_id,
+                                                sofa::defaulttype::BaseVector * buffer) {
+    using namespace sofa::simulation;
+    const auto n = buffer->size();
+    std::vector<bool> is_constrained (static_cast<std::size_t>(n), true);
+
+    // Project two random probe vectors and keep the DOFs that are zero in both. A structured probe such as
+    // (1, 1, 1, ...) can be orthogonal to a line or a plane of projection, in which case the DOFs projected onto
+    // it would be wrongly eliminated. A DOF is zero in the projection of a random probe only when its row of the
+    // projection is zero. The generator is seeded with a constant so that the detection is reproducible.
+    std::mt19937 generator (5489u);
+    std::uniform_real_distribution<SReal> distribution (1., 2.);
+    for (unsigned int probe = 0; probe < 2; ++probe) {
+        for (sofa::defaulttype::BaseVector::Index i = 0; i < n; ++i) {
+            buffer->set(i, distribution(generator));
+        }
+
+        MechanicalMultiVectorFromBaseVectorVisitor(&mechanical_parameters, dx_id, buffer, &matrix_accessor).execute(this->getContext());
+        MechanicalApplyConstraintsVisitor(&mechanical_parameters, dx_id, nullptr).execute(this->getContext());
+        MechanicalMultiVectorToBaseVectorVisitor(&mechanical_parameters, dx_id, buffer, &matrix_accessor).execute(this->getContext());
+
+        for (sofa::defaulttype::BaseVector::Index i = 0; i < n; ++i) {
+            if (buffer->element(i) != 0) {
+                is_constrained[static_cast<std::size_t>(i)] = false;
+            }
+        }
+    }
+
+    const bool changed = p_reduced_index_map.set_constrained_dofs(is_constrained);
+
+    buffer->clear();
+    sofa::simulation::common::VectorOperations(&mechanical_parameters, this->getContext()).v_clear(dx_id);
+
+    return changed;
+}
+
+auto NewtonRaphsonSolver::mechanical_graph_signature() const -> std::vector<std::pair<const sofa::core::objectmodel::BaseObject *, sofa::Size>> {
+    using Direction = sofa::core::objectmodel::BaseContext::SearchDirection;
+    std::vector<std::pair<const sofa::core::objectmodel::BaseObject *, sofa::Size>> signature;
+
+    for (const auto * state : this->getContext()->getObjects<sofa::core::behavior::BaseMechanicalState>(Direction::SearchDown)) {
+        signature.emplace_back(state, state->getMatrixSize());
+    }
+
+    for (const auto * mapping : this->getContext()->getObjects<sofa::core::BaseMapping>(Direction::SearchDown)) {
+        signature.emplace_back(mapping, 0);
+    }
+
+    return signature;
+}
+
+bool NewtonRaphsonSolver::has_mapped_mechanical_states() const {
+    using Direction = sofa::core::objectmodel::BaseContext::SearchDirection;
+    const auto mappings = this->getContext()->getObjects<sofa::core::BaseMapping>(Direction::SearchDown);
+    return std::any_of(mappings.begin(), mappings.end(), [](const sofa::core::BaseMapping * mapping) {
+        return mapping->isMechanical();
+    });
 }
 
 bool NewtonRaphsonSolver::has_valid_linear_solver() const {
@@ -491,4 +1088,59 @@ void NewtonRaphsonSolver::set_pattern_analysis_strategy(const NewtonRaphsonSolve
     pattern_analysis_strategy->setSelectedItem(static_cast<unsigned int> (strategy));
 }
 
-} // namespace SofaCaribou::ode
\ No newline at end of file
+auto NewtonRaphsonSolver::linear_solver_tolerance_strategy() const -> NewtonRaphsonSolver::LinearSolverToleranceStrategy {
+    const auto v = static_cast<LinearSolverToleranceStrategy>(d_linear_solver_tolerance_strategy.getValue().getSelectedId());
+    switch (v) {
+        case LinearSolverToleranceStrategy::FIXED:
+        case LinearSolverToleranceStrategy::EISENSTAT_WALKER:
+            return v;
+    }
+
+    // Default value
+    return NewtonRaphsonSolver::LinearSolverToleranceStrategy::FIXED;
+}
+
+void NewtonRaphsonSolver::set_linear_solver_tolerance_strategy(const NewtonRaphsonSolver::LinearSolverToleranceStrategy & strategy) {
+    using namespace sofa::helper;
+    auto linear_solver_tolerance_strategy = WriteOnlyAccessor<Data<OptionsGroup>>(d_linear_solver_tolerance_strategy);
+    linear_solver_tolerance_strategy->setSelectedItem(static_cast<unsigned int> (strategy));
+}
+
+auto NewtonRaphsonSolver::jacobian_update_strategy() const -> NewtonRaphsonSolver::JacobianUpdateStrategy {
+    const auto v = static_cast<JacobianUpdateStrategy>(d_jacobian_update_strategy.getValue().getSelectedId());
+    switch (v) {
+        case JacobianUpdateStrategy::FULL_NEWTON:
+        case JacobianUpdateStrategy::MODIFIED_NEWTON:
+        case JacobianUpdateStrategy::QUASI_NEWTON:
+            return v;
+    }
+
+    // Default value
+    return NewtonRaphsonSolver::JacobianUpdateStrategy::FULL_NEWTON;
+}
+
+void NewtonRaphsonSolver::set_jacobian_update_strategy(const NewtonRaphsonSolver::JacobianUpdateStrategy & strategy) {
+    using namespace sofa::helper;
+    auto jacobian_update_strategy = WriteOnlyAccessor<Data<OptionsGroup>>(d_jacobian_update_strategy);
+    jacobian_update_strategy->setSelectedItem(static_cast<unsigned int> (strategy));
+}
+
+auto NewtonRaphsonSolver::line_search_strategy() const -> NewtonRaphsonSolver::LineSearchStrategy {
+    const auto v = static_cast<LineSearchStrategy>(d_line_search_strategy.getValue().getSelectedId());
+    switch (v) {
+        case LineSearchStrategy::NONE:
+        case LineSearchStrategy::BACKTRACKING:
+            return v;
+    }
+
+    // Default value
+    return NewtonRaphsonSolver::LineSearchStrategy::NONE;
+}
+
+void NewtonRaphsonSolver::set_line_search_strategy(const NewtonRaphsonSolver::LineSearchStrategy & strategy) {
+    using namespace sofa::helper;
+    auto line_search_strategy = WriteOnlyAccessor<Data<OptionsGroup>>(d_line_search_strategy);
+    line_search_strategy->setSelectedItem(static_cast<unsigned int> (strategy));
+}
+
+} // namespace SofaCaribou::ode
@@ -10,10 +10,16 @@ DISABLE_ALL_WARNINGS_BEGIN
 #include <sofa/defaulttype/BaseVector.h>
 #include <sofa/core/objectmodel/Link.h>
 #include <sofa/helper/OptionsGroup.h>
+#include <sofa/helper/vector.h>
 #include <SofaBaseLinearSolver/DefaultMultiMatrixAccessor.h>
 DISABLE_ALL_WARNINGS_END
 
+#include <SofaCaribou/Algebra/ReducedMatrix.h>
+
+#include <functional>
 #include <memory>
+#include <utility>
+#include <vector>
 
 namespace SofaCaribou::ode {
 
@@ -63,6 +69,63 @@ public:
         ALWAYS
     };
 
+    /**
+     * Different strategies to determine the tolerance of the linear solver at each Newton iteration. This is only
+     * used by iterative linear solvers (for example, the ConjugateGradientSolver).
+     */
+    enum class LinearSolverToleranceStrategy : unsigned int {
+        /** The linear solver always uses its own convergence criterion. */
+        FIXED = 0,
+
+        /**
+         * Inexact Newton: the relative residual tolerance (forcing term) of the linear solver is computed from the
+         * ratio of the last two Newton residuals (Eisenstat & Walker, 1996, choice 2). The linear systems of the
+         * first Newton iterations, which are far from the solution, are solved roughly, and the tolerance gets
+         * tighter as the Newton iterations converge.
+         */
+        EISENSTAT_WALKER
+    };
+
+    /**
+     * Different strategies to determine when the system matrix (the jacobian) should be assembled and factorized.
+     */
+    enum class JacobianUpdateStrategy : unsigned int {
+        /** The system matrix is assembled and factorized at every Newton iteration. */
+        FULL_NEWTON = 0,
+
+        /**
+         * Modified Newton: the current factorization is kept, across Newton iterations and time steps, as long as the
+         * residual contracts fast enough (|R_k| / |R_k-1| lower than the maximum contraction rate). The system matrix
+         * is assembled and factorized again at the next iteration otherwise. The convergence is only linear, but most
+         * of the assembly and factorization steps are skipped on mildly nonlinear problems.
+         */
+        MODIFIED_NEWTON,
+
+        /**
+         * Quasi-Newton (L-BFGS): the factorization is kept as with the modified Newton strategy, and is used as the
+         * initial inverse jacobian of a limited-memory BFGS update. The pairs (s_i, y_i) of the last increments
+         * s_i = dx_i and residual changes y_i = R_i - R_i+1 of the time step are used to correct the increment
+         * computed with the factorization by low-rank secant updates. The convergence is superlinear without
+         * assembling the system matrix again. The pairs are dropped each time the system matrix is factorized.
+         */
+        QUASI_NEWTON
+    };
+
+    /**
+     * Different strategies to determine the length of the step taken along the solution increment of a Newton iteration.
+     */
+    enum class LineSearchStrategy : unsigned int {
+        /** The full solution increment is always applied. */
+        NONE = 0,
+
+        /**
+         * Backtracking on the residual: the increment is first fully applied, and its length is then reduced by the
+         * step reduction factor until the residual norm decreased enough, i.e. |R(alpha)| <= (1 - c alpha) |R_k|
+         * where alpha is the step length and c the sufficient decrease factor.
+         */
+        BACKTRACKING
+    };
+
     CARIBOU_API
     NewtonRaphsonSolver();
 
@@ -84,6 +147,29 @@ public:
     /** The initial squared residual (||r0||^2) of the last solve call. */
     auto squared_initial_residual() const -> const FLOATING_POINT_TYPE & { return p_squared_initial_residual; }
 
+    /** The forcing terms (relative residual tolerances) given to the linear solver at every newton iterations of the last solve call. */
+    auto forcing_terms() const -> const std::vector<FLOATING_POINT_TYPE> & { return p_forcing_terms; }
+
+    /** The number of times the system matrix was assembled and factorized during the last solve call. */
+    auto number_of_factorizations() const -> UNSIGNED_INTEGER_TYPE { return p_number_of_factorizations; }
+
+    /** The step lengths found by the line search at every newton iterations of the last solve call. */
+    auto step_lengths() const -> const std::vector<FLOATING_POINT_TYPE> & { return p_step_lengths; }
+
+    /**
+     * States if the global system vectors (forces and increment) of the last solve call shared the memory of the force
+     * and increment vectors of the mechanical object (see SofaCaribou::Algebra::map_mechanical_vector). In this case,
+     * there is no need to copy the vectors from (or into) the mechanical object.
+     */
+    auto system_vectors_are_shared() const -> bool { return p_system_vectors_are_shared; }
+
+    /**
+     * States if the time step is split in smaller increments when the Newton iterations don't converge. The adaptive
+     * stepping is only used when more than one Newton iteration is allowed per time step, since a single iteration
+     * is never flagged as converged.
+     */
+    auto adaptive_stepping() const -> bool { return d_adaptive_stepping.getValue() and d_newton_iterations.getValue() > 1; }
+
     /** Get the current strategy that determine when the pattern of the system matrix should be analyzed. */
     CARIBOU_API
     auto pattern_analysis_strategy() const -> PatternAnalysisStrategy;
@@ -92,6 +178,55 @@ public:
     CARIBOU_API
     void set_pattern_analysis_strategy(const PatternAnalysisStrategy & strategy);
 
+    /** Get the current strategy that determine the tolerance of the linear solver at each Newton iteration. */
+    CARIBOU_API
+    auto linear_solver_tolerance_strategy() const -> LinearSolverToleranceStrategy;
+
+    /** Set the current strategy that determine the tolerance of the linear solver at each Newton iteration. */
+    CARIBOU_API
+    void set_linear_solver_tolerance_strategy(const LinearSolverToleranceStrategy & strategy);
+
+    /** Get the current strategy that determine when the system matrix should be assembled and factorized. */
+    CARIBOU_API
+    auto jacobian_update_strategy() const -> JacobianUpdateStrategy;
+
+    /** Set the current strategy that determine when the system matrix should be assembled and factorized. */
+    CARIBOU_API
+    void set_jacobian_update_strategy(const JacobianUpdateStrategy & strategy);
+
+    /** Get the current strategy that determine the length of the step taken along the solution increment. */
+    CARIBOU_API
+    auto line_search_strategy() const -> LineSearchStrategy;
+
+    /** Set the current strategy that determine the length of the step taken along the solution increment. */
+    CARIBOU_API
+    void set_line_search_strategy(const LineSearchStrategy & strategy);
+
+protected:
+    /**
+     * Solve the time step with the Newton iterations, without adaptive stepping. The result of the iterations is
+     * written in the converged data field.
+     */
+    CARIBOU_API
+    void newton_solve(const sofa::core::ExecParams* params, SReal dt, sofa::core::MultiVecCoordId x_id, sofa::core::MultiVecDerivId v_id);
+
+    /**
+     * Adaptive stepping controller. The time step is split in increments [begin, end] of the interval [0, 1], which
+     * are solved one after the other. When an increment doesn't converge, the state is restored and a smaller increment
+     * is tried. When it converges in few Newton iterations, the next increment is enlarged. The accepted increments are
+     * written in the accepted_steps data field.
+     *
+     * @param solve_increment Solve the Newton iterations of the increment [begin, end] from the current state.
+     * @param restore_state Restore the state from before the last call to solve_increment.
+     */
+    CARIBOU_API
+    void solve_adaptively(const std::function<void(FLOATING_POINT_TYPE begin, FLOATING_POINT_TYPE end)> & solve_increment,
+                          const std::function<void()> & restore_state);
+
+    /** Check that the linked linear solver is not null and that it implements the SofaCaribou::solver::LinearSolver interface */
+    CARIBOU_API
+    bool has_valid_linear_solver () const;
+
 private:
 
     /**
@@ -164,9 +299,39 @@ private:
                                               sofa::core::MultiVecDerivId & v_id,
                                               sofa::core::MultiVecDerivId & dx_id) = 0;
 
-    /** Check that the linked linear solver is not null and that it implements the SofaCaribou::solver::LinearSolver interface */
+    /**
+     * Signature of the mechanical graph of the current context sub-graph: its mechanical states with their matrix
+     * sizes, followed by its mappings. The multi-matrix accessor is built again when it changes.
+     */
     CARIBOU_API
-    bool has_valid_linear_solver () const;
+    auto mechanical_graph_signature() const -> std::vector<std::pair<const sofa::core::objectmodel::BaseObject *, sofa::Size>>;
+
+    /**
+     * True if the current context sub-graph contains mechanical mappings, i.e. mapped mechanical states having their
+     * own stiffness matrices that are accumulated into the global system matrix.
+     */
+    CARIBOU_API
+    bool has_mapped_mechanical_states() const;
+
+    /**
+     * Find the degrees of freedom of the global system that are fixed by the projective constraints, and build the
+     * index map of the reduced system from which they are eliminated.
+     *
+     * A DOF is considered constrained when the projective constraints (BaseProjectiveConstraintSet::projectResponse)
+     * set it to zero in two random probe vectors, i.e. when its row of the projection is zero. The DOFs projected onto
+     * a line or a plane are kept in the system, whatever the direction of the line or the normal of the plane.
+     *
+     * @param mechanical_parameters The set of mechanical parameters defined by the Newton-Raphson.
+     * @param matrix_accessor The multi-matrix accessor which contains the current mechanical graph.
+     * @param dx_id The increment multi-vector identifier, used as a temporary buffer (it is cleared on exit).
+     * @param buffer A global system vector used as a temporary buffer.
+     * @return True if the constrained DOFs changed since the last call.
+     */
+    CARIBOU_API
+    bool find_constrained_dofs(const sofa::core::MechanicalParams & mechanical_parameters,
+                               const sofa::core::behavior::MultiMatrixAccessor & matrix_accessor,
+                               sofa::core::MultiVecDerivId & dx_id,
+                               sofa::defaulttype::BaseVector * buffer);
 
     /// INPUTS
     Data<unsigned> d_newton_iterations;
@@ -174,6 +339,22 @@ private:
     Data<double> d_residual_tolerance_threshold;
     Data<double> d_absolute_residual_tolerance_threshold;
     Data<sofa::helper::OptionsGroup> d_pattern_analysis_strategy;
+    Data<sofa::helper::OptionsGroup> d_linear_solver_tolerance_strategy;
+    Data<double> d_maximum_forcing_term;
+    Data<double> d_low_rank_update_ratio;
+    Data<bool> d_eliminate_constrained_dofs;
+    Data<sofa::helper::OptionsGroup> d_jacobian_update_strategy;
+    Data<double> d_maximum_contraction_rate;
+    Data<unsigned> d_quasi_newton_history_size;
+    Data<sofa::helper::OptionsGroup> d_line_search_strategy;
+    Data<unsigned> d_line_search_iterations;
+    Data<double> d_line_search_step_reduction;
+    Data<double> d_line_search_sufficient_decrease;
+    Data<bool> d_adaptive_stepping;
+    Data<double> d_minimum_step;
+    Data<double> d_step_growth_factor;
+    Data<double> d_step_reduction_factor;
+    Data<unsigned> d_target_newton_iterations;
 
     Link<sofa::core::behavior::LinearSolver> l_linear_solver;
 
@@ -181,9 +362,19 @@ private:
     /// Whether or not the last call to solve converged
     Data<bool> d_converged;
 
+    /// Increments (fractions of the time step) accepted by the adaptive stepping during the last call to solve
+    Data<sofa::helper::vector<double>> d_accepted_steps;
+
     /// Private members
 
-    /// Global system matrix A = mM + bB + kK
+    /// Multi-matrix accessor of the mechanical graph, and the signature of the graph from which it was built
+    std::unique_ptr<sofa::component::linearsolver::DefaultMultiMatrixAccessor> p_accessor;
+    std::vector<std::pair<const sofa::core::objectmodel::BaseObject *, sofa::Size>> p_mechanical_graph;
+
+    /// System matrix filled by the multi-matrix accessor since it was last built
+    const sofa::defaulttype::BaseMatrix * p_accessor_matrix = nullptr;
+
+    /// Global system matrix A = mM + bB + kK (without the rows and columns of the constrained DOFs when they are eliminated)
     std::unique_ptr<sofa::defaulttype::BaseMatrix> p_A;
 
     /// Global system LHS vector (the solution)
@@ -192,8 +383,18 @@ private:
     /// Global system RHS vector (the forces)
     std::unique_ptr<sofa::defaulttype::BaseVector> p_F;
 
+    /// Index map between the global system and the reduced system (without the constrained DOFs)
+    SofaCaribou::Algebra::ReducedIndexMap p_reduced_index_map;
+
+    /// Global view of the reduced system matrix, used during the assembly when the constrained DOFs are eliminated
+    std::unique_ptr<SofaCaribou::Algebra::ReducedMatrix> p_reduced_A_view;
+
+    /// Reduced system LHS and RHS vectors, used when the constrained DOFs are eliminated
+    std::unique_ptr<sofa::defaulttype::BaseVector> p_reduced_DX;
+    std::unique_ptr<sofa::defaulttype::BaseVector> p_reduced_F;
+
     /// Total displacement since the beginning of the step
-    sofa::core::MultiVecDerivId p_U_id;
+    std::unique_ptr<sofa::defaulttype::BaseVector> p_U;
 
     /// List of times (in nanoseconds) took to compute each Newton-Raphson iteration
     std::vector<UNSIGNED_INTEGER_TYPE> p_times;
@@ -204,7 +405,51 @@ private:
     /// Initial squared residual (||r0||^2) of the last solve call.
     FLOATING_POINT_TYPE p_squared_initial_residual {};
 
+    /// List of the forcing terms given to the linear solver at every newton iterations of the last solve call.
+    std::vector<FLOATING_POINT_TYPE> p_forcing_terms;
+
+    /// List of the step lengths found by the line search at every newton iterations of the last solve call.
+    std::vector<FLOATING_POINT_TYPE> p_step_lengths;
+
     /// Either or not the pattern of the system matrix was analyzed at the beginning of the simulation
     bool p_has_already_analyzed_the_pattern = false;
+
+    /// Either or not the current factorization of the linear solver can be kept for the next Newton iteration (modified Newton)
+    bool p_factorization_is_reusable = false;
+
+    /// Size of the system factorized by the linear solver
+    sofa::Size p_factorized_system_size = 0;
+
+    /// Number of times the system matrix was assembled and factorized during the last solve call
+    UNSIGNED_INTEGER_TYPE p_number_of_factorizations = 0;
+
+    /// Secant pairs of the quasi-Newton strategy: increments s_i, residual changes y_i and 1 / (y_i . s_i), from the
+    /// oldest to the most recent. One more pair than the history size is allocated to hold the pair being built.
+    std::vector<std::unique_ptr<sofa::defaulttype::BaseVector>> p_secant_increments;
+    std::vector<std::unique_ptr<sofa::defaulttype::BaseVector>> p_secant_residual_changes;
+    std::vector<FLOATING_POINT_TYPE> p_secant_inverse_curvatures;
+
+    /// Number of secant pairs currently used by the quasi-Newton strategy
+    std::size_t p_number_of_secant_pairs = 0;
+
+    /// Right-hand side given to the linear solver with the quasi-Newton strategy
+    std::unique_ptr<sofa::defaulttype::BaseVector> p_quasi_newton_F;
+
+    /// Increment (fraction of the time step) that will be tried first by the adaptive stepping
+    FLOATING_POINT_TYPE p_adaptive_step = 1;
+
+    /// Positions and velocities saved before solving an increment of the adaptive load stepping
+    sofa::core::MultiVecCoordId p_saved_x_id;
+    sofa::core::MultiVecDerivId p_saved_v_id;
+
+    /// Residual at the beginning of the time step, and the fraction of it that is not solved yet (adaptive load stepping)
+    std::unique_ptr<sofa::defaulttype::BaseVector> p_initial_F;
+    FLOATING_POINT_TYPE p_unsolved_load_fraction = 0;
+
+    /// Either or not the next call to newton_solve should save its initial residual into p_initial_F
+    bool p_capture_initial_residual = false;
+
+    /// Either or not the global system vectors share the memory of the force and increment vectors of the mechanical object
+    bool p_system_vectors_are_shared = false;
 };
 }
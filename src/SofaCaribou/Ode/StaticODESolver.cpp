@@ -41,8 +41,11 @@ void StaticODESolver::assemble_rhs_vector(const sofa::core::MechanicalParams &me
     .execute(this->getContext());
 
     // 4. Copy force vectors from every top level (unmapped) mechanical objects into the given system vector f
-    MechanicalMultiVectorToBaseVectorVisitor(&mechanical_parameters, f_id /* source */, f /* destination */, &matrix_accessor)
-    .execute(this->getContext());
+    //    (unless f already shares the memory of the mechanical object)
+    if (not system_vectors_are_shared()) {
+        MechanicalMultiVectorToBaseVectorVisitor(&mechanical_parameters, f_id /* source */, f /* destination */, &matrix_accessor)
+        .execute(this->getContext());
+    }
 }
 
 // Assemble A in A [dx] = F
@@ -63,7 +66,7 @@ void StaticODESolver::assemble_system_matrix(const sofa::core::MechanicalParams
     Timer::stepEnd("AssembleGlobalMatrix");
 
     Timer::stepBegin("ConstrainGlobalMatrix");
-    visitor::ConstrainGlobalMatrix(&m_params, &matrix_accessor).execute(this->getContext());
+    visitor::ConstrainGlobalMatrix(&m_params, &matrix_accessor, A).execute(this->getContext());
     Timer::stepEnd("ConstrainGlobalMatrix");
 
     // Step 2. Mechanical mappings
@@ -91,8 +94,11 @@ void StaticODESolver::propagate_solution_increment(const sofa::core::MechanicalP
                                                    sofa::core::MultiVecDerivId & /* v_id */,
                                                    sofa::core::MultiVecDerivId & dx_id) {
 
-    // 1. Copy vectors from the global system vector into every top level (unmapped) mechanical objects.
-    MechanicalMultiVectorFromBaseVectorVisitor(&mechanical_parameters, dx_id, dx, &matrix_accessor).execute(this->getContext());
+    // 1. Copy vectors from the global system vector into every top level (unmapped) mechanical objects
+    //    (unless dx already shares the memory of the mechanical object).
+    if (not system_vectors_are_shared()) {
+        MechanicalMultiVectorFromBaseVectorVisitor(&mechanical_parameters, dx_id, dx, &matrix_accessor).execute(this->getContext());
+    }
 
     // 2. x += dx
     MechanicalVOpVisitor(&mechanical_parameters, x_id, x_id, dx_id).execute(this->getContext());
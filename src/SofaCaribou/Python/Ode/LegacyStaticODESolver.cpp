@@ -21,6 +21,7 @@ void addLegacyStaticODESolver(py::module &m) {
     c.def_property_readonly("iteration_times", &LegacyStaticODESolver::iteration_times);
     c.def_property_readonly("squared_residuals", &LegacyStaticODESolver::squared_residuals);
     c.def_property_readonly("squared_initial_residual", &LegacyStaticODESolver::squared_initial_residual);
+    c.def_property_readonly("forcing_terms", &LegacyStaticODESolver::forcing_terms);
     c.def_property_readonly("iterative_linear_solver_squared_residuals", &LegacyStaticODESolver::iterative_linear_solver_squared_residuals);
     c.def_property_readonly("iterative_linear_solver_squared_rhs_norms", &LegacyStaticODESolver::iterative_linear_solver_squared_rhs_norms);
 
@@ -21,6 +21,7 @@ void addStaticODESolver(py::module &m) {
     c.def_property_readonly("iteration_times", &StaticODESolver::iteration_times);
     c.def_property_readonly("squared_residuals", &StaticODESolver::squared_residuals);
     c.def_property_readonly("squared_initial_residual", &StaticODESolver::squared_initial_residual);
+    c.def_property_readonly("forcing_terms", &StaticODESolver::forcing_terms);
 
     sofapython3::PythonFactory::registerType<StaticODESolver>([](sofa::core::objectmodel::Base* o) {
         return py::cast(dynamic_cast<StaticODESolver*>(o));
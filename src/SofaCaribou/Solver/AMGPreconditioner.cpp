@@ -0,0 +1,357 @@
+#include <SofaCaribou/Solver/AMGPreconditioner.h>
+
+#include <Eigen/QR>
+
+#include <algorithm>
+#include <cmath>
+
+namespace SofaCaribou::solver {
+
+void AMGPreconditioner::set_dofs_per_node(Index dofs_per_node) {
+    p_dofs_per_node = std::max(dofs_per_node, static_cast<Index>(1));
+    p_coordinates.resize(0);
+}
+
+void AMGPreconditioner::set_coordinates(const Vector & coordinates, Index dofs_per_node) {
+    set_dofs_per_node(dofs_per_node);
+    p_coordinates = coordinates;
+}
+
+auto AMGPreconditioner::near_null_space(Index n) const -> DenseMatrix {
+    const Index D = p_dofs_per_node;
+    const Index number_of_nodes = n / D;
+    const bool use_rotations = (D == 2 or D == 3) and p_coordinates.size() == n;
+    const Index number_of_rotations = use_rotations ? (D == 2 ? 1 : 3) : 0;
+
+    DenseMatrix B = DenseMatrix::Zero(n, D + number_of_rotations);
+
+    // Translations
+    for (Index node = 0; node < number_of_nodes; ++node) {
+        for (Index d = 0; d < D; ++d) {
+            B(node*D + d, d) = 1.;
+        }
+    }
+
+    if (not use_rotations) {
+        return B;
+    }
+
+    // Rotations around the barycenter (centering the coordinates improves the conditioning of the modes)
+    Eigen::Matrix<Scalar, 3, 1> center = Eigen::Matrix<Scalar, 3, 1>::Zero();
+    for (Index node = 0; node < number_of_nodes; ++node) {
+        for (Index d = 0; d < D; ++d) {
+            center[d] += p_coordinates[node*D + d];
+        }
+    }
+    center /= static_cast<Scalar>(std::max(number_of_nodes, static_cast<Index>(1)));
+
+    for (Index node = 0; node < number_of_nodes; ++node) {
+        const Index i = node*D;
+        const Scalar x = p_coordinates[i+0] - center[0];
+        const Scalar y = p_coordinates[i+1] - center[1];
+        if (D == 2) {
+            B(i+0, 2) = -y;
+            B(i+1, 2) =  x;
+        } else {
+            const Scalar z = p_coordinates[i+2] - center[2];
+            // Around x
+            B(i+1, 3) = -z;
+            B(i+2, 3) =  y;
+            // Around y
+            B(i+0, 4) =  z;
+            B(i+2, 4) = -x;
+            // Around z
+            B(i+0, 5) = -y;
+            B(i+1, 5) =  x;
+        }
+    }
+
+    return B;
+}
+
+auto AMGPreconditioner::aggregate(const Matrix & A, Index dofs_per_node, Scalar theta) const -> std::pair<std::vector<Index>, Index> {
+    const Index D = dofs_per_node;
+    const Index number_of_nodes = A.rows() / D;
+
+    // 1. Compute the squared Frobenius norm of every non-zero D x D block of the matrix (node graph)
+    std::vector<std::vector<std::pair<Index, Scalar>>> blocks (static_cast<std::size_t>(number_of_nodes));
+    std::vector<Scalar> diagonal_norms (static_cast<std::size_t>(number_of_nodes), 0.);
+    std::vector<Index> position (static_cast<std::size_t>(number_of_nodes), -1);
+    for (Index I = 0; I < number_of_nodes; ++I) {
+        auto & row_blocks = blocks[I];
+        for (Index i = I*D; i < (I+1)*D; ++i) {
+            for (Matrix::InnerIterator it(A, i); it; ++it) {
+                const Index J = it.col() / D;
+                if (position[J] < 0) {
+                    position[J] = static_cast<Index>(row_blocks.size());
+                    row_blocks.emplace_back(J, 0.);
+                }
+                row_blocks[position[J]].second += it.value()*it.value();
+            }
+        }
+        for (const auto & block : row_blocks) {
+            position[block.first] = -1;
+            if (block.first == I) {
+                diagonal_norms[I] = std::sqrt(block.second);
+            }
+        }
+    }
+
+    // 2. Keep only the strong connections: |A_IJ| >= theta * sqrt(|A_II| |A_JJ|)
+    std::vector<std::vector<Index>> strong_neighbors (static_cast<std::size_t>(number_of_nodes));
+    for (Index I = 0; I < number_of_nodes; ++I) {
+        for (const auto & block : blocks[I]) {
+            const Index J = block.first;
+            if (J == I) {
+                continue;
+            }
+            if (std::sqrt(block.second) >= theta * std::sqrt(diagonal_norms[I] * diagonal_norms[J])) {
+                strong_neighbors[I].emplace_back(J);
+            }
+        }
+    }
+
+    // 3. Aggregation
+    std::vector<Index> aggregates (static_cast<std::size_t>(number_of_nodes), -1);
+    Index number_of_aggregates = 0;
+
+    // Pass 1: a node with no aggregated strong neighbors forms a new aggregate with all of them.
+    //         Isolated nodes (for example, fixed nodes) are left out of the coarse space.
+    for (Index I = 0; I < number_of_nodes; ++I) {
+        if (aggregates[I] >= 0 or strong_neighbors[I].empty()) {
+            continue;
+        }
+        const bool all_free = std::all_of(strong_neighbors[I].begin(), strong_neighbors[I].end(), [&](const Index & J) {
+            return aggregates[J] < 0;
+        });
+        if (not all_free) {
+            continue;
+        }
+        aggregates[I] = number_of_aggregates;
+        for (const Index & J : strong_neighbors[I]) {
+            aggregates[J] = number_of_aggregates;
+        }
+        ++number_of_aggregates;
+    }
+
+    // Pass 2: the remaining nodes join the aggregate of one of their strong neighbors
+    const std::vector<Index> aggregates_after_first_pass = aggregates;
+    for (Index I = 0; I < number_of_nodes; ++I) {
+        if (aggregates[I] >= 0) {
+            continue;
+        }
+        for (const Index & J : strong_neighbors[I]) {
+            if (aggregates_after_first_pass[J] >= 0) {
+                aggregates[I] = aggregates_after_first_pass[J];
+                break;
+            }
+        }
+    }
+
+    return {aggregates, number_of_aggregates};
+}
+
+auto AMGPreconditioner::tentative_prolongation(const std::vector<Index> & aggregates, Index number_of_aggregates,
+                                               Index dofs_per_node, const DenseMatrix & B, DenseMatrix & Bc) const -> Matrix {
+    const Index D = dofs_per_node;
+    const Index n = B.rows();
+    const Index k = B.cols();
+    const auto number_of_nodes = static_cast<Index>(aggregates.size());
+
+    // Gather the degrees of freedom of every aggregates
+    std::vector<std::vector<Index>> aggregate_dofs (static_cast<std::size_t>(number_of_aggregates));
+    for (Index I = 0; I < number_of_nodes; ++I) {
+        if (aggregates[I] < 0) {
+            continue;
+        }
+        for (Index d = 0; d < D; ++d) {
+            aggregate_dofs[aggregates[I]].emplace_back(I*D + d);
+        }
+    }
+
+    Bc = DenseMatrix::Zero(number_of_aggregates*k, k);
+    std::vector<Eigen::Triplet<Scalar>> triplets;
+    triplets.reserve(static_cast<std::size_t>(n*k));
+
+    for (Index a = 0; a < number_of_aggregates; ++a) {
+        const auto & dofs = aggregate_dofs[a];
+        const auto rows = static_cast<Index>(dofs.size());
+
+        // Local near null space of the aggregate
+        DenseMatrix local_B (rows, k);
+        for (Index i = 0; i < rows; ++i) {
+            local_B.row(i) = B.row(dofs[i]);
+        }
+
+        // Orthonormalization: local_B = Q R
+        Eigen::HouseholderQR<DenseMatrix> qr (local_B);
+        const Index m = std::min(rows, k);
+        const DenseMatrix Q = qr.householderQ() * DenseMatrix::Identity(rows, k);
+        Bc.block(a*k, 0, m, k) = qr.matrixQR().topRows(m).template triangularView<Eigen::Upper>();
+
+        for (Index i = 0; i < rows; ++i) {
+            for (Index j = 0; j < k; ++j) {
+                triplets.emplace_back(dofs[i], a*k + j, Q(i, j));
+            }
+        }
+    }
+
+    Matrix P (n, number_of_aggregates*k);
+    P.setFromTriplets(triplets.begin(), triplets.end());
+    return P;
+}
+
+void AMGPreconditioner::build(const Matrix & A) {
+    p_levels.clear();
+    p_info = Eigen::Success;
+
+    if (A.rows() != A.cols()) {
+        p_info = Eigen::InvalidInput;
+        return;
+    }
+
+    // The number of degrees of freedom per node must divide the size of the system
+    Index D = p_dofs_per_node;
+    if (D < 1 or A.rows() % D != 0) {
+        D = 1;
+    }
+
+    DenseMatrix B = (D == p_dofs_per_node) ? near_null_space(A.rows()) : DenseMatrix::Ones(A.rows(), 1);
+
+    p_levels.emplace_back();
+    p_levels.back().A = A;
+
+    Scalar theta = p_strength_threshold;
+    while (static_cast<Index>(p_levels.size()) < p_maximum_number_of_levels) {
+        Level & level = p_levels.back();
+        const Matrix & Al = level.A;
+        const Index n = Al.rows();
+        if (n <= p_maximum_coarse_size) {
+            break;
+        }
+
+        // 1. Aggregation
+        const auto [aggregates, number_of_aggregates] = aggregate(Al, D, theta);
+        const Index coarse_size = number_of_aggregates * B.cols();
+        if (number_of_aggregates == 0 or coarse_size >= n) {
+            break; // The system cannot be coarsened anymore
+        }
+
+        // 2. Tentative prolongation
+        DenseMatrix Bc;
+        const Matrix P_tentative = tentative_prolongation(aggregates, number_of_aggregates, D, B, Bc);
+
+        // 3. Smoothing of the prolongation with a damped Jacobi iteration: P = (I - w D^-1 A) P_tentative
+        //    with w = 4/3 / rho(D^-1 A), where the spectral radius is estimated with a few power iterations.
+        const Vector diagonal = Al.diagonal();
+        const Vector inverse_diagonal = diagonal.unaryExpr([](const Scalar & d) {
+            return (std::abs(d) > EPSILON) ? 1./d : 0.;
+        });
+
+        Vector v = Vector::Ones(n) + Vector::Random(n) * 0.1;
+        Scalar rho = 1.;
+        for (unsigned int i = 0; i < 15; ++i) {
+            const Vector w = inverse_diagonal.asDiagonal() * (Al * v);
+            const Scalar w_norm = w.norm();
+            if (w_norm < EPSILON) {
+                break;
+            }
+            rho = w_norm / v.norm();
+            v = w / w_norm;
+        }
+        const Scalar omega = (4. / 3.) / rho;
+
+        Matrix AP = Al * P_tentative;
+        Matrix P = P_tentative - Matrix((omega * inverse_diagonal).asDiagonal() * AP);
+        P.prune(0.);
+
+        // 4. Galerkin coarse system Ac = Pt A P
+        Matrix R = P.transpose();
+        AP = Al * P;
+        Matrix Ac = R * AP;
+
+        level.P = std::move(P);
+        level.R = std::move(R);
+
+        p_levels.emplace_back();
+        p_levels.back().A = std::move(Ac);
+
+        // The coarse nodes are the aggregates, with one degree of freedom per near null space vector
+        D = B.cols();
+        B = std::move(Bc);
+        theta *= 0.5;
+    }
+
+    // Smoothers and work vectors
+    for (auto & level : p_levels) {
+        level.inverse_diagonal = level.A.diagonal().unaryExpr([](const Scalar & d) {
+            return (std::abs(d) > EPSILON) ? 1./d : 0.;
+        });
+        level.x.resize(level.A.rows());
+        level.b.resize(level.A.rows());
+        level.r.resize(level.A.rows());
+    }
+
+    // Direct factorization of the coarsest system
+    p_coarse_solver.compute(Eigen::SparseMatrix<Scalar, Eigen::ColMajor>(p_levels.back().A));
+    p_info = p_coarse_solver.info();
+}
+
+namespace {
+/// One Gauss-Seidel sweep on the row major matrix A, in the forward or backward direction
+template <typename Matrix, typename Vector>
+void gauss_seidel(const Matrix & A, const Vector & inverse_diagonal, const Vector & b, Vector & x, bool forward) {
+    const auto n = A.rows();
+    for (Eigen::Index k = 0; k < n; ++k) {
+        const Eigen::Index i = forward ? k : n-1-k;
+        auto sum = b[i];
+        for (typename Matrix::InnerIterator it(A, i); it; ++it) {
+            if (it.col() != i) {
+                sum -= it.value() * x[it.col()];
+            }
+        }
+        x[i] = sum * inverse_diagonal[i];
+    }
+}
+} // namespace
+
+void AMGPreconditioner::vcycle(std::size_t level_index) const {
+    const Level & level = p_levels[level_index];
+
+    // Coarsest level: direct solve
+    if (level_index == p_levels.size() - 1) {
+        level.x = p_coarse_solver.solve(level.b);
+        return;
+    }
+
+    // 1. Pre-smoothing (forward Gauss-Seidel)
+    level.x.setZero();
+    for (Index i = 0; i < p_number_of_smoothing_iterations; ++i) {
+        gauss_seidel(level.A, level.inverse_diagonal, level.b, level.x, true);
+    }
+
+    // 2. Coarse grid correction
+    level.r.noalias() = level.b - level.A * level.x;
+    const Level & coarse_level = p_levels[level_index+1];
+    coarse_level.b.noalias() = level.R * level.r;
+    vcycle(level_index+1);
+    level.x.noalias() += level.P * coarse_level.x;
+
+    // 3. Post-smoothing (backward Gauss-Seidel, which keeps the V-cycle symmetric)
+    for (Index i = 0; i < p_number_of_smoothing_iterations; ++i) {
+        gauss_seidel(level.A, level.inverse_diagonal, level.b, level.x, false);
+    }
+}
+
+void AMGPreconditioner::vcycle(const Vector & b, Vector & x) const {
+    if (p_levels.empty() or b.size() != p_levels.front().A.rows()) {
+        x = b; // The hierarchy wasn't built for this system, act as an identity preconditioner
+        return;
+    }
+
+    p_levels.front().b = b;
+    vcycle(static_cast<std::size_t>(0));
+    x = p_levels.front().x;
+}
+
+} // namespace SofaCaribou::solver
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <SofaCaribou/config.h>
+
+#include <vector>
+
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+#include <Eigen/SparseCholesky>
+
+namespace SofaCaribou::solver {
+
+/**
+ * Smoothed aggregation algebraic multigrid (AMG) preconditioner.
+ *
+ * The hierarchy of coarse systems is built from the system matrix following the smoothed aggregation method of
+ * Vanek, Mandel and Brezina:
+ *   1. The nodes (blocks of dofs_per_node consecutive degrees of freedom) are grouped into aggregates following the
+ *      strength of their coupling in the matrix.
+ *   2. A tentative prolongation operator is built by restricting the near null space (the rigid body modes for
+ *      elasticity) to each aggregate and orthonormalizing it. The coarse near null space is the resulting R factor.
+ *   3. The tentative prolongation is smoothed by one damped Jacobi iteration, and the coarse matrix is computed with
+ *      the Galerkin product Ac = Pt A P.
+ * These steps are repeated until the coarse system is small enough to be factorized by a direct solver.
+ *
+ * The near null space of a 3D elasticity problem (three translations and three rotations) is only known when the
+ * coordinates of the nodes are given with set_coordinates(). Otherwise, only the translations are used.
+ *
+ * The preconditioner is applied with a symmetric V-cycle (forward Gauss-Seidel pre-smoothing and backward
+ * Gauss-Seidel post-smoothing), which can be used by a conjugate gradient. It follows the interface of Eigen's
+ * preconditioners (analyzePattern, factorize, compute, solve and info).
+ */
+class CARIBOU_API AMGPreconditioner {
+public:
+    using Scalar = FLOATING_POINT_TYPE;
+    using Matrix = Eigen::SparseMatrix<Scalar, Eigen::RowMajor>;
+    using Vector = Eigen::Matrix<Scalar, Eigen::Dynamic, 1>;
+    using DenseMatrix = Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>;
+    using Index = Eigen::Index;
+
+    /// A level of the multigrid hierarchy
+    struct Level {
+        Matrix A;            ///< System matrix of the level
+        Vector inverse_diagonal; ///< Inverse of the diagonal of A (zero where the diagonal is null)
+        Matrix P;            ///< Prolongation from the next (coarser) level to this one
+        Matrix R;            ///< Restriction from this level to the next (coarser) one (R = Pt)
+        mutable Vector x, b, r; ///< Work vectors of the V-cycle
+    };
+
+    AMGPreconditioner() = default;
+
+    /**
+     * Set the number of degrees of freedom per node (3 for a 3D elasticity problem). The consecutive degrees of
+     * freedom of a node are aggregated together. Calling this will remove the coordinates previously given.
+     */
+    void set_dofs_per_node(Index dofs_per_node);
+
+    /**
+     * Set the coordinates of the nodes, flattened in a vector (x0, y0, z0, x1, y1, z1, ...), in the same order as
+     * the degrees of freedom of the system matrix. These are used to build the rigid body modes of the near null
+     * space. An empty vector will only use the translation modes.
+     *
+     * @param coordinates The flattened coordinates of the nodes.
+     * @param dofs_per_node Number of degrees of freedom per node (2 or 3 to use the rotation modes).
+     */
+    void set_coordinates(const Vector & coordinates, Index dofs_per_node);
+
+    /** Set the maximum size of the coarsest system, which is factorized by a direct solver (default to 500). */
+    void set_maximum_coarse_size(Index size) { p_maximum_coarse_size = size; }
+
+    /** Set the maximum number of levels of the hierarchy (default to 10). */
+    void set_maximum_number_of_levels(Index n) { p_maximum_number_of_levels = n; }
+
+    /** Set the strength threshold of the aggregation at the finest level (default to 0.08). */
+    void set_strength_threshold(Scalar theta) { p_strength_threshold = theta; }
+
+    /** Set the number of pre and post smoothing iterations (default to 1). */
+    void set_number_of_smoothing_iterations(Index n) { p_number_of_smoothing_iterations = n; }
+
+    /** Nothing is done here, the hierarchy depends on the values of the matrix and is built in factorize(). */
+    template <typename MatrixType>
+    AMGPreconditioner & analyzePattern(const MatrixType &) { return *this; }
+
+    /** Build the multigrid hierarchy from the system matrix. */
+    template <typename MatrixType>
+    AMGPreconditioner & factorize(const MatrixType & A) {
+        build(Matrix(A));
+        return *this;
+    }
+
+    /** Build the multigrid hierarchy from the system matrix. */
+    template <typename MatrixType>
+    AMGPreconditioner & compute(const MatrixType & A) {
+        return factorize(A);
+    }
+
+    /** Apply one V-cycle to approximately solve Ax = b, starting with x = 0. */
+    template <typename Rhs>
+    auto solve(const Eigen::MatrixBase<Rhs> & b) const -> Vector {
+        Vector x;
+        vcycle(Vector(b), x);
+        return x;
+    }
+
+    /** Success if the hierarchy was correctly built. */
+    [[nodiscard]]
+    auto info() const -> Eigen::ComputationInfo { return p_info; }
+
+    /** Get the levels of the hierarchy, from the finest (the system matrix) to the coarsest. */
+    [[nodiscard]]
+    auto levels() const -> const std::vector<Level> & { return p_levels; }
+
+    /** Build the multigrid hierarchy from the system matrix. */
+    void build(const Matrix & A);
+
+    /** Apply one V-cycle to approximately solve Ax = b, starting with x = 0. */
+    void vcycle(const Vector & b, Vector & x) const;
+
+private:
+    /**
+     * Group the nodes of the matrix A into aggregates.
+     * @return The aggregate index of every nodes (-1 for isolated nodes that are not part of the coarse space), and
+     *         the number of aggregates.
+     */
+    auto aggregate(const Matrix & A, Index dofs_per_node, Scalar theta) const -> std::pair<std::vector<Index>, Index>;
+
+    /**
+     * Build the orthonormal tentative prolongation operator from the aggregates and the near null space B.
+     * The coarse near null space is stored in Bc.
+     */
+    auto tentative_prolongation(const std::vector<Index> & aggregates, Index number_of_aggregates,
+                                Index dofs_per_node, const DenseMatrix & B, DenseMatrix & Bc) const -> Matrix;
+
+    /** Build the default near null space (translations, and rotations when the coordinates are known) */
+    auto near_null_space(Index n) const -> DenseMatrix;
+
+    /** Recursive application of the V-cycle on the given level, where the level's b vector is already filled. */
+    void vcycle(std::size_t level) const;
+
+    /// Hierarchy
+    std::vector<Level> p_levels;
+
+    /// Direct solver of the coarsest level
+    Eigen::SimplicialLDLT<Eigen::SparseMatrix<Scalar, Eigen::ColMajor>> p_coarse_solver;
+
+    /// Parameters
+    Index p_dofs_per_node = 1;
+    Vector p_coordinates;
+    Index p_maximum_coarse_size = 500;
+    Index p_maximum_number_of_levels = 10;
+    Scalar p_strength_threshold = 0.08;
+    Index p_number_of_smoothing_iterations = 1;
+
+    Eigen::ComputationInfo p_info = Eigen::Success;
+};
+
+} // namespace SofaCaribou::solver
@@ -0,0 +1,85 @@
+#include <SofaCaribou/Solver/BiCGSTABSolver.h>
+
+DISABLE_ALL_WARNINGS_BEGIN
+#include <sofa/core/ObjectFactory.h>
+#include <sofa/helper/AdvancedTimer.h>
+DISABLE_ALL_WARNINGS_END
+
+namespace SofaCaribou::solver {
+
+using Timer = sofa::helper::AdvancedTimer;
+
+bool BiCGSTABSolver::iterate(const SparseMatrix & A, const Vector & b, Vector & x, FLOATING_POINT_TYPE squared_threshold) const {
+    // Get the method parameters
+    const auto & maximum_number_of_iterations = d_maximum_number_of_iterations.getValue();
+    const auto & verbose = d_verbose.getValue();
+
+    // Declare the method variables
+    const auto n = A.cols();
+    const auto zero = (std::numeric_limits<FLOATING_POINT_TYPE>::min)(); // A numerical floating point zero
+    UNSIGNED_INTEGER_TYPE iteration_number = 0; // Current iteration number
+    FLOATING_POINT_TYPE rho = 1., alpha = 1., omega = 1.;
+    Vector p = Vector::Zero(n), v = Vector::Zero(n); // Search direction and v = A M^-1 p
+    Vector s(n), t(n); // Intermediate residual and t = A M^-1 s
+    Vector p_hat(n), s_hat(n); // Preconditioned vectors M^-1 p and M^-1 s
+
+    // INITIAL RESIDUAL
+    Vector r = b - A*x;
+    Vector r_hat = r; // Shadow residual
+    FLOATING_POINT_TYPE r_norm_2 = r.squaredNorm();
+
+    while (r_norm_2 >= squared_threshold and iteration_number < maximum_number_of_iterations) {
+        Timer::stepBegin("bicgstab_iteration");
+
+        // 1. Restart from the current residual when the shadow residual became orthogonal to it (breakdown)
+        FLOATING_POINT_TYPE rho_new = r_hat.dot(r);
+        if (std::abs(rho_new) < EPSILON*sqrt(r_hat.squaredNorm()*r_norm_2) or std::abs(omega) < zero) {
+            msg_info_when(verbose) << "BiCGSTAB breakdown, restarting the iterations.";
+            r_hat = r;
+            rho_new = r_norm_2;
+            p.setZero();
+            v.setZero();
+            rho = alpha = omega = 1.;
+        }
+
+        // 2. Computes the search direction and its step length
+        const FLOATING_POINT_TYPE beta = (rho_new / rho) * (alpha / omega);
+        p = r + beta*(p - omega*v);
+        precondition(p, p_hat);
+        v.noalias() = A * p_hat;
+        alpha = rho_new / r_hat.dot(v);
+        s = r - alpha*v;
+
+        // 3. Stabilization step
+        const FLOATING_POINT_TYPE s_norm_2 = s.squaredNorm();
+        if (s_norm_2 < squared_threshold) {
+            x += alpha*p_hat;
+            r = s;
+            r_norm_2 = s_norm_2;
+        } else {
+            precondition(s, s_hat);
+            t.noalias() = A * s_hat;
+            const FLOATING_POINT_TYPE t_norm_2 = t.squaredNorm();
+            omega = (t_norm_2 > zero) ? t.dot(s) / t_norm_2 : 0.;
+            x += alpha*p_hat + omega*s_hat;
+            r = s - omega*t;
+            r_norm_2 = r.squaredNorm();
+        }
+        rho = rho_new;
+
+        p_squared_residuals.emplace_back(r_norm_2);
+        ++iteration_number;
+
+        msg_info_when(verbose) << "BiCGSTAB iteration #" << iteration_number
+                               << ": |r|/|b| = " << sqrt(r_norm_2/b.squaredNorm());
+
+        Timer::stepEnd("bicgstab_iteration");
+    }
+
+    return (r_norm_2 < squared_threshold);
+}
+
+static int BiCGSTABSolverClass = sofa::core::RegisterObject("Caribou BiCGSTAB linear solver for non-symmetric systems")
+    .add< BiCGSTABSolver >();
+
+} // namespace SofaCaribou::solver
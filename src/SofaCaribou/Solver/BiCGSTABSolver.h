@@ -0,0 +1,30 @@
+#pragma once
+
+#include <SofaCaribou/config.h>
+#include <SofaCaribou/Solver/KrylovSolver.h>
+
+namespace SofaCaribou::solver {
+
+/**
+ * Biconjugate gradient stabilized (BiCGSTAB) linear solver for general (non-symmetric) sparse systems.
+ *
+ * Each iteration does two matrix-vector products and two preconditioner applications, and only a few vectors are
+ * stored, independently of the number of iterations. The residual norm is not monotonic, and the iterations are
+ * restarted from the current solution if the shadow residual becomes orthogonal to the residual (breakdown).
+ * The preconditioner is applied on the right.
+ */
+class BiCGSTABSolver : public KrylovSolver {
+public:
+    SOFA_CLASS(BiCGSTABSolver, KrylovSolver);
+
+    CARIBOU_API
+    BiCGSTABSolver() = default;
+
+protected:
+    /**
+     * @see KrylovSolver::iterate
+     */
+    bool iterate(const SparseMatrix & A, const Vector & b, Vector & x, FLOATING_POINT_TYPE squared_threshold) const override;
+};
+
+} // namespace SofaCaribou::solver
@@ -0,0 +1,278 @@
+#pragma once
+
+#include <SofaCaribou/config.h>
+
+#include <Eigen/Core>
+#include <Eigen/Sparse>
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace SofaCaribou::solver {
+
+/**
+ * Low-rank modifications of sparse Cholesky factorizations.
+ *
+ * The factor L is stored in the same format as the one of the Eigen simplicial Cholesky solvers (SimplicialLLT and
+ * SimplicialLDLT): a compressed column major matrix, the row indices of every columns being sorted. For a LL^T
+ * factorization, the diagonal coefficient is the first entry of each column. For a LDL^T factorization, the unit
+ * diagonal of L isn't stored, and D is stored in a separate vector.
+ *
+ * A rank-one modification L L^T + sigma w w^T only modifies the columns of L found on the path of the elimination tree
+ * that goes from the first non-zero of w to the root (Davis & Hager, 1999). Its cost is hence proportional to the number
+ * of non-zeros found in these columns, which is usually a very small fraction of the cost of a complete factorization.
+ * The pattern of L is kept as is, which requires the pattern of w to be included in the pattern of the column of L
+ * corresponding to its first non-zero (see fits_in_factor_pattern).
+ */
+template <typename Scalar, typename StorageIndex>
+struct CholeskyUpdate {
+    using SparseMatrix = Eigen::SparseMatrix<Scalar, Eigen::ColMajor, StorageIndex>;
+    using SparseVector = Eigen::SparseVector<Scalar, Eigen::ColMajor, StorageIndex>;
+    using Vector = Eigen::Matrix<Scalar, Eigen::Dynamic, 1>;
+
+    /**
+     * Check that the rank-one modification w w^T can be applied to the factor L without changing its pattern.
+     *
+     * @param L The Cholesky factor
+     * @param unit_diagonal True if the diagonal of L isn't stored (LDL^T factorization)
+     * @param w The sparse vector of the modification
+     */
+    static bool fits_in_factor_pattern(const SparseMatrix & L, bool unit_diagonal, const SparseVector & w) {
+        if (w.nonZeros() == 0) {
+            return true;
+        }
+
+        const StorageIndex * Lp = L.outerIndexPtr();
+        const StorageIndex * Li = L.innerIndexPtr();
+        const StorageIndex * wi = w.innerIndexPtr();
+        const auto f = wi[0];
+
+        // Both the rows of the column f of L and the indices of w are sorted
+        auto p = Lp[f] + (unit_diagonal ? 0 : 1);
+        for (Eigen::Index k = 1; k < w.nonZeros(); ++k) {
+            while (p < Lp[f+1] and Li[p] < wi[k]) {
+                ++p;
+            }
+            if (p == Lp[f+1] or Li[p] != wi[k]) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * Apply the rank-one update (sigma = 1) or downdate (sigma = -1) L L^T + sigma w w^T to the factor of a LL^T (D is
+     * null) or LDL^T factorization.
+     *
+     * @param L The Cholesky factor
+     * @param D The diagonal of a LDL^T factorization, or null for a LL^T factorization
+     * @param w The sparse vector of the modification. Its pattern must fit in the one of L (see fits_in_factor_pattern).
+     * @param sigma 1 for an update, -1 for a downdate
+     * @param work A dense vector of size n filled with zeros. It is filled with zeros on exit.
+     * @return False if a pivot vanished (or became negative for a LL^T factorization), in which case the factor is
+     *         invalid and the matrix must be factorized again.
+     */
+    static bool rank_one_update(SparseMatrix & L, Vector * D, const SparseVector & w, Scalar sigma, Vector & work) {
+        if (w.nonZeros() == 0) {
+            return true;
+        }
+
+        const StorageIndex * Lp = L.outerIndexPtr();
+        const StorageIndex * Li = L.innerIndexPtr();
+        Scalar * Lx = L.valuePtr();
+        const bool unit_diagonal = (D != nullptr);
+
+        // The parent of the column j in the elimination tree is the row of its first off-diagonal non-zero
+        const auto parent = [&] (StorageIndex j) -> StorageIndex {
+            const auto p = Lp[j] + (unit_diagonal ? 0 : 1);
+            return (p < Lp[j+1]) ? Li[p] : StorageIndex(-1);
+        };
+
+        // Scatter w into the work vector
+        for (typename SparseVector::InnerIterator it(w); it; ++it) {
+            work[it.index()] = it.value();
+        }
+
+        const auto f = w.innerIndexPtr()[0];
+        bool ok = true;
+        if (unit_diagonal) {
+            // Gill, Golub, Murray & Saunders (1974), method C1
+            Scalar alpha = sigma;
+            for (auto j = f; j != -1; j = parent(j)) {
+                const Scalar p = work[j];
+                work[j] = 0;
+                const Scalar d = (*D)[j];
+                const Scalar d_bar = d + alpha * p * p;
+                if (d_bar == 0 or not std::isfinite(d_bar)) {
+                    ok = false;
+                    break;
+                }
+                const Scalar beta = p * alpha / d_bar;
+                alpha = alpha * d / d_bar;
+                (*D)[j] = d_bar;
+                for (auto k = Lp[j]; k < Lp[j+1]; ++k) {
+                    work[Li[k]] -= p * Lx[k];
+                    Lx[k] += beta * work[Li[k]];
+                }
+            }
+        } else {
+            // Hyperbolic rotations for the downdate (Davis & Hager, 1999)
+            Scalar beta = 1;
+            for (auto j = f; j != -1; j = parent(j)) {
+                auto k = Lp[j];
+                const Scalar wj = work[j];
+                const Scalar alpha = wj / Lx[k];
+                work[j] = 0;
+                Scalar beta2 = beta * beta + sigma * alpha * alpha;
+                if (beta2 <= 0) {
+                    ok = false;
+                    break;
+                }
+                beta2 = std::sqrt(beta2);
+                const Scalar delta = (sigma > 0) ? (beta / beta2) : (beta2 / beta);
+                const Scalar gamma = sigma * alpha / (beta2 * beta);
+                Lx[k] = delta * Lx[k] + ((sigma > 0) ? (gamma * wj) : Scalar(0));
+                beta = beta2;
+                for (++k; k < Lp[j+1]; ++k) {
+                    const Scalar w1 = work[Li[k]];
+                    const Scalar w2 = w1 - alpha * Lx[k];
+                    work[Li[k]] = w2;
+                    Lx[k] = delta * Lx[k] + gamma * ((sigma > 0) ? w1 : w2);
+                }
+            }
+        }
+
+        if (not ok) {
+            work.setZero();
+        }
+
+        return ok;
+    }
+
+    /**
+     * Apply a list of rank-one updates and downdates to the factor of a LL^T (D is null) or LDL^T factorization.
+     *
+     * The updates are applied first, such that every intermediate matrix remains positive definite as long as the
+     * final one is.
+     *
+     * @return False if the pattern of one of the vectors doesn't fit in the one of L, in which case the factor is left
+     *         untouched, or if a pivot vanished, in which case the factor is invalid.
+     */
+    static bool update(SparseMatrix & L, Vector * D, const std::vector<SparseVector> & updates, const std::vector<SparseVector> & downdates) {
+        const bool unit_diagonal = (D != nullptr);
+        for (const auto * vectors : {&updates, &downdates}) {
+            for (const auto & w : *vectors) {
+                if (w.size() != L.rows() or not fits_in_factor_pattern(L, unit_diagonal, w)) {
+                    return false;
+                }
+            }
+        }
+
+        Vector work = Vector::Zero(L.rows());
+        for (const auto & w : updates) {
+            if (not rank_one_update(L, D, w, 1, work)) {
+                return false;
+            }
+        }
+        for (const auto & w : downdates) {
+            if (not rank_one_update(L, D, w, -1, work)) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * Decompose the symmetric matrix dA into a sum of rank-one modifications sum_k sigma_k w_k w_k^T, sigma_k being 1
+     * (updates) or -1 (downdates).
+     *
+     * Each column j of the lower triangular part of dA is written as the sum e_j c^T + c e_j^T, where c is the column
+     * with its diagonal coefficient halved, which is itself the difference of two rank-one terms:
+     *
+     *     e_j c^T + c e_j^T = 1/(2 a) [(a e_j + c) (a e_j + c)^T - (a e_j - c) (a e_j - c)^T], with a = |c|
+     *
+     * Columns having only a diagonal coefficient give a single rank-one term. The pattern of every vectors w_k is
+     * hence included in the pattern of a column of dA, which always fits in the pattern of the Cholesky factor of a
+     * matrix having the same pattern as dA.
+     *
+     * @param lower_dA The lower triangular part of dA. Only its non-zero coefficients should be stored.
+     * @param updates The vectors w_k of the updates (sigma_k = 1)
+     * @param downdates The vectors w_k of the downdates (sigma_k = -1)
+     */
+    static void decompose(const SparseMatrix & lower_dA, std::vector<SparseVector> & updates, std::vector<SparseVector> & downdates) {
+        updates.clear();
+        downdates.clear();
+
+        const auto n = lower_dA.rows();
+        SparseVector c (n);
+        for (Eigen::Index j = 0; j < lower_dA.outerSize(); ++j) {
+            c = lower_dA.col(j);
+            if (c.nonZeros() == 0) {
+                continue;
+            }
+
+            if (c.nonZeros() == 1 and c.innerIndexPtr()[0] == j) {
+                // Diagonal only
+                const Scalar d = c.valuePtr()[0];
+                SparseVector w (n);
+                w.insert(j) = std::sqrt(std::abs(d));
+                (d > 0 ? updates : downdates).emplace_back(std::move(w));
+                continue;
+            }
+
+            c.coeffRef(j) *= 0.5; // Inserted when the diagonal coefficient is zero, which keeps the indices sorted
+            const Scalar a = c.norm();
+            const Scalar s = 1. / std::sqrt(2 * a);
+
+            SparseVector w_plus = c;
+            SparseVector w_minus = -c;
+            w_plus.coeffRef(j) += a;
+            w_minus.coeffRef(j) += a;
+            updates.emplace_back(s * w_plus);
+            downdates.emplace_back(s * w_minus);
+        }
+    }
+
+    /**
+     * Number of rank-one modifications given by decompose for the difference between two symmetric matrices having
+     * the same pattern, without computing it. Each column of the lower triangular part of the difference counts for two
+     * modifications if one of its off-diagonal coefficients changed, and for one if only its diagonal coefficient did.
+     *
+     * The count stops as soon as it exceeds maximum_rank, in which case maximum_rank+1 is returned.
+     *
+     * @param upper_A The upper triangular part of the first matrix
+     * @param upper_B The upper triangular part of the second matrix, stored with the same pattern as upper_A
+     * @param maximum_rank The rank above which the count stops
+     */
+    static auto rank_of_difference(const SparseMatrix & upper_A, const SparseMatrix & upper_B, std::size_t maximum_rank) -> std::size_t {
+        // Number of modifications of every columns of the lower triangular part (0, 1 or 2)
+        std::vector<unsigned char> column_rank (static_cast<std::size_t>(upper_A.rows()), 0);
+        std::size_t rank = 0;
+        for (Eigen::Index j = 0; j < upper_A.outerSize(); ++j) {
+            typename SparseMatrix::InnerIterator a (upper_A, j);
+            typename SparseMatrix::InnerIterator b (upper_B, j);
+            for (; a and b; ++a, ++b) {
+                if (a.value() == b.value()) {
+                    continue;
+                }
+
+                // The coefficient (i, j) of the upper part is the coefficient (j, i) of the column i of the lower part
+                const auto i = static_cast<std::size_t>(a.row());
+                const unsigned char r = (a.row() == j) ? 1 : 2;
+                if (r > column_rank[i]) {
+                    rank += r - column_rank[i];
+                    column_rank[i] = r;
+                    if (rank > maximum_rank) {
+                        return maximum_rank + 1;
+                    }
+                }
+            }
+        }
+        return rank;
+    }
+};
+
+} // namespace SofaCaribou::solver
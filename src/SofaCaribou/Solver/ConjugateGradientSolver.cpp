@@ -1,7 +1,9 @@
 #include <SofaCaribou/Solver/ConjugateGradientSolver.h>
 #include<SofaCaribou/Algebra/EigenMatrix.h>
+#include <SofaCaribou/Algebra/EigenVector.h>
 #include <SofaCaribou/Visitor/AssembleGlobalMatrix.h>
 #include <SofaCaribou/Visitor/ConstrainGlobalMatrix.h>
+#include <SofaCaribou/Forcefield/DirectProductForcefield.h>
 #include <Caribou/macros.h>
 
 DISABLE_ALL_WARNINGS_BEGIN
@@ -11,10 +13,20 @@ DISABLE_ALL_WARNINGS_BEGIN
 #include <sofa/simulation/VectorOperations.h>
 #include <SofaBaseLinearSolver/FullMatrix.h>
 #include <SofaEigen2Solver/EigenVectorWrapper.h>
+#include <sofa/core/BaseMapping.h>
+#include <sofa/core/behavior/BaseForceField.h>
+#include <sofa/core/behavior/BaseMass.h>
+#include <sofa/core/behavior/BaseMechanicalState.h>
 DISABLE_ALL_WARNINGS_END
 
 #include <iomanip>
 
+#include <Eigen/Dense>
+
+#ifdef CARIBOU_WITH_OPENMP
+#include <omp.h>
+#endif
+
 #if !EIGEN_VERSION_AT_LEAST(3,3,0)
 namespace Eigen {
 using Index = EIGEN_DEFAULT_DENSE_INDEX_TYPE;
@@ -26,6 +38,170 @@ namespace SofaCaribou::solver {
 using Timer = sofa::helper::AdvancedTimer;
 using Algebra::EigenMatrix;
 
+namespace {
+/**
+ * Apply a preconditioner factorized in single precision on vectors of the system's precision (mixed precision CG).
+ */
+template <typename Preconditioner>
+class SinglePrecisionPreconditioner {
+public:
+    using Vector = Eigen::Matrix<FLOATING_POINT_TYPE, Eigen::Dynamic, 1>;
+
+    explicit SinglePrecisionPreconditioner(const Preconditioner & preconditioner) : p_preconditioner(preconditioner) {}
+
+    template <typename Rhs>
+    auto solve(const Eigen::MatrixBase<Rhs> & r) const -> Vector {
+        const Eigen::Matrix<float, Eigen::Dynamic, 1> z = p_preconditioner.solve(r.template cast<float>());
+        return z.template cast<FLOATING_POINT_TYPE>();
+    }
+
+private:
+    const Preconditioner & p_preconditioner;
+};
+
+/**
+ * Computes q = A*p and returns the dot product p.q.
+ *
+ * For a sparse matrix, the product is split by rows among the threads. Since the CG system matrix is selfadjoint,
+ * the column i of the compressed column-major storage is the row i of the matrix, hence each thread writes to its own
+ * entries of q without any synchronization (no transposed copy of the matrix is needed).
+ */
+template <typename Matrix, typename Vector>
+auto product_and_dot(const Matrix & A, const Vector & p, Vector & q, int /*number_of_threads*/) -> FLOATING_POINT_TYPE {
+    q.noalias() = A * p;
+    return p.dot(q);
+}
+
+template <typename Vector>
+auto product_and_dot(const Eigen::SparseMatrix<FLOATING_POINT_TYPE, Eigen::ColMajor> & A, const Vector & p, Vector & q, int number_of_threads) -> FLOATING_POINT_TYPE {
+    if (number_of_threads < 2 or not A.isCompressed()) {
+        q.noalias() = A * p;
+        return p.dot(q);
+    }
+
+    const auto n = A.outerSize();
+    q.resize(n);
+    const auto * outer = A.outerIndexPtr();
+    const auto * inner = A.innerIndexPtr();
+    const auto * values = A.valuePtr();
+    const auto * p_ptr = p.data();
+    auto * q_ptr = q.data();
+
+    FLOATING_POINT_TYPE p_dot_q = 0.;
+    #pragma omp parallel for num_threads(number_of_threads) schedule(static) reduction(+:p_dot_q)
+    for (Eigen::Index i = 0; i < n; ++i) {
+        FLOATING_POINT_TYPE q_i = 0.;
+        for (auto k = outer[i]; k < outer[i+1]; ++k) {
+            q_i += values[k] * p_ptr[inner[k]];
+        }
+        q_ptr[i] = q_i;
+        p_dot_q += p_ptr[i] * q_i;
+    }
+    return p_dot_q;
+}
+
+/**
+ * Computes q = A*p (see product_and_dot for the threaded product of a sparse matrix)
+ */
+template <typename Matrix, typename Vector>
+void product(const Matrix & A, const Vector & p, Vector & q, int /*number_of_threads*/) {
+    q.noalias() = A * p;
+}
+
+template <typename Vector>
+void product(const Eigen::SparseMatrix<FLOATING_POINT_TYPE, Eigen::ColMajor> & A, const Vector & p, Vector & q, int number_of_threads) {
+    if (number_of_threads < 2 or not A.isCompressed()) {
+        q.noalias() = A * p;
+        return;
+    }
+
+    const auto n = A.outerSize();
+    q.resize(n);
+    const auto * outer = A.outerIndexPtr();
+    const auto * inner = A.innerIndexPtr();
+    const auto * values = A.valuePtr();
+    const auto * p_ptr = p.data();
+    auto * q_ptr = q.data();
+
+    #pragma omp parallel for num_threads(number_of_threads) schedule(static)
+    for (Eigen::Index i = 0; i < n; ++i) {
+        FLOATING_POINT_TYPE q_i = 0.;
+        for (auto k = outer[i]; k < outer[i+1]; ++k) {
+            q_i += values[k] * p_ptr[inner[k]];
+        }
+        q_ptr[i] = q_i;
+    }
+}
+
+/**
+ * Computes x = x + alpha*p and r = r - alpha*q in a single pass, and returns the new squared residual norm r.r
+ */
+template <typename Vector>
+auto update_solution_and_residual(FLOATING_POINT_TYPE alpha, const Vector & p, const Vector & q, Vector & x, Vector & r, int number_of_threads) -> FLOATING_POINT_TYPE {
+    if (number_of_threads < 2) {
+        x += alpha * p;
+        r -= alpha * q;
+        return r.squaredNorm();
+    }
+
+    const auto n = r.size();
+    const auto * p_ptr = p.data();
+    const auto * q_ptr = q.data();
+    auto * x_ptr = x.data();
+    auto * r_ptr = r.data();
+
+    FLOATING_POINT_TYPE r_norm_2 = 0.;
+    #pragma omp parallel for num_threads(number_of_threads) schedule(static) reduction(+:r_norm_2)
+    for (Eigen::Index i = 0; i < n; ++i) {
+        x_ptr[i] += alpha * p_ptr[i];
+        r_ptr[i] -= alpha * q_ptr[i];
+        r_norm_2 += r_ptr[i] * r_ptr[i];
+    }
+    return r_norm_2;
+}
+
+/**
+ * Computes the dot product u.v
+ */
+template <typename Vector>
+auto dot(const Vector & u, const Vector & v, int number_of_threads) -> FLOATING_POINT_TYPE {
+    if (number_of_threads < 2) {
+        return u.dot(v);
+    }
+
+    const auto n = u.size();
+    const auto * u_ptr = u.data();
+    const auto * v_ptr = v.data();
+
+    FLOATING_POINT_TYPE u_dot_v = 0.;
+    #pragma omp parallel for num_threads(number_of_threads) schedule(static) reduction(+:u_dot_v)
+    for (Eigen::Index i = 0; i < n; ++i) {
+        u_dot_v += u_ptr[i] * v_ptr[i];
+    }
+    return u_dot_v;
+}
+
+/**
+ * Computes the next search direction p = z + beta*p
+ */
+template <typename Vector>
+void update_search_direction(const Vector & z, FLOATING_POINT_TYPE beta, Vector & p, int number_of_threads) {
+    if (number_of_threads < 2) {
+        p = z + beta*p;
+        return;
+    }
+
+    const auto n = p.size();
+    const auto * z_ptr = z.data();
+    auto * p_ptr = p.data();
+
+    #pragma omp parallel for num_threads(number_of_threads) schedule(static)
+    for (Eigen::Index i = 0; i < n; ++i) {
+        p_ptr[i] = z_ptr[i] + beta * p_ptr[i];
+    }
+}
+} // namespace
+
 ConjugateGradientSolver::ConjugateGradientSolver()
 : d_verbose(initData(&d_verbose,
     false,
@@ -56,8 +232,77 @@ ConjugateGradientSolver::ConjugateGradientSolver()
 #endif
     R"(
             IncompleteLU:        Preconditioning based on the incomplete LU factorization.
+            AlgebraicMultigrid:  Preconditioning based on a smoothed aggregation algebraic multigrid V-cycle.
+            LLT:                 Preconditioning based on the complete LL^T Cholesky factorization.
+            LDLT:                Preconditioning based on the complete LDL^T Cholesky factorization.
+        The LLT and LDLT preconditioners are best used with a preconditioner_update_strategy other than ALWAYS, such
+        that the exact factorization of a previous system matrix is used to precondition the current one.
+    )",
+    true /*displayed_in_GUI*/, false /*read_only_in_GUI*/))
+, d_use_contiguous_vectors(initData(&d_use_contiguous_vectors,
+    false,
+    "use_contiguous_vectors",
+    "When no preconditioning method is used, pack the degrees of freedom into contiguous vectors and compute the "
+    "product Ax directly from the force fields instead of traversing the scene graph at every iterations. This is only "
+    "possible with a single mechanical object, no mechanical mappings and force fields supporting the direct product "
+    "(such as the HyperelasticForcefield). The usual matrix-free method is used otherwise."))
+, d_variant(initData(&d_variant,
+    "variant",
+    R"(
+        Variant of the preconditioned CG iterations (only used with a preconditioning method other than None):
+            CLASSIC:   Classic preconditioned CG, with two separated global reductions per iteration. (default)
+            PIPELINED: Pipelined preconditioned CG (Ghysels & Vanroose). The reductions of an iteration are fused into a
+                       single pass and the preconditioner application and matrix-vector product do not wait for them.
+        The variant is ignored when mixed_precision is enabled, the classic iterations being used instead.
+    )",
+    true /*displayed_in_GUI*/, false /*read_only_in_GUI*/))
+, d_preconditioner_update_strategy(initData(&d_preconditioner_update_strategy,
+    "preconditioner_update_strategy",
+    R"(
+        Define when the preconditioner is factorized again. Factorizing the preconditioner can take more time than the
+        CG iterations themselves, and a slightly outdated preconditioner is often still a good approximation:
+            ALWAYS:             Factorize each time the system matrix is assembled. (default)
+            EVERY_N_ASSEMBLIES: Factorize every N assemblies of the system matrix (for example, every N Newton iterations).
+            EVERY_N_TIME_STEPS: Factorize at the first assembly of the system matrix every N time steps.
+        N is given by the preconditioner_update_interval attribute.
     )",
     true /*displayed_in_GUI*/, false /*read_only_in_GUI*/))
+, d_preconditioner_update_interval(initData(&d_preconditioner_update_interval,
+    (unsigned int) 1,
+    "preconditioner_update_interval",
+    "Number N of assemblies or time steps between two factorizations of the preconditioner (see the "
+    "preconditioner_update_strategy attribute)."))
+, d_preconditioner_update_iterations_threshold(initData(&d_preconditioner_update_iterations_threshold,
+    (unsigned int) 0,
+    "preconditioner_update_iterations_threshold",
+    "When the preconditioner is reused, force its factorization at the next assembly if the last CG solve took more "
+    "iterations than this threshold. Use zero to disable this criterion."))
+, d_deflation_size(initData(&d_deflation_size,
+    (unsigned int) 0,
+    "deflation_size",
+    "Number of approximate eigenvectors (associated to the smallest eigenvalues of the system matrix) recycled from "
+    "one solve to the next in order to deflate them out of the CG iterations. These are extracted from the Lanczos "
+    "coefficients of the previous solves. Only used with a preconditioning method other than None, with the "
+    "CLASSIC variant and without mixed_precision. Use zero to disable the deflation."))
+, d_deflation_harvest_iterations(initData(&d_deflation_harvest_iterations,
+    (unsigned int) 50,
+    "deflation_harvest_iterations",
+    "Number of CG iterations, at the beginning of each solve, from which the Ritz vectors are extracted to update "
+    "the deflation basis. One vector of the size of the system is stored per iteration."))
+, d_mixed_precision(initData(&d_mixed_precision,
+    false,
+    "mixed_precision",
+    "Store a single precision copy of the system matrix and of the preconditioner (Diagonal, IncompleteCholesky and "
+    "IncompleteLU) to speed up the matrix-vector products, while keeping the vectors and the dot products in full "
+    "precision. The products are switched back to the full precision matrix when the residual stagnates. Only used "
+    "with a preconditioning method other than None. The iterations are then always the CLASSIC ones, without "
+    "deflation: the variant and deflation_size attributes are ignored."))
+, d_number_of_threads(initData(&d_number_of_threads,
+    (unsigned int) 1,
+    "number_of_threads",
+    "Number of threads used by the matrix-vector products and the vector operations of the CG iterations when the "
+    "system matrix is assembled (a preconditioning method other than None is used). Use zero to let OpenMP choose "
+    "the number of threads (see the OMP_NUM_THREADS environment variable). Only used when compiled with OpenMP."))
 {
     // Explicitly state the available preconditioning methods
     p_preconditioners.emplace_back("None", PreconditioningMethod::None);
@@ -67,6 +312,9 @@ ConjugateGradientSolver::ConjugateGradientSolver()
     p_preconditioners.emplace_back("IncompleteCholesky", PreconditioningMethod::IncompleteCholesky);
 #endif
     p_preconditioners.emplace_back("IncompleteLU", PreconditioningMethod::IncompleteLU);
+    p_preconditioners.emplace_back("AlgebraicMultigrid", PreconditioningMethod::AlgebraicMultigrid);
+    p_preconditioners.emplace_back("LLT", PreconditioningMethod::LLT);
+    p_preconditioners.emplace_back("LDLT", PreconditioningMethod::LDLT);
 
     // Fill-in the data option group with the available preconditioning methods
     std::vector<std::string> preconditioner_names;
@@ -77,6 +325,54 @@ ConjugateGradientSolver::ConjugateGradientSolver()
     d_preconditioning_method.setValue(sofa::helper::OptionsGroup(preconditioner_names));
     sofa::helper::WriteAccessor<Data< sofa::helper::OptionsGroup >> preconditioning_method = d_preconditioning_method;
     preconditioning_method->setSelectedItem((unsigned int) 1);
+
+    d_variant.setValue(sofa::helper::OptionsGroup(std::vector < std::string > {
+        "CLASSIC", "PIPELINED"
+    }));
+
+    // Select the default value
+    set_variant(Variant::CLASSIC);
+
+    d_preconditioner_update_strategy.setValue(sofa::helper::OptionsGroup(std::vector < std::string > {
+        "ALWAYS", "EVERY_N_ASSEMBLIES", "EVERY_N_TIME_STEPS"
+    }));
+
+    // Select the default value
+    set_preconditioner_update_strategy(PreconditionerUpdateStrategy::ALWAYS);
+}
+
+void ConjugateGradientSolver::init() {
+    const auto preconditioning_method = get_preconditioning_method_from_string(d_preconditioning_method.getValue().getSelectedItem());
+    if (not d_mixed_precision.getValue() or preconditioning_method == PreconditioningMethod::None) {
+        return;
+    }
+
+    // The single precision iterations only implement the classic variant, without deflation
+    if (variant() == Variant::PIPELINED) {
+        msg_warning() << "The PIPELINED variant is not available with mixed_precision, the CLASSIC variant will be used.";
+    }
+
+    if (d_deflation_size.getValue() > 0) {
+        msg_warning() << "The deflation is not available with mixed_precision, deflation_size will be ignored.";
+    }
+}
+
+auto ConjugateGradientSolver::variant() const -> Variant {
+    const auto v = static_cast<Variant>(d_variant.getValue().getSelectedId());
+    switch (v) {
+        case Variant::CLASSIC:
+        case Variant::PIPELINED:
+            return v;
+    }
+
+    // Default value
+    return Variant::CLASSIC;
+}
+
+void ConjugateGradientSolver::set_variant(const Variant & variant) {
+    using namespace sofa::helper;
+    auto variant_option = WriteOnlyAccessor<Data<OptionsGroup>>(d_variant);
+    variant_option->setSelectedItem(static_cast<unsigned int> (variant));
 }
 
 auto ConjugateGradientSolver::get_preconditioning_method_from_string(const std::string & preconditioner_name) const -> PreconditioningMethod{
@@ -101,6 +397,230 @@ auto ConjugateGradientSolver::get_preconditioning_method_from_string(const std::
     return PreconditioningMethod::None;
 }
 
+auto ConjugateGradientSolver::preconditioner_update_strategy() const -> PreconditionerUpdateStrategy {
+    const auto v = static_cast<PreconditionerUpdateStrategy>(d_preconditioner_update_strategy.getValue().getSelectedId());
+    switch (v) {
+        case PreconditionerUpdateStrategy::ALWAYS:
+        case PreconditionerUpdateStrategy::EVERY_N_ASSEMBLIES:
+        case PreconditionerUpdateStrategy::EVERY_N_TIME_STEPS:
+            return v;
+    }
+
+    // Default value
+    return PreconditionerUpdateStrategy::ALWAYS;
+}
+
+void ConjugateGradientSolver::set_preconditioner_update_strategy(const PreconditionerUpdateStrategy & strategy) {
+    using namespace sofa::helper;
+    auto strategy_option = WriteOnlyAccessor<Data<OptionsGroup>>(d_preconditioner_update_strategy);
+    strategy_option->setSelectedItem(static_cast<unsigned int> (strategy));
+}
+
+bool ConjugateGradientSolver::preconditioner_must_be_factorized(const PreconditioningMethod & preconditioning_method, Eigen::Index n) const {
+    // Never factorized for this method and this system size
+    if (preconditioning_method != p_factorized_preconditioning_method or n != p_preconditioner_dimension) {
+        return true;
+    }
+
+    // The last solve took too many iterations with the current preconditioner
+    if (p_preconditioner_needs_refresh) {
+        return true;
+    }
+
+    const auto interval = std::max(d_preconditioner_update_interval.getValue(), 1u);
+    switch (preconditioner_update_strategy()) {
+        case PreconditionerUpdateStrategy::EVERY_N_ASSEMBLIES:
+            return p_number_of_assemblies_since_factorization >= interval;
+        case PreconditionerUpdateStrategy::EVERY_N_TIME_STEPS:
+            return p_number_of_time_steps_since_factorization >= interval;
+        case PreconditionerUpdateStrategy::ALWAYS:
+        default:
+            return true;
+    }
+}
+
+int ConjugateGradientSolver::number_of_threads() const {
+#ifdef CARIBOU_WITH_OPENMP
+    const auto number_of_threads = d_number_of_threads.getValue();
+    if (number_of_threads == 0) {
+        return omp_get_max_threads();
+    }
+    return static_cast<int>(number_of_threads);
+#else
+    return 1;
+#endif
+}
+
+FLOATING_POINT_TYPE ConjugateGradientSolver::effective_residual_tolerance_threshold() const {
+    return std::max(d_residual_tolerance_threshold.getValue(), p_forcing_term);
+}
+
+void ConjugateGradientSolver::update_amg_coordinates(Eigen::Index n) {
+    using Direction = sofa::core::objectmodel::BaseContext::SearchDirection;
+
+    // When the system matrix was assembled by another component (for example, a Caribou ODE solver), the accessor of
+    // this solver was never filled. The offsets of the top-level mechanical objects are computed here in this case.
+    DefaultMultiMatrixAccessor system_accessor;
+    const DefaultMultiMatrixAccessor * accessor = &p_accessor;
+    if (p_accessor.getGlobalDimension() != n) {
+        sofa::simulation::common::MechanicalOperations mops(&p_mechanical_params, this->getContext());
+        mops.getMatrixDimension(nullptr, nullptr, &system_accessor);
+        system_accessor.setupMatrices();
+        accessor = &system_accessor;
+    }
+
+    Vector coordinates = Vector::Zero(n);
+    bool is_3d = true;
+    bool found_a_state = false;
+    for (auto * state : this->getContext()->getObjects<sofa::core::behavior::BaseMechanicalState>(Direction::SearchDown)) {
+        const auto offset = accessor->getGlobalOffset(state);
+        if (offset < 0) {
+            continue; // Mapped mechanical object, not part of the global system
+        }
+
+        if (state->getMatrixSize() != 3*state->getSize() or offset + state->getMatrixSize() > n) {
+            is_3d = false;
+            break;
+        }
+
+        EigenVectorWrapper<FLOATING_POINT_TYPE> wrapper(coordinates);
+        auto o = static_cast<unsigned int>(offset);
+        state->copyToBaseVector(&wrapper, sofa::core::ConstVecCoordId::position(), o);
+        found_a_state = true;
+    }
+
+    if (is_3d and found_a_state) {
+        p_amg.set_coordinates(coordinates, 3);
+    } else {
+        p_amg.set_dofs_per_node(1);
+    }
+}
+
+bool ConjugateGradientSolver::update_preconditioner(const SparseMatrix & A, const PreconditioningMethod & preconditioning_method) {
+    const auto current_dimension = A.rows();
+    const bool single_precision = d_mixed_precision.getValue();
+    bool success = true;
+
+    // The single precision copy of the matrix is needed at every assembly, even if the preconditioner is reused
+    if (single_precision) {
+        Timer::stepBegin("SinglePrecisionCopy");
+        p_A_single = A.cast<float>();
+        Timer::stepEnd("SinglePrecisionCopy");
+    } else {
+        p_A_single.resize(0, 0);
+    }
+
+    // Keep track of the time steps elapsed since the last factorization of the preconditioner
+    const auto current_time = this->getContext()->getTime();
+    if (current_time != p_time_of_last_assembly) {
+        ++p_number_of_time_steps_since_factorization;
+        p_time_of_last_assembly = current_time;
+    }
+
+    // Step 1. Let the preconditioner analyse the matrix when its size or its sparsity pattern changed
+    const auto pattern_fingerprint = SofaCaribou::Algebra::pattern_fingerprint(A);
+    const bool matrix_shape_has_changed = (current_dimension != p_preconditioner_dimension or
+                                           pattern_fingerprint != p_preconditioner_pattern_fingerprint or
+                                           preconditioning_method != p_factorized_preconditioning_method or
+                                           single_precision != p_factorized_in_single_precision);
+    if (matrix_shape_has_changed) {
+        Timer::stepBegin("PreconditionerAnalysis");
+        if (preconditioning_method == PreconditioningMethod::Identity) {
+            p_identity.analyzePattern(A);
+        } else if (preconditioning_method == PreconditioningMethod::Diagonal) {
+            if (single_precision) {
+                p_diag_single.analyzePattern(p_A_single);
+            } else {
+                p_diag.analyzePattern(A);
+            }
+#if EIGEN_VERSION_AT_LEAST(3,3,0)
+        } else if (preconditioning_method == PreconditioningMethod::IncompleteCholesky) {
+            if (single_precision) {
+                p_ichol_single.analyzePattern(p_A_single);
+            } else {
+                p_ichol.analyzePattern(A);
+            }
+#endif
+        } else if (preconditioning_method == PreconditioningMethod::IncompleteLU) {
+            if (single_precision) {
+                p_iLU_single.analyzePattern(p_A_single);
+            } else {
+                p_iLU.analyzePattern(A);
+            }
+        } else if (preconditioning_method == PreconditioningMethod::AlgebraicMultigrid) {
+            p_amg.analyzePattern(A);
+        } else if (preconditioning_method == PreconditioningMethod::LLT) {
+            p_llt.analyzePattern(A);
+        } else if (preconditioning_method == PreconditioningMethod::LDLT) {
+            p_ldlt.analyzePattern(A);
+        }
+        Timer::stepEnd("PreconditionerAnalysis");
+    }
+
+    // Step 2. Factorize the preconditioner, unless the previous factorization can be reused
+    if (matrix_shape_has_changed or preconditioner_must_be_factorized(preconditioning_method, current_dimension)) {
+        Timer::stepBegin("PreconditionerFactorization");
+        if (preconditioning_method == PreconditioningMethod::Identity) {
+            p_identity.factorize(A);
+        } else if (preconditioning_method == PreconditioningMethod::Diagonal) {
+            if (single_precision) {
+                p_diag_single.factorize(p_A_single);
+            } else {
+                p_diag.factorize(A);
+            }
+#if EIGEN_VERSION_AT_LEAST(3,3,0)
+        } else if (preconditioning_method == PreconditioningMethod::IncompleteCholesky) {
+            if (single_precision) {
+                p_ichol_single.factorize(p_A_single);
+                success = (p_ichol_single.info() == Eigen::Success);
+            } else {
+                p_ichol.factorize(A);
+                success = (p_ichol.info() == Eigen::Success);
+            }
+#endif
+        } else if (preconditioning_method == PreconditioningMethod::IncompleteLU) {
+            if (single_precision) {
+                p_iLU_single.factorize(p_A_single);
+                success = (p_iLU_single.info() == Eigen::Success);
+            } else {
+                p_iLU.factorize(A);
+                success = (p_iLU.info() == Eigen::Success);
+            }
+        } else if (preconditioning_method == PreconditioningMethod::AlgebraicMultigrid) {
+            // The hierarchy depends on the values of the matrix, hence it is completely rebuilt here
+            update_amg_coordinates(current_dimension);
+            p_amg.factorize(A);
+            success = (p_amg.info() == Eigen::Success);
+        } else if (preconditioning_method == PreconditioningMethod::LLT) {
+            p_llt.factorize(A);
+            success = (p_llt.info() == Eigen::Success);
+        } else if (preconditioning_method == PreconditioningMethod::LDLT) {
+            p_ldlt.factorize(A);
+            success = (p_ldlt.info() == Eigen::Success);
+        }
+        Timer::stepEnd("PreconditionerFactorization");
+
+        if (not success) {
+            p_factorized_preconditioning_method = PreconditioningMethod::None; // Do not reuse a failed factorization
+            return false;
+        }
+
+        p_factorized_preconditioning_method = preconditioning_method;
+        p_factorized_in_single_precision = single_precision;
+        p_preconditioner_dimension = current_dimension;
+        p_preconditioner_pattern_fingerprint = pattern_fingerprint;
+        p_number_of_assemblies_since_factorization = 1;
+        p_number_of_time_steps_since_factorization = 0;
+        p_preconditioner_needs_refresh = false;
+    } else {
+        ++p_number_of_assemblies_since_factorization;
+        msg_info() << "Reusing the preconditioner factorized " << (p_number_of_assemblies_since_factorization-1)
+                   << " assemblies ago.";
+    }
+
+    return true;
+}
+
 void ConjugateGradientSolver::assemble (const sofa::core::MechanicalParams* mparams) {
     // Step 1. Preparation stage
     //         This stage go down on the sub-graph and gather the top-level mechanical objects (mechanical objects that
@@ -144,7 +664,7 @@ void ConjugateGradientSolver::assemble (const sofa::core::MechanicalParams* mpar
     Timer::stepEnd("AssembleGlobalMatrix");
 
     Timer::stepBegin("ConstrainGlobalMatrix");
-    execute(visitor::ConstrainGlobalMatrix(mparams, &p_accessor));
+    execute(visitor::ConstrainGlobalMatrix(mparams, &p_accessor, &wrapper));
     Timer::stepEnd("ConstrainGlobalMatrix");
 
     // Step 3. Mechanical mappings
@@ -193,44 +713,13 @@ void ConjugateGradientSolver::setSystemMBKMatrix(const sofa::core::MechanicalPar
     // If we have a preconditioning method, the global system matrix has to be constructed from the current context subgraph.
     if (preconditioning_method != PreconditioningMethod::None) {
 
-        auto previous_dimension = p_A.rows();
-
         // Step 1. Assemble the system matrix
         assemble(mparams);
-        auto current_dimension = p_A.rows();
-
-        // Step 2. Let the preconditioner analyse the matrix
-        bool matrix_shape_has_changed = previous_dimension != current_dimension;
-        if (matrix_shape_has_changed) {
-            Timer::stepBegin("PreconditionerAnalysis");
-            if (preconditioning_method == PreconditioningMethod::Identity) {
-                p_identity.analyzePattern(p_A);
-            } else if (preconditioning_method == PreconditioningMethod::Diagonal) {
-                p_diag.analyzePattern(p_A);
-#if EIGEN_VERSION_AT_LEAST(3,3,0)
-            } else if (preconditioning_method == PreconditioningMethod::IncompleteCholesky) {
-                p_ichol.analyzePattern(p_A);
-#endif
-            } else if (preconditioning_method == PreconditioningMethod::IncompleteLU) {
-                p_iLU.analyzePattern(p_A);
-            }
-            Timer::stepEnd("PreconditionerAnalysis");
-        }
 
-        // Step 5. Factorize the preconditioner
-        Timer::stepBegin("PreconditionerFactorization");
-        if (preconditioning_method == PreconditioningMethod::Identity) {
-            p_identity.factorize(p_A);
-        } else if (preconditioning_method == PreconditioningMethod::Diagonal) {
-            p_diag.factorize(p_A);
-#if EIGEN_VERSION_AT_LEAST(3,3,0)
-        } else if (preconditioning_method == PreconditioningMethod::IncompleteCholesky) {
-            p_ichol.factorize(p_A);
-#endif
-        } else if (preconditioning_method == PreconditioningMethod::IncompleteLU) {
-            p_iLU.factorize(p_A);
+        // Step 2. Analyze and factorize the preconditioner
+        if (not update_preconditioner(p_A, preconditioning_method)) {
+            msg_error() << "Failed to factorize the preconditioner of the system matrix";
         }
-        Timer::stepEnd("PreconditionerFactorization");
     }
 
     Timer::stepEnd("ConjugateGradient::ComputeGlobalMatrix");
@@ -291,7 +780,7 @@ void ConjugateGradientSolver::solve(sofa::core::behavior::MultiVecDeriv & b, sof
 
     // Get the method parameters
     const auto & maximum_number_of_iterations = d_maximum_number_of_iterations.getValue();
-    const auto & residual_tolerance_threshold = d_residual_tolerance_threshold.getValue();
+    const auto residual_tolerance_threshold = effective_residual_tolerance_threshold();
     const auto & verbose = d_verbose.getValue();
 
     p_squared_residuals.clear();
@@ -403,11 +892,102 @@ void ConjugateGradientSolver::solve(sofa::core::behavior::MultiVecDeriv & b, sof
     sofa::helper::AdvancedTimer::valSet("nb_iterations", static_cast<float>(iteration_number+1));
 }
 
-template <typename Matrix, typename Preconditioner>
-void ConjugateGradientSolver::solve(const Preconditioner & precond, const Matrix & A, const Vector & b, Vector & x) {
+bool ConjugateGradientSolver::solve_with_contiguous_vectors(sofa::core::behavior::MultiVecDeriv & b, sofa::core::behavior::MultiVecDeriv & x) {
+    using Direction = sofa::core::objectmodel::BaseContext::SearchDirection;
+    auto * context = this->getContext();
+
+    // Get the matrices coefficient m, b and k : A = (mM + bB + kK)
+    const auto  m_coef = p_mechanical_params.mFactor();
+    const auto  b_coef = p_mechanical_params.bFactor();
+
+    // Step 1. Make sure the system can be flattened: a single mechanical object, no mechanical mappings and only
+    //         force fields that can do the product directly on contiguous vectors.
+    const auto mechanical_states = context->getObjects<sofa::core::behavior::BaseMechanicalState>(Direction::SearchDown);
+    if (mechanical_states.size() != 1) {
+        msg_info() << "Contiguous vectors require a single mechanical object, falling back to the graph traversal.";
+        return false;
+    }
+    auto * state = mechanical_states[0];
+
+    for (auto * mapping : context->getObjects<sofa::core::BaseMapping>(Direction::SearchDown)) {
+        if (mapping->isMechanical()) {
+            msg_info() << "Contiguous vectors cannot be used with mechanical mappings, falling back to the graph traversal.";
+            return false;
+        }
+    }
+
+    const bool mass_is_needed = (m_coef != 0 or b_coef != 0);
+    std::vector<forcefield::DirectProductForcefield *> forcefields;
+    for (auto * ff : context->getObjects<sofa::core::behavior::BaseForceField>(Direction::SearchDown)) {
+        auto * direct_ff = dynamic_cast<forcefield::DirectProductForcefield *>(ff);
+        if (direct_ff and direct_ff->direct_product_state() == state) {
+            forcefields.emplace_back(direct_ff);
+        } else if (not mass_is_needed and dynamic_cast<sofa::core::behavior::BaseMass *>(ff)) {
+            continue; // A mass does not contribute to A when m and b are zero
+        } else {
+            msg_info() << "The force field '" << ff->getPathName() << "' does not support the direct product, "
+                       << "falling back to the graph traversal.";
+            return false;
+        }
+    }
+
+    sofa::simulation::common::VectorOperations vop( &p_mechanical_params, context );
+    sofa::simulation::common::MechanicalOperations mop( &p_mechanical_params, context );
+
+    const auto n = static_cast<Eigen::Index>(state->getMatrixSize());
+    Vector X(n), B(n);
+    Vector r(n), p(n), q(n);
+    EigenVectorWrapper<FLOATING_POINT_TYPE> q_wrapper(q);
+    sofa::core::behavior::MultiVecDeriv tmp(&vop);
+    const auto tmp_id = tmp.id().getId(state);
+    unsigned int offset;
+
+    // Step 2. Capture the projective constraints as a diagonal mask by projecting a vector of ones. The mask is
+    //         validated by projecting a random vector, which fails for constraints that are not diagonal (projection
+    //         onto a plane or a line for example).
+    Timer::stepBegin("ConjugateGradient::ConstraintMask");
+    Vector mask = Vector::Ones(n);
+    Vector random = Vector::Random(n);
+    bool mask_is_diagonal = true;
+    for (Vector * v : {&mask, &random}) {
+        q = *v;
+        offset = 0; state->copyFromBaseVector(tmp_id, &q_wrapper, offset);
+        mop.projectResponse(tmp);
+        offset = 0; state->copyToBaseVector(&q_wrapper, tmp_id, offset);
+        if (v == &mask) {
+            mask = q;
+            mask_is_diagonal = ((mask.array() == 0) or (mask.array() == 1)).all();
+        } else {
+            mask_is_diagonal = mask_is_diagonal and q.isApprox(mask.cwiseProduct(random));
+        }
+    }
+    Timer::stepEnd("ConjugateGradient::ConstraintMask");
+
+    if (not mask_is_diagonal) {
+        msg_info() << "The projective constraints cannot be expressed as a diagonal mask, falling back to the graph traversal.";
+        return false;
+    }
+
+    // Step 3. Pack the right-hand side and the initial guess into contiguous vectors
+    {
+        EigenVectorWrapper<FLOATING_POINT_TYPE> b_wrapper(B);
+        EigenVectorWrapper<FLOATING_POINT_TYPE> x_wrapper(X);
+        offset = 0; state->copyToBaseVector(&b_wrapper, b.id().getId(state), offset);
+        offset = 0; state->copyToBaseVector(&x_wrapper, x.id().getId(state), offset);
+    }
+
+    // Computes Av = A v directly from the force fields. The constraint mask isn't applied here, but in the loops that
+    // read Av, where it is fused with the vector updates.
+    const auto product = [&](const Vector & v, Vector & Av) {
+        Av.setZero();
+        for (auto * ff : forcefields) {
+            ff->add_dforce(&p_mechanical_params, v, Av);
+        }
+    };
+
     // Get the method parameters
     const auto & maximum_number_of_iterations = d_maximum_number_of_iterations.getValue();
-    const auto & residual_tolerance_threshold = d_residual_tolerance_threshold.getValue();
+    const auto residual_tolerance_threshold = effective_residual_tolerance_threshold();
     const auto & verbose = d_verbose.getValue();
 
     p_squared_residuals.clear();
@@ -415,22 +995,27 @@ void ConjugateGradientSolver::solve(const Preconditioner & precond, const Matrix
 
     // Declare the method variables
     FLOATING_POINT_TYPE b_norm_2 = 0., r_norm_2 = 0.; // RHS and residual squared norms
-    FLOATING_POINT_TYPE rho0 = 0., rho1 = 0.; // Temporary vectors
+    FLOATING_POINT_TYPE rho0, rho1 = 0.; // Stores r*r as it is used two times per iterations
     FLOATING_POINT_TYPE alpha, beta; // Alpha and Beta coefficients
     FLOATING_POINT_TYPE threshold; // Residual threshold
     UNSIGNED_INTEGER_TYPE iteration_number = 0; // Current iteration number
     bool converged = false;
-    UNSIGNED_INTEGER_TYPE n = A.cols();
-    Vector p(n), z(n); // Search directions
-    Vector r(n), q(n); // Residual
     const auto zero = (std::numeric_limits<FLOATING_POINT_TYPE>::min)(); // A numerical floating point zero
 
+    // Raw pointers used by the fused loops
+    FLOATING_POINT_TYPE * x_ptr = X.data();
+    FLOATING_POINT_TYPE * r_ptr = r.data();
+    FLOATING_POINT_TYPE * p_ptr = p.data();
+    FLOATING_POINT_TYPE * q_ptr = q.data();
+    const FLOATING_POINT_TYPE * b_ptr = B.data();
+    const FLOATING_POINT_TYPE * m_ptr = mask.data();
+
     // Make sure that the right hand side isn't zero
-    b_norm_2 = b.squaredNorm();
+    b_norm_2 = B.squaredNorm();
     p_squared_initial_residual = b_norm_2;
     if (b_norm_2 < EPSILON) {
         msg_info() << "Right-hand side of the system is zero, hence x = 0.";
-        x.setZero();
+        X.setZero();
         goto end; // The goto is important to catch the last timer call before ending the function
     }
 
@@ -438,50 +1023,63 @@ void ConjugateGradientSolver::solve(const Preconditioner & precond, const Matrix
     // threshold = b^2 * residual_tolerance_threshold^2
     threshold = std::max(residual_tolerance_threshold*residual_tolerance_threshold*b_norm_2, zero);
 
-    // INITIAL RESIDUAL
-    r.noalias() = b - A*x;
+    // INITIAL RESIDUAL r = b - mask*(A*x) and its squared norm, computed in the same loop
+    product(X, q);
+    #pragma omp simd reduction(+:r_norm_2)
+    for (Eigen::Index i = 0; i < n; ++i) {
+        r_ptr[i] = b_ptr[i] - m_ptr[i]*q_ptr[i];
+        p_ptr[i] = r_ptr[i]; // p(0) = r(0)
+        r_norm_2 += r_ptr[i]*r_ptr[i];
+    }
 
-    // Check for initial convergence
-    r_norm_2 = r.squaredNorm();
+    // Check for initial convergence: |r0|/|b| < threshold
     if (r_norm_2 < threshold) {
         msg_info() << "The linear system has already reached an equilibrium state";
         msg_info() << "|r|/|b| = " << sqrt(r_norm_2/b_norm_2) << ", threshold = " << residual_tolerance_threshold;
         goto end; // The goto is important to catch the last timer call before ending the function
     }
 
-    // Compute the initial search direction
-    p = precond.solve(r);
-    rho0 = r.dot(p); // |M-1 * r|^2
+    rho0 = r_norm_2;
 
     // ITERATIONS
     while (not converged and iteration_number < maximum_number_of_iterations) {
         Timer::stepBegin("cg_iteration");
-        // 1. Computes q(k+1) = A*p(k)
-        q.noalias() = A * p;
-
-        // 2. Computes x(k+1) and r(k+1)
-        alpha = rho0 / p.dot(q); // the amount we travel on the search direction
-        x += alpha * p; // Updated solution x(k+1)
-        r -= alpha * q; // Updated residual r(k+1)
+        // 1. Computes q(k+1) = mask * (A*p(k)) and p.q in the same loop
+        product(p, q);
+        FLOATING_POINT_TYPE p_dot_q = 0.;
+        #pragma omp simd reduction(+:p_dot_q)
+        for (Eigen::Index i = 0; i < n; ++i) {
+            q_ptr[i] *= m_ptr[i];
+            p_dot_q += p_ptr[i]*q_ptr[i];
+        }
 
-        // 3. Computes the new residual norm
-        r_norm_2 = r.squaredNorm();
+        // 2. Computes x(k+1), r(k+1) and the new residual norm in the same loop
+        alpha = rho0 / p_dot_q;
+        r_norm_2 = 0.;
+        #pragma omp simd reduction(+:r_norm_2)
+        for (Eigen::Index i = 0; i < n; ++i) {
+            x_ptr[i] += alpha*p_ptr[i];
+            r_ptr[i] -= alpha*q_ptr[i];
+            r_norm_2 += r_ptr[i]*r_ptr[i];
+        }
         p_squared_residuals.emplace_back(r_norm_2);
 
-        // 4. Print information on the current iteration
-        msg_info_when(verbose)  << "CG iteration #" << iteration_number+1
-                                << ": |r|/|b| = "   << sqrt(r_norm_2/b_norm_2)
-                                << "(threshold is " << residual_tolerance_threshold << ")";
+        // 3. Print information on the current iteration
+        msg_info_when(verbose) << "CG iteration #" << iteration_number+1
+                               << ": |r|/|b| = "   << sqrt(r_norm_2/b_norm_2)
+                               << "(threshold is " << residual_tolerance_threshold << ")";
 
-        // 5. Check for convergence: |r|/|b| < threshold
+        // 4. Check for convergence: |r|/|b| < threshold
         if (r_norm_2 < threshold) {
             converged = true;
         } else {
-            // 6. Compute the next search direction
-            z = precond.solve(r);  // approximately solve for "A z = r"
-            rho1 = r.dot(z);
+            // 5. Compute the next search direction
+            rho1 = r_norm_2;
             beta = rho1 / rho0;
-            p = z + beta*p;
+            #pragma omp simd
+            for (Eigen::Index i = 0; i < n; ++i) {
+                p_ptr[i] = r_ptr[i] + beta*p_ptr[i];
+            }
 
             rho0 = rho1;
         }
@@ -502,49 +1100,797 @@ void ConjugateGradientSolver::solve(const Preconditioner & precond, const Matrix
     }
 
     end:
+    // Unpack the solution into the mechanical object
+    {
+        EigenVectorWrapper<FLOATING_POINT_TYPE> x_wrapper(X);
+        offset = 0; state->copyFromBaseVector(x.id().getId(state), &x_wrapper, offset);
+    }
     sofa::helper::AdvancedTimer::valSet("nb_iterations", static_cast<float>(iteration_number+1));
+
+    return true;
 }
 
-void ConjugateGradientSolver::solveSystem() {
-    sofa::simulation::common::MechanicalOperations mop( &p_mechanical_params, this->getContext() );
+template <typename Matrix>
+void ConjugateGradientSolver::update_deflation_basis(const Matrix & A) const {
+    const auto k = static_cast<Eigen::Index>(d_deflation_size.getValue());
+    const auto m = static_cast<Eigen::Index>(p_lanczos_alphas.size());
+    const auto n = static_cast<Eigen::Index>(A.cols());
+    if (m == 0 or k == 0) {
+        return;
+    }
 
+    // 1. Tridiagonal matrix of the Lanczos process, obtained from the CG coefficients alpha and beta
+    DenseMatrix T = DenseMatrix::Zero(m, m);
+    for (Eigen::Index j = 0; j < m; ++j) {
+        const auto & alpha_j = p_lanczos_alphas[static_cast<std::size_t>(j)];
+        T(j, j) = 1. / alpha_j;
+        if (j > 0) {
+            T(j, j) += p_lanczos_betas[static_cast<std::size_t>(j-1)] / p_lanczos_alphas[static_cast<std::size_t>(j-1)];
+        }
+        if (j+1 < m and static_cast<std::size_t>(j) < p_lanczos_betas.size()) {
+            T(j, j+1) = T(j+1, j) = -sqrt(p_lanczos_betas[static_cast<std::size_t>(j)]) / alpha_j;
+        }
+    }
 
+    // 2. Ritz vectors associated to the smallest Ritz values (the eigenvalues are sorted in increasing order)
+    const Eigen::SelfAdjointEigenSolver<DenseMatrix> lanczos_eigen_solver (T);
+    const Eigen::Index number_of_ritz_vectors = std::min(k, m);
 
-    // Get the preconditioning method
-    const PreconditioningMethod preconditioning_method = get_preconditioning_method_from_string(d_preconditioning_method.getValue().getSelectedItem());
+    // 3. Rayleigh-Ritz projection of A on the union of the previous basis and the new Ritz vectors, keeping the
+    //    eigenvectors associated to the k smallest eigenvalues.
+    DenseMatrix C (n, p_deflation_basis.cols() + number_of_ritz_vectors);
+    C.leftCols(p_deflation_basis.cols()) = p_deflation_basis;
+    C.rightCols(number_of_ritz_vectors).noalias() =
+        p_lanczos_vectors.leftCols(m) * lanczos_eigen_solver.eigenvectors().leftCols(number_of_ritz_vectors);
 
+    const Eigen::HouseholderQR<DenseMatrix> qr (C);
+    const DenseMatrix Q = qr.householderQ() * DenseMatrix::Identity(n, C.cols());
+    const DenseMatrix AQ = A * Q;
+    const DenseMatrix G = Q.transpose() * AQ;
+    const Eigen::SelfAdjointEigenSolver<DenseMatrix> eigen_solver (0.5*(G + G.transpose()));
 
-    Timer::stepBegin("ConjugateGradient::solve");
-    if (preconditioning_method == PreconditioningMethod::None) {
-        // Gather the x and b vector identifiers
-        sofa::simulation::common::VectorOperations vop( &p_mechanical_params, this->getContext() );
-        MultiVecDeriv x(&vop, p_x_id);
-        MultiVecDeriv b(&vop, p_b_id);
+    p_deflation_basis.noalias() = Q * eigen_solver.eigenvectors().leftCols(std::min(k, C.cols()));
+}
 
-        // Solve without having filled the global matrix A (not needed since no preconditioning)
-        solve(b, x);
-    } else {
-        // Solve using a preconditioning method. Here the global matrix A and the vectors x and b have been built
-        // previously during the calls to setSystemMBKMatrix, setSystemLHVector and setSystemRHVector, respectively.
+template <typename Matrix, typename Preconditioner>
+void ConjugateGradientSolver::solve(const Preconditioner & precond, const Matrix & A, const Vector & b, Vector & x) const {
+    // Get the method parameters
+    const auto & maximum_number_of_iterations = d_maximum_number_of_iterations.getValue();
+    const auto residual_tolerance_threshold = effective_residual_tolerance_threshold();
+    const auto & verbose = d_verbose.getValue();
 
-        if (preconditioning_method == PreconditioningMethod::Identity) {
-            solve(p_identity, p_A, p_b, p_x);
-        } else if (preconditioning_method == PreconditioningMethod::Diagonal) {
-            solve(p_diag, p_A, p_b, p_x);
-#if EIGEN_VERSION_AT_LEAST(3,3,0)
-        } else if (preconditioning_method == PreconditioningMethod::IncompleteCholesky) {
-            solve(p_ichol, p_A, p_b, p_x);
-#endif
-        } else if (preconditioning_method == PreconditioningMethod::IncompleteLU) {
-            solve(p_iLU, p_A, p_b, p_x);
-        }
+    p_squared_residuals.clear();
+    p_squared_residuals.reserve(maximum_number_of_iterations);
 
-        // Copy the solution into the mechanical objects of the current context sub-graph.
-        EigenVectorWrapper<FLOATING_POINT_TYPE> x_wrapper(p_x);
-        mop.baseVector2MultiVector(&x_wrapper, p_x_id, &p_accessor);
-    }
+    // Declare the method variables
+    FLOATING_POINT_TYPE b_norm_2 = 0., r_norm_2 = 0.; // RHS and residual squared norms
+    FLOATING_POINT_TYPE rho0 = 0., rho1 = 0.; // Temporary vectors
+    FLOATING_POINT_TYPE alpha, beta; // Alpha and Beta coefficients
+    FLOATING_POINT_TYPE threshold; // Residual threshold
+    UNSIGNED_INTEGER_TYPE iteration_number = 0; // Current iteration number
+    bool converged = false;
+    UNSIGNED_INTEGER_TYPE n = A.cols();
+    Vector p(n), z(n); // Search directions
+    Vector r(n), q(n); // Residual
+    const auto zero = (std::numeric_limits<FLOATING_POINT_TYPE>::min)(); // A numerical floating point zero
+    const auto threads = number_of_threads();
+
+    // Deflation (recycling of the Krylov subspace of the previous solves)
+    const auto & deflation_size = d_deflation_size.getValue();
+    const auto harvest_iterations = (deflation_size > 0) ? std::max(d_deflation_harvest_iterations.getValue(), deflation_size) : 0u;
+    if (p_deflation_basis.rows() != static_cast<Eigen::Index>(n)) {
+        p_deflation_basis.resize(static_cast<Eigen::Index>(n), 0); // The system size changed, the basis is useless
+    }
+    bool deflate = (deflation_size > 0 and p_deflation_basis.cols() > 0);
+    DenseMatrix AW; // A*W where W is the deflation basis
+    Eigen::LDLT<DenseMatrix> WtAW; // Factorization of the small k x k matrix Wt A W
+    if (deflate) {
+        AW.noalias() = A * p_deflation_basis;
+        WtAW.compute(p_deflation_basis.transpose() * AW);
+        if (WtAW.info() != Eigen::Success or not WtAW.isPositive()) {
+            msg_warning() << "The deflation basis is degenerated and will be discarded.";
+            p_deflation_basis.resize(static_cast<Eigen::Index>(n), 0);
+            deflate = false;
+        }
+    }
+    p_lanczos_alphas.clear();
+    p_lanczos_betas.clear();
+    p_lanczos_vectors.resize(static_cast<Eigen::Index>(n), static_cast<Eigen::Index>(harvest_iterations));
+
+    // Make sure that the right hand side isn't zero
+    b_norm_2 = b.squaredNorm();
+    p_squared_initial_residual = b_norm_2;
+    if (b_norm_2 < EPSILON) {
+        msg_info() << "Right-hand side of the system is zero, hence x = 0.";
+        x.setZero();
+        goto end; // The goto is important to catch the last timer call before ending the function
+    }
+
+    // Compute the tolerance w.r.t |b| since |r|/|b| < threshold is equivalent to  r^2 < b^2 * threshold^2
+    // threshold = b^2 * residual_tolerance_threshold^2
+    threshold = std::max(residual_tolerance_threshold*residual_tolerance_threshold*b_norm_2, zero);
+
+    // INITIAL RESIDUAL
+    r.noalias() = b - A*x;
+
+    // With deflation, first solve the system in the deflation subspace: x = x + W (Wt A W)^-1 Wt r
+    if (deflate) {
+        const Vector mu = WtAW.solve(p_deflation_basis.transpose() * r);
+        x.noalias() += p_deflation_basis * mu;
+        r.noalias() -= AW * mu;
+    }
+
+    // Check for initial convergence
+    r_norm_2 = r.squaredNorm();
+    if (r_norm_2 < threshold) {
+        msg_info() << "The linear system has already reached an equilibrium state";
+        msg_info() << "|r|/|b| = " << sqrt(r_norm_2/b_norm_2) << ", threshold = " << residual_tolerance_threshold;
+        goto end; // The goto is important to catch the last timer call before ending the function
+    }
+
+    // Compute the initial search direction
+    z = precond.solve(r);
+    rho0 = r.dot(z); // |M-1 * r|^2
+    p = z;
+    if (deflate) {
+        // Keep the search direction A-orthogonal to the deflation subspace
+        p.noalias() -= p_deflation_basis * WtAW.solve(AW.transpose() * z);
+    }
+
+    // ITERATIONS
+    while (not converged and iteration_number < maximum_number_of_iterations) {
+        Timer::stepBegin("cg_iteration");
+        // 1. Computes q(k+1) = A*p(k) and p.q in the same pass
+        const FLOATING_POINT_TYPE p_dot_q = product_and_dot(A, p, q, threads);
+
+        // Keep the Lanczos vector of the iteration to extract the Ritz vectors at the end of the solve
+        if (iteration_number < harvest_iterations) {
+            p_lanczos_vectors.col(static_cast<Eigen::Index>(iteration_number)) = z / sqrt(rho0);
+        }
+
+        // 2. Computes x(k+1), r(k+1) and the new residual norm in the same pass
+        alpha = rho0 / p_dot_q; // the amount we travel on the search direction
+        if (iteration_number < harvest_iterations) {
+            p_lanczos_alphas.emplace_back(alpha);
+        }
+        r_norm_2 = update_solution_and_residual(alpha, p, q, x, r, threads);
+        p_squared_residuals.emplace_back(r_norm_2);
+
+        // 4. Print information on the current iteration
+        msg_info_when(verbose)  << "CG iteration #" << iteration_number+1
+                                << ": |r|/|b| = "   << sqrt(r_norm_2/b_norm_2)
+                                << "(threshold is " << residual_tolerance_threshold << ")";
+
+        // 5. Check for convergence: |r|/|b| < threshold
+        if (r_norm_2 < threshold) {
+            converged = true;
+        } else {
+            // 6. Compute the next search direction
+            z = precond.solve(r);  // approximately solve for "A z = r"
+            rho1 = dot(r, z, threads);
+            beta = rho1 / rho0;
+            update_search_direction(z, beta, p, threads);
+            if (deflate) {
+                p.noalias() -= p_deflation_basis * WtAW.solve(AW.transpose() * z);
+            }
+            if (iteration_number < harvest_iterations) {
+                p_lanczos_betas.emplace_back(beta);
+            }
+
+            rho0 = rho1;
+        }
+
+        ++iteration_number;
+        Timer::stepEnd("cg_iteration");
+    }
+
+    iteration_number--; // Reset to the actual index of the last iteration completed
+
+    if (converged) {
+        msg_info() << "CG converged in " << (iteration_number+1)
+                   << " iterations with a residual of |r|/|b| = " << sqrt(r_norm_2/b_norm_2)
+                   << " (threshold was " << residual_tolerance_threshold << ")";
+    } else {
+        msg_info() << "CG diverged with a residual of |r|/|b| = " << sqrt(r_norm_2/b_norm_2)
+                   << " (threshold was " << residual_tolerance_threshold << ")";
+    }
+
+    // Update the deflation basis with the Ritz vectors of this solve
+    if (deflation_size > 0) {
+        Timer::stepBegin("UpdateDeflationBasis");
+        update_deflation_basis(A);
+        Timer::stepEnd("UpdateDeflationBasis");
+    }
+
+    end:
+    sofa::helper::AdvancedTimer::valSet("nb_iterations", static_cast<float>(iteration_number+1));
+}
+
+template <typename Matrix, typename Preconditioner>
+void ConjugateGradientSolver::solve_block(const Preconditioner & precond, const Matrix & A, const DenseMatrix & B, DenseMatrix & X) const {
+    // Get the method parameters
+    const auto & maximum_number_of_iterations = d_maximum_number_of_iterations.getValue();
+    const auto residual_tolerance_threshold = effective_residual_tolerance_threshold();
+    const auto & verbose = d_verbose.getValue();
+
+    p_squared_residuals.clear();
+    p_squared_residuals.reserve(maximum_number_of_iterations);
+
+    // Declare the method variables
+    const auto n = A.cols();
+    const auto number_of_rhs = B.cols();
+    const auto zero = (std::numeric_limits<FLOATING_POINT_TYPE>::min)(); // A numerical floating point zero
+    UNSIGNED_INTEGER_TYPE iteration_number = 0; // Current iteration number
+    Vector thresholds(number_of_rhs); // Squared residual threshold of every right-hand sides
+    std::vector<Eigen::Index> active; // Indices of the right-hand sides that did not converged yet
+    DenseMatrix R(n, number_of_rhs); // Residuals
+    DenseMatrix P, Q, Z, PtQ_solve_rhs; // Search directions P, Q = AP and preconditioned residuals Z
+    Eigen::CompleteOrthogonalDecomposition<DenseMatrix> PtQ; // Decomposition of the small s x s matrix PtAP
+
+    // Remove the right-hand sides that converged from the active set
+    const auto update_active_set = [&R, &thresholds, &active] () {
+        std::vector<Eigen::Index> still_active;
+        still_active.reserve(active.size());
+        for (const auto & j : active) {
+            if (R.col(j).squaredNorm() >= thresholds[j]) {
+                still_active.emplace_back(j);
+            }
+        }
+        active = std::move(still_active);
+    };
+
+    // Apply the preconditioner on the residuals of the active right-hand sides
+    const auto precondition = [&precond, &R, &Z, &active, n] () {
+        Z.resize(n, static_cast<Eigen::Index>(active.size()));
+        for (std::size_t i = 0; i < active.size(); ++i) {
+            Z.col(static_cast<Eigen::Index>(i)) = precond.solve(R.col(active[i]));
+        }
+    };
+
+    // Compute the tolerance w.r.t |b| of every right-hand sides, and directly set x = 0 when b = 0
+    p_squared_initial_residual = B.squaredNorm();
+    active.reserve(static_cast<std::size_t>(number_of_rhs));
+    for (Eigen::Index j = 0; j < number_of_rhs; ++j) {
+        const FLOATING_POINT_TYPE b_norm_2 = B.col(j).squaredNorm();
+        thresholds[j] = std::max(residual_tolerance_threshold*residual_tolerance_threshold*b_norm_2, zero);
+        if (b_norm_2 < EPSILON) {
+            X.col(j).setZero();
+        } else {
+            active.emplace_back(j);
+        }
+    }
+
+    // INITIAL RESIDUALS
+    R.noalias() = B - A*X;
+    update_active_set();
+    if (active.empty()) {
+        msg_info() << "The linear systems have already reached an equilibrium state";
+        return;
+    }
+
+    // Compute the initial search directions
+    precondition();
+    P = Z;
+
+    // ITERATIONS
+    while (not active.empty() and iteration_number < maximum_number_of_iterations) {
+        Timer::stepBegin("cg_iteration");
+        // 1. Computes Q(k+1) = A*P(k) in a single pass over the matrix
+        Q.noalias() = A * P;
+
+        // 2. Computes X(k+1) and R(k+1)
+        PtQ.compute(P.transpose() * Q);
+        PtQ_solve_rhs.resize(P.cols(), static_cast<Eigen::Index>(active.size()));
+        for (std::size_t i = 0; i < active.size(); ++i) {
+            PtQ_solve_rhs.col(static_cast<Eigen::Index>(i)).noalias() = P.transpose() * R.col(active[i]);
+        }
+        const DenseMatrix alpha = PtQ.solve(PtQ_solve_rhs); // the amount we travel on the search directions
+        for (std::size_t i = 0; i < active.size(); ++i) {
+            X.col(active[i]).noalias() += P * alpha.col(static_cast<Eigen::Index>(i)); // Updated solution X(k+1)
+            R.col(active[i]).noalias() -= Q * alpha.col(static_cast<Eigen::Index>(i)); // Updated residual R(k+1)
+        }
+
+        // 3. Computes the new residual norm
+        p_squared_residuals.emplace_back(R.squaredNorm());
+
+        // 4. Check for convergence of every right-hand sides: |r|/|b| < threshold
+        update_active_set();
+
+        // 5. Print information on the current iteration
+        msg_info_when(verbose)  << "Block CG iteration #" << iteration_number+1
+                                << ": |R|/|B| = "   << sqrt(p_squared_residuals.back()/p_squared_initial_residual)
+                                << ", " << active.size() << " right-hand sides remaining";
+
+        if (not active.empty()) {
+            // 6. Compute the next search directions, A-conjugate to the current ones
+            precondition();
+            const DenseMatrix beta = PtQ.solve(Q.transpose() * Z);
+            P = Z - P*beta;
+        }
+
+        ++iteration_number;
+        Timer::stepEnd("cg_iteration");
+    }
+
+    if (active.empty()) {
+        msg_info() << "Block CG converged in " << iteration_number << " iterations for " << number_of_rhs
+                   << " right-hand sides (threshold was " << residual_tolerance_threshold << ")";
+    } else {
+        msg_info() << "Block CG diverged with " << active.size() << " right-hand sides not converged over "
+                   << number_of_rhs << " (threshold was " << residual_tolerance_threshold << ")";
+    }
+
+    sofa::helper::AdvancedTimer::valSet("nb_iterations", static_cast<float>(iteration_number));
+}
+
+template <typename Matrix, typename Preconditioner>
+void ConjugateGradientSolver::solve_pipelined(const Preconditioner & precond, const Matrix & A, const Vector & b, Vector & x) const {
+    // Get the method parameters
+    const auto & maximum_number_of_iterations = d_maximum_number_of_iterations.getValue();
+    const auto residual_tolerance_threshold = effective_residual_tolerance_threshold();
+    const auto & verbose = d_verbose.getValue();
+
+    p_squared_residuals.clear();
+    p_squared_residuals.reserve(maximum_number_of_iterations);
+
+    // Declare the method variables
+    FLOATING_POINT_TYPE b_norm_2 = 0., r_norm_2 = 0.; // RHS and residual squared norms
+    FLOATING_POINT_TYPE gamma = 0., gamma_previous = 0.; // (r.u) of the current and previous iterations
+    FLOATING_POINT_TYPE delta = 0.; // (w.u)
+    FLOATING_POINT_TYPE alpha = 0., alpha_previous = 0., beta = 0.; // Alpha and Beta coefficients
+    FLOATING_POINT_TYPE threshold; // Residual threshold
+    UNSIGNED_INTEGER_TYPE iteration_number = 0; // Current iteration number
+    bool converged = false;
+    const auto size = static_cast<Eigen::Index>(A.cols());
+    Vector r(size), u(size), w(size); // Residual, preconditioned residual and w = A*u
+    Vector m(size), Am(size); // m = M^-1 w and Am = A*m
+    Vector p = Vector::Zero(size), s = Vector::Zero(size); // Search direction and s = A*p
+    Vector q = Vector::Zero(size), z = Vector::Zero(size); // q = M^-1 s and z = A*q
+    const auto zero = (std::numeric_limits<FLOATING_POINT_TYPE>::min)(); // A numerical floating point zero
+    const auto threads = number_of_threads();
+
+    // Make sure that the right hand side isn't zero
+    b_norm_2 = b.squaredNorm();
+    p_squared_initial_residual = b_norm_2;
+    if (b_norm_2 < EPSILON) {
+        msg_info() << "Right-hand side of the system is zero, hence x = 0.";
+        x.setZero();
+        goto end; // The goto is important to catch the last timer call before ending the function
+    }
+
+    // Compute the tolerance w.r.t |b| since |r|/|b| < threshold is equivalent to  r^2 < b^2 * threshold^2
+    // threshold = b^2 * residual_tolerance_threshold^2
+    threshold = std::max(residual_tolerance_threshold*residual_tolerance_threshold*b_norm_2, zero);
+
+    // INITIAL RESIDUAL
+    r.noalias() = b - A*x;
+    u = precond.solve(r);
+    w.noalias() = A*u;
+
+    r_norm_2 = r.squaredNorm();
+    gamma = r.dot(u);
+    delta = w.dot(u);
+
+    // Check for initial convergence
+    if (r_norm_2 < threshold) {
+        msg_info() << "The linear system has already reached an equilibrium state";
+        msg_info() << "|r|/|b| = " << sqrt(r_norm_2/b_norm_2) << ", threshold = " << residual_tolerance_threshold;
+        goto end; // The goto is important to catch the last timer call before ending the function
+    }
+
+    // ITERATIONS
+    while (not converged and iteration_number < maximum_number_of_iterations) {
+        Timer::stepBegin("cg_iteration");
+        // 1. Computes m = M^-1 w and Am = A*m. Unlike the classic variant, these do not depend on the reductions
+        //    of the current iteration (they were computed at the end of the previous one).
+        m = precond.solve(w);
+        product(A, m, Am, threads);
+
+        // 2. Computes the step lengths from the fused reductions
+        if (iteration_number > 0) {
+            beta = gamma / gamma_previous;
+            alpha = gamma / (delta - beta * gamma / alpha_previous);
+        } else {
+            beta = 0.;
+            alpha = gamma / delta;
+        }
+        gamma_previous = gamma;
+        alpha_previous = alpha;
+
+        // 3. Updates every vectors and computes the reductions (r.u), (w.u) and (r.r) of the next iteration in a
+        //    single pass, which is the only synchronization point of the iteration.
+        gamma = 0.; delta = 0.; r_norm_2 = 0.;
+        {
+            FLOATING_POINT_TYPE * x_ptr = x.data();
+            FLOATING_POINT_TYPE * r_ptr = r.data();
+            FLOATING_POINT_TYPE * u_ptr = u.data();
+            FLOATING_POINT_TYPE * w_ptr = w.data();
+            FLOATING_POINT_TYPE * p_ptr = p.data();
+            FLOATING_POINT_TYPE * s_ptr = s.data();
+            FLOATING_POINT_TYPE * q_ptr = q.data();
+            FLOATING_POINT_TYPE * z_ptr = z.data();
+            const FLOATING_POINT_TYPE * m_ptr = m.data();
+            const FLOATING_POINT_TYPE * Am_ptr = Am.data();
+
+            #pragma omp parallel for num_threads(threads) reduction(+:gamma,delta,r_norm_2)
+            for (Eigen::Index i = 0; i < size; ++i) {
+                z_ptr[i] = Am_ptr[i] + beta*z_ptr[i]; // z = A*q
+                q_ptr[i] = m_ptr[i]  + beta*q_ptr[i]; // q = M^-1 s
+                s_ptr[i] = w_ptr[i]  + beta*s_ptr[i]; // s = A*p
+                p_ptr[i] = u_ptr[i]  + beta*p_ptr[i]; // Search direction
+                x_ptr[i] += alpha*p_ptr[i]; // Updated solution x(k+1)
+                r_ptr[i] -= alpha*s_ptr[i]; // Updated residual r(k+1)
+                u_ptr[i] -= alpha*q_ptr[i]; // Updated preconditioned residual u(k+1) = M^-1 r(k+1)
+                w_ptr[i] -= alpha*z_ptr[i]; // Updated w(k+1) = A*u(k+1)
+                gamma    += r_ptr[i]*u_ptr[i];
+                delta    += w_ptr[i]*u_ptr[i];
+                r_norm_2 += r_ptr[i]*r_ptr[i];
+            }
+        }
+        p_squared_residuals.emplace_back(r_norm_2);
+
+        // 4. Print information on the current iteration
+        msg_info_when(verbose)  << "CG iteration #" << iteration_number+1
+                                << ": |r|/|b| = "   << sqrt(r_norm_2/b_norm_2)
+                                << "(threshold is " << residual_tolerance_threshold << ")";
+
+        // 5. Check for convergence: |r|/|b| < threshold
+        if (r_norm_2 < threshold) {
+            converged = true;
+        }
+
+        ++iteration_number;
+        Timer::stepEnd("cg_iteration");
+    }
+
+    iteration_number--; // Reset to the actual index of the last iteration completed
+
+    if (converged) {
+        msg_info() << "CG converged in " << (iteration_number+1)
+                   << " iterations with a residual of |r|/|b| = " << sqrt(r_norm_2/b_norm_2)
+                   << " (threshold was " << residual_tolerance_threshold << ")";
+    } else {
+        msg_info() << "CG diverged with a residual of |r|/|b| = " << sqrt(r_norm_2/b_norm_2)
+                   << " (threshold was " << residual_tolerance_threshold << ")";
+    }
+
+    end:
+    sofa::helper::AdvancedTimer::valSet("nb_iterations", static_cast<float>(iteration_number+1));
+}
+
+template <typename Preconditioner>
+void ConjugateGradientSolver::solve_mixed_precision(const Preconditioner & precond, const SinglePrecisionSparseMatrix & A_single,
+                                                    const SparseMatrix & A, const Vector & b, Vector & x) const {
+    // Get the method parameters
+    const auto & maximum_number_of_iterations = d_maximum_number_of_iterations.getValue();
+    const auto residual_tolerance_threshold = effective_residual_tolerance_threshold();
+    const auto & verbose = d_verbose.getValue();
+
+    // Number of iterations between two verifications of the true residual b - Ax
+    constexpr UNSIGNED_INTEGER_TYPE true_residual_check_interval = 25;
+
+    p_squared_residuals.clear();
+    p_squared_residuals.reserve(maximum_number_of_iterations);
+
+    // Declare the method variables
+    FLOATING_POINT_TYPE b_norm_2 = 0., r_norm_2 = 0., true_r_norm_2 = 0.; // RHS and residual squared norms
+    FLOATING_POINT_TYPE rho0 = 0., rho1 = 0.; // Temporary vectors
+    FLOATING_POINT_TYPE alpha, beta; // Alpha and Beta coefficients
+    FLOATING_POINT_TYPE threshold; // Residual threshold
+    UNSIGNED_INTEGER_TYPE iteration_number = 0; // Current iteration number
+    bool converged = false;
+    bool single_precision_products = true; // Switched to false when the residual stagnates
+    UNSIGNED_INTEGER_TYPE n = A.cols();
+    Vector p(n), z(n); // Search directions
+    Vector r(n), q(n), true_r(n); // Residual
+    const auto zero = (std::numeric_limits<FLOATING_POINT_TYPE>::min)(); // A numerical floating point zero
+
+    // Make sure that the right hand side isn't zero
+    b_norm_2 = b.squaredNorm();
+    p_squared_initial_residual = b_norm_2;
+    if (b_norm_2 < EPSILON) {
+        msg_info() << "Right-hand side of the system is zero, hence x = 0.";
+        x.setZero();
+        goto end; // The goto is important to catch the last timer call before ending the function
+    }
+
+    // Compute the tolerance w.r.t |b| since |r|/|b| < threshold is equivalent to  r^2 < b^2 * threshold^2
+    // threshold = b^2 * residual_tolerance_threshold^2
+    threshold = std::max(residual_tolerance_threshold*residual_tolerance_threshold*b_norm_2, zero);
+
+    // INITIAL RESIDUAL (always in full precision)
+    r.noalias() = b - A*x;
+
+    // Check for initial convergence
+    r_norm_2 = r.squaredNorm();
+    if (r_norm_2 < threshold) {
+        msg_info() << "The linear system has already reached an equilibrium state";
+        msg_info() << "|r|/|b| = " << sqrt(r_norm_2/b_norm_2) << ", threshold = " << residual_tolerance_threshold;
+        goto end; // The goto is important to catch the last timer call before ending the function
+    }
+
+    // Compute the initial search direction
+    z = precond.solve(r);
+    rho0 = r.dot(z); // |M-1 * r|^2
+    p = z;
+
+    // ITERATIONS
+    while (not converged and iteration_number < maximum_number_of_iterations) {
+        Timer::stepBegin("cg_iteration");
+        // 1. Computes q(k+1) = A*p(k), reading the single precision values of A if the residual didn't stagnate yet
+        if (single_precision_products) {
+            q.noalias() = A_single.cast<FLOATING_POINT_TYPE>() * p;
+        } else {
+            q.noalias() = A * p;
+        }
+
+        // 2. Computes x(k+1) and r(k+1)
+        alpha = rho0 / p.dot(q); // the amount we travel on the search direction
+        x += alpha * p; // Updated solution x(k+1)
+        r -= alpha * q; // Updated residual r(k+1)
+
+        // 3. Computes the new residual norm
+        r_norm_2 = r.squaredNorm();
+        ++iteration_number;
+
+        // 4. Verify the true residual, since the recurrence only gives the residual of the single precision system
+        if (single_precision_products and (r_norm_2 < threshold or iteration_number % true_residual_check_interval == 0)) {
+            true_r.noalias() = b - A*x;
+            true_r_norm_2 = true_r.squaredNorm();
+            if (true_r_norm_2 > 4*r_norm_2 or (r_norm_2 < threshold and true_r_norm_2 >= threshold)) {
+                // The residual stagnates: restart the iterations from the current solution with full precision products
+                msg_info() << "The residual stagnates with single precision products (|r|/|b| = "
+                           << sqrt(true_r_norm_2/b_norm_2) << " at iteration #" << iteration_number
+                           << "), switching to full precision.";
+                single_precision_products = false;
+                r = true_r;
+                r_norm_2 = true_r_norm_2;
+                p_squared_residuals.emplace_back(r_norm_2);
+                if (r_norm_2 < threshold) {
+                    converged = true;
+                } else {
+                    z = precond.solve(r);
+                    rho0 = r.dot(z);
+                    p = z;
+                }
+                Timer::stepEnd("cg_iteration");
+                continue;
+            }
+        }
+        p_squared_residuals.emplace_back(r_norm_2);
+
+        // 5. Print information on the current iteration
+        msg_info_when(verbose)  << "CG iteration #" << iteration_number
+                                << ": |r|/|b| = "   << sqrt(r_norm_2/b_norm_2)
+                                << "(threshold is " << residual_tolerance_threshold << ")";
+
+        // 6. Check for convergence: |r|/|b| < threshold
+        if (r_norm_2 < threshold) {
+            converged = true;
+        } else {
+            // 7. Compute the next search direction
+            z = precond.solve(r);  // approximately solve for "A z = r"
+            rho1 = r.dot(z);
+            beta = rho1 / rho0;
+            p = z + beta*p;
+
+            rho0 = rho1;
+        }
+
+        Timer::stepEnd("cg_iteration");
+    }
+
+    iteration_number--; // Reset to the actual index of the last iteration completed
+
+    if (converged) {
+        msg_info() << "CG converged in " << (iteration_number+1)
+                   << " iterations with a residual of |r|/|b| = " << sqrt(r_norm_2/b_norm_2)
+                   << " (threshold was " << residual_tolerance_threshold << ")";
+    } else {
+        msg_info() << "CG diverged with a residual of |r|/|b| = " << sqrt(r_norm_2/b_norm_2)
+                   << " (threshold was " << residual_tolerance_threshold << ")";
+    }
+
+    end:
+    sofa::helper::AdvancedTimer::valSet("nb_iterations", static_cast<float>(iteration_number+1));
+}
+
+void ConjugateGradientSolver::solveSystem() {
+    sofa::simulation::common::MechanicalOperations mop( &p_mechanical_params, this->getContext() );
+
+
+
+    // Get the preconditioning method
+    const PreconditioningMethod preconditioning_method = get_preconditioning_method_from_string(d_preconditioning_method.getValue().getSelectedItem());
+
+
+    Timer::stepBegin("ConjugateGradient::solve");
+    if (preconditioning_method == PreconditioningMethod::None) {
+        // Gather the x and b vector identifiers
+        sofa::simulation::common::VectorOperations vop( &p_mechanical_params, this->getContext() );
+        MultiVecDeriv x(&vop, p_x_id);
+        MultiVecDeriv b(&vop, p_b_id);
+
+        // Solve without having filled the global matrix A (not needed since no preconditioning)
+        const bool solved = d_use_contiguous_vectors.getValue() and solve_with_contiguous_vectors(b, x);
+        if (not solved) {
+            solve(b, x);
+        }
+    } else {
+        // Solve using a preconditioning method. Here the global matrix A and the vectors x and b have been built
+        // previously during the calls to setSystemMBKMatrix, setSystemLHVector and setSystemRHVector, respectively.
+        solve_with_preconditioner(p_A, p_b, p_x);
+
+        // Copy the solution into the mechanical objects of the current context sub-graph.
+        EigenVectorWrapper<FLOATING_POINT_TYPE> x_wrapper(p_x);
+        mop.baseVector2MultiVector(&x_wrapper, p_x_id, &p_accessor);
+    }
+
+    Timer::stepEnd("ConjugateGradient::solve");
+}
+
+template <typename Callback>
+void ConjugateGradientSolver::with_preconditioner(Callback && callback) const {
+    const PreconditioningMethod preconditioning_method = get_preconditioning_method_from_string(d_preconditioning_method.getValue().getSelectedItem());
+    const bool single_precision = p_factorized_in_single_precision;
+
+    if (preconditioning_method == PreconditioningMethod::Diagonal) {
+        if (single_precision) {
+            callback(SinglePrecisionPreconditioner(p_diag_single));
+        } else {
+            callback(p_diag);
+        }
+#if EIGEN_VERSION_AT_LEAST(3,3,0)
+    } else if (preconditioning_method == PreconditioningMethod::IncompleteCholesky) {
+        if (single_precision) {
+            callback(SinglePrecisionPreconditioner(p_ichol_single));
+        } else {
+            callback(p_ichol);
+        }
+#endif
+    } else if (preconditioning_method == PreconditioningMethod::IncompleteLU) {
+        if (single_precision) {
+            callback(SinglePrecisionPreconditioner(p_iLU_single));
+        } else {
+            callback(p_iLU);
+        }
+    } else if (preconditioning_method == PreconditioningMethod::AlgebraicMultigrid) {
+        callback(p_amg);
+    } else if (preconditioning_method == PreconditioningMethod::LLT) {
+        callback(p_llt);
+    } else if (preconditioning_method == PreconditioningMethod::LDLT) {
+        callback(p_ldlt);
+    } else {
+        callback(p_identity);
+    }
+}
 
+void ConjugateGradientSolver::solve_with_preconditioner(const SparseMatrix & A, const Vector & b, Vector & x) const {
+    const bool pipelined = (variant() == Variant::PIPELINED);
+    const bool mixed_precision = p_factorized_in_single_precision and p_A_single.rows() == A.rows();
+    with_preconditioner([this, pipelined, mixed_precision, &A, &b, &x] (const auto & preconditioner) {
+        if (mixed_precision) {
+            solve_mixed_precision(preconditioner, p_A_single, A, b, x);
+        } else if (pipelined) {
+            solve_pipelined(preconditioner, A, b, x);
+        } else {
+            solve(preconditioner, A, b, x);
+        }
+    });
+
+    // If the (possibly reused) preconditioner needed too many iterations, refresh it at the next assembly
+    const auto & iterations_threshold = d_preconditioner_update_iterations_threshold.getValue();
+    if (iterations_threshold > 0 and p_squared_residuals.size() > iterations_threshold) {
+        p_preconditioner_needs_refresh = true;
+        msg_info() << "The CG took " << p_squared_residuals.size() << " iterations (threshold is "
+                   << iterations_threshold << "), the preconditioner will be factorized at the next assembly.";
+    }
+}
+
+sofa::defaulttype::BaseMatrix * ConjugateGradientSolver::create_new_matrix(unsigned int rows, unsigned int cols) const {
+    auto * matrix = new EigenMatrix<SparseMatrix> (static_cast<Eigen::Index>(rows), static_cast<Eigen::Index>(cols));
+    matrix->set_symmetric(true); // The CG only works with symmetric positive definite matrices
+    matrix->set_pattern_frozen(true); // The ODE solvers assemble the whole matrix again after each clear
+    return matrix;
+}
+
+sofa::defaulttype::BaseVector * ConjugateGradientSolver::create_new_vector(unsigned int n) const {
+    return new SofaCaribou::Algebra::EigenVector<Vector>(n);
+}
+
+bool ConjugateGradientSolver::analyze_pattern(const sofa::defaulttype::BaseMatrix * /*A*/) {
+    // The analysis of the preconditioner is done during the factorization, when the size of the system changes
+    return true;
+}
+
+bool ConjugateGradientSolver::factorize(const sofa::defaulttype::BaseMatrix * A) {
+    auto A_ = dynamic_cast<const EigenMatrix<SparseMatrix> *>(A);
+    if (not A_) {
+        throw std::runtime_error("Tried to factorize an incompatible matrix (not an Eigen sparse matrix).");
+    }
+
+    // The system matrix is always assembled here, hence the Identity preconditioner replaces None
+    auto preconditioning_method = get_preconditioning_method_from_string(d_preconditioning_method.getValue().getSelectedItem());
+    if (preconditioning_method == PreconditioningMethod::None) {
+        preconditioning_method = PreconditioningMethod::Identity;
+    }
+
+    p_factorized_A = &(A_->matrix());
+    return update_preconditioner(*p_factorized_A, preconditioning_method);
+}
+
+bool ConjugateGradientSolver::solve(const sofa::defaulttype::BaseVector * F, sofa::defaulttype::BaseVector * X) const {
+    auto F_ = SofaCaribou::Algebra::eigen_vector_view<Vector>(F);
+    auto X_ = SofaCaribou::Algebra::eigen_vector_view<Vector>(X);
+    if (not F_ or not X_ or not p_factorized_A) {
+        return false;
+    }
+
+    // The iterations are done directly on the vectors when they own their memory, and on copies otherwise (for
+    // example, when they share the memory of a mechanical object)
+    const auto * F_owner = dynamic_cast<const SofaCaribou::Algebra::EigenVector<Vector> *>(F);
+    auto * X_owner = dynamic_cast<SofaCaribou::Algebra::EigenVector<Vector> *>(X);
+    Vector b_buffer, x_buffer;
+    if (not F_owner) {
+        b_buffer = *F_;
+    }
+    const Vector & b = F_owner ? F_owner->vector() : b_buffer;
+    Vector & x = X_owner ? X_owner->vector() : x_buffer;
+
+    Timer::stepBegin("ConjugateGradient::solve");
+    x.setZero(X_->size());
+    solve_with_preconditioner(*p_factorized_A, b, x);
     Timer::stepEnd("ConjugateGradient::solve");
+
+    if (not X_owner) {
+        *X_ = x;
+    }
+
+    // Even when the residual threshold isn't reached, the last iterate is kept as the solution (as it is done when
+    // solving through the SOFA linear solver API)
+    return true;
+}
+
+bool ConjugateGradientSolver::solve_multiple(const std::vector<const sofa::defaulttype::BaseVector *> & F,
+                                             const std::vector<sofa::defaulttype::BaseVector *> & X) const {
+    if (F.size() != X.size() or not p_factorized_A) {
+        return false;
+    }
+
+    const auto n = p_factorized_A->rows();
+    const auto number_of_rhs = static_cast<Eigen::Index>(F.size());
+
+    // Gather the right-hand sides into a dense block
+    DenseMatrix B(n, number_of_rhs);
+    for (Eigen::Index j = 0; j < number_of_rhs; ++j) {
+        auto F_ = SofaCaribou::Algebra::eigen_vector_view<Vector>(F[static_cast<std::size_t>(j)]);
+        if (not F_ or F_->size() != n) {
+            return false;
+        }
+        B.col(j) = *F_;
+    }
+    DenseMatrix Xb = DenseMatrix::Zero(n, number_of_rhs);
+
+    Timer::stepBegin("ConjugateGradient::solve_multiple");
+    with_preconditioner([this, &B, &Xb] (const auto & preconditioner) {
+        solve_block(preconditioner, *p_factorized_A, B, Xb);
+    });
+    Timer::stepEnd("ConjugateGradient::solve_multiple");
+
+    // Scatter the solutions
+    for (Eigen::Index j = 0; j < number_of_rhs; ++j) {
+        auto X_ = SofaCaribou::Algebra::eigen_vector_view<Vector>(X[static_cast<std::size_t>(j)]);
+        if (not X_ or X_->size() != n) {
+            return false;
+        }
+        *X_ = Xb.col(j);
+    }
+
+    return true;
+}
+
+void ConjugateGradientSolver::set_forcing_term(FLOATING_POINT_TYPE forcing_term) {
+    p_forcing_term = std::max(forcing_term, static_cast<FLOATING_POINT_TYPE>(0.));
 }
 
 int CGLinearSolverClass = sofa::core::RegisterObject("Linear system solver using the conjugate gradient iterative algorithm")
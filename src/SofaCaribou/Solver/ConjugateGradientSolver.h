@@ -1,6 +1,9 @@
 #pragma once
 
 #include <SofaCaribou/config.h>
+#include <SofaCaribou/Algebra/SparsityPattern.h>
+#include <SofaCaribou/Solver/AMGPreconditioner.h>
+#include <SofaCaribou/Solver/LinearSolver.h>
 
 DISABLE_ALL_WARNINGS_BEGIN
 #include <sofa/core/behavior/LinearSolver.h>
@@ -12,6 +15,7 @@ DISABLE_ALL_WARNINGS_END
 
 #include <Eigen/Core>
 #include <Eigen/IterativeLinearSolvers>
+#include <Eigen/SparseCholesky>
 
 namespace SofaCaribou::solver {
 
@@ -33,13 +37,20 @@ using namespace sofa::core::behavior;
  * to factorize it. In this case, the complete system matrix A and dense vector b are first
  * accumulated from the mechanical objects of the current scene context graph. Once the dense
  * vector x is found, it is propagated back to the mechanical object's vectors.
+ *
+ * This component also implements the SofaCaribou::solver::LinearSolver interface, hence it can be used by the Caribou
+ * ODE solvers which assemble the system matrix themselves. In this case, the matrix is always assembled, and the
+ * Identity preconditioner is used when the preconditioning method is None. Many right-hand sides sharing the same
+ * system matrix can be solved at once with the block conjugate gradient (see solve_multiple).
  */
-class ConjugateGradientSolver : public LinearSolver {
+class ConjugateGradientSolver : public sofa::core::behavior::LinearSolver, public SofaCaribou::solver::LinearSolver {
 
 public:
-    SOFA_CLASS(ConjugateGradientSolver, LinearSolver);
+    SOFA_CLASS(ConjugateGradientSolver, sofa::core::behavior::LinearSolver);
     using SparseMatrix = Eigen::SparseMatrix<FLOATING_POINT_TYPE, Eigen::ColMajor>;
     using Vector = Eigen::Matrix<FLOATING_POINT_TYPE, Eigen::Dynamic, 1>;
+    using DenseMatrix = Eigen::Matrix<FLOATING_POINT_TYPE, Eigen::Dynamic, Eigen::Dynamic>;
+    using SinglePrecisionSparseMatrix = Eigen::SparseMatrix<float, Eigen::ColMajor>;
 
     /// Preconditioning methods
     enum class PreconditioningMethod : unsigned int {
@@ -58,9 +69,50 @@ public:
 #endif
 
         /// Preconditioning based on the incomplete LU factorization.
-        IncompleteLU = 5
+        IncompleteLU = 5,
+
+        /// Preconditioning based on a smoothed aggregation algebraic multigrid V-cycle.
+        AlgebraicMultigrid = 6,
+
+        /// Preconditioning based on the complete sparse Cholesky factorization LL^T (same backend as the LLTSolver).
+        /// Combined with a preconditioner update strategy, a lagged factorization of the system matrix is used.
+        LLT = 7,
+
+        /// Preconditioning based on the complete sparse Cholesky factorization LDL^T (same backend as the LDLTSolver).
+        /// Combined with a preconditioner update strategy, a lagged factorization of the system matrix is used.
+        LDLT = 8
+    };
+
+    /// Variants of the preconditioned conjugate gradient iterations
+    enum class Variant : unsigned int {
+        /// Classic preconditioned CG, with two separated global reductions per iteration. (default)
+        CLASSIC = 0,
+
+        /// Pipelined preconditioned CG (Ghysels & Vanroose, 2014). The global reductions of an iteration are fused
+        /// into a single pass over the vectors, and are not needed anymore by the preconditioner application and the
+        /// matrix-vector product of the same iteration.
+        PIPELINED
+    };
+
+    /// Strategies that determine when the preconditioner is factorized again
+    enum class PreconditionerUpdateStrategy : unsigned int {
+        /// The preconditioner is factorized each time the system matrix is assembled. (default)
+        ALWAYS = 0,
+
+        /// The preconditioner is factorized every N assemblies of the system matrix (for example, every N Newton iterations).
+        EVERY_N_ASSEMBLIES,
+
+        /// The preconditioner is factorized at the first assembly of the system matrix every N time steps.
+        EVERY_N_TIME_STEPS
     };
 
+    /**
+     * Warn about the options that are ignored with the current configuration (for example, the PIPELINED variant
+     * and the deflation, which are not available with the mixed precision).
+     */
+    CARIBOU_API
+    void init() override;
+
     /**
      * Reset the complete system (A, x and b are cleared).
      *
@@ -110,6 +162,62 @@ public:
     CARIBOU_API
     void solveSystem() final;
 
+    /**
+     * @see SofaCaribou::solver::LinearSolver::create_new_matrix
+     */
+    CARIBOU_API
+    sofa::defaulttype::BaseMatrix * create_new_matrix(unsigned int rows, unsigned int cols) const override;
+
+    /**
+     * @see SofaCaribou::solver::LinearSolver::create_new_vector
+     */
+    CARIBOU_API
+    sofa::defaulttype::BaseVector * create_new_vector(unsigned int n) const override;
+
+    /**
+     * Analyze the pattern of the preconditioner for the given matrix.
+     * @see SofaCaribou::solver::LinearSolver::analyze_pattern
+     */
+    CARIBOU_API
+    bool analyze_pattern(const sofa::defaulttype::BaseMatrix * A) override;
+
+    /**
+     * Factorize the preconditioner for the given matrix (following the preconditioner update strategy), and keep a
+     * reference to the matrix for the next solves. The matrix must stay alive until then.
+     * @see SofaCaribou::solver::LinearSolver::factorize
+     */
+    CARIBOU_API
+    bool factorize(const sofa::defaulttype::BaseMatrix * A) override;
+
+    /**
+     * Solve the system A [X] = F with the matrix of the last call to factorize, starting from X = 0.
+     * @see SofaCaribou::solver::LinearSolver::solve
+     */
+    CARIBOU_API
+    bool solve(const sofa::defaulttype::BaseVector * F, sofa::defaulttype::BaseVector * X) const override;
+
+    /**
+     * Solve the systems A [X_i] = F_i at once using the block conjugate gradient, with the matrix of the last call to
+     * factorize and starting from X_i = 0.
+     *
+     * The search directions of every right-hand sides are gathered in the columns of a dense block P, such that each
+     * iteration does a single sparse matrix-dense matrix product AP instead of one matrix-vector product per
+     * right-hand side. Since the search space is shared, the block iterations also converge in fewer iterations than
+     * the independent solves. A right-hand side is removed from the block as soon as it converged.
+     *
+     * @see SofaCaribou::solver::LinearSolver::solve_multiple
+     */
+    CARIBOU_API
+    bool solve_multiple(const std::vector<const sofa::defaulttype::BaseVector *> & F,
+                        const std::vector<sofa::defaulttype::BaseVector *> & X) const override;
+
+    /**
+     * Relax the residual tolerance threshold of the next solves up to the given relative residual (inexact Newton).
+     * @see SofaCaribou::solver::LinearSolver::set_forcing_term
+     */
+    CARIBOU_API
+    void set_forcing_term(FLOATING_POINT_TYPE forcing_term) override;
+
     /**
      * List of squared residual norms (||r||^2) of every CG iterations of the last solve call.
      */
@@ -124,6 +232,14 @@ public:
         return p_squared_initial_residual;
     }
 
+    /**
+     * Deflation basis W (one approximate eigenvector of the system matrix per column) recycled from the previous
+     * solves. Empty when the deflation is disabled or before the first solve.
+     */
+    auto deflation_basis() const -> const DenseMatrix & {
+        return p_deflation_basis;
+    }
+
     /**
      * Get the system matrix.
      */
@@ -138,6 +254,22 @@ public:
     CARIBOU_API
     void assemble (const sofa::core::MechanicalParams* mparams);
 
+    /** Get the variant of the preconditioned conjugate gradient iterations. */
+    CARIBOU_API
+    auto variant() const -> Variant;
+
+    /** Set the variant of the preconditioned conjugate gradient iterations. */
+    CARIBOU_API
+    void set_variant(const Variant & variant);
+
+    /** Get the current strategy that determines when the preconditioner is factorized again. */
+    CARIBOU_API
+    auto preconditioner_update_strategy() const -> PreconditionerUpdateStrategy;
+
+    /** Set the current strategy that determines when the preconditioner is factorized again. */
+    CARIBOU_API
+    void set_preconditioner_update_strategy(const PreconditionerUpdateStrategy & strategy);
+
 protected:
     /// Constructor
     ConjugateGradientSolver();
@@ -156,6 +288,25 @@ protected:
      */
     void solve(sofa::core::behavior::MultiVecDeriv & b, sofa::core::behavior::MultiVecDeriv & x);
 
+    /**
+     * Solve the linear system Ax = b without building the matrix A, but using flattened contiguous vectors.
+     *
+     * The vectors x and b are packed into contiguous buffers, and the product Ax is computed by calling directly the
+     * DirectProductForcefield::add_dforce method of every force fields, hence without any scene graph traversal
+     * during the iterations. The projective constraints are captured once as a diagonal mask. The vector operations
+     * of an iteration are then fused into single loops.
+     *
+     * This is only possible when the sub-graph contains a single mechanical object, no mechanical mappings, and only
+     * force fields that implement the DirectProductForcefield interface (masses are also accepted when the m and b
+     * coefficients are zero). The projective constraints must also be expressible as a diagonal 0/1 mask.
+     *
+     * @param b The right-hand side vector of the system
+     * @param x The solution vector of the system. It should be filled with an initial guess or the previous solution.
+     * @return True if the system was solved, false if the scene is not compatible with contiguous vectors, in which
+     *         case nothing was done and the visitor-based solve should be used.
+     */
+    bool solve_with_contiguous_vectors(sofa::core::behavior::MultiVecDeriv & b, sofa::core::behavior::MultiVecDeriv & x);
+
     /**
      * Solve the linear system Ax = b using a preconditioner.
      *
@@ -168,13 +319,95 @@ protected:
      * @param x The solution vector of the system. It should be filled with an initial guess or the previous solution.
      */
     template <typename Matrix, typename Preconditioner>
-    void solve(const Preconditioner & precond, const Matrix & A, const Vector & b, Vector & x);
+    void solve(const Preconditioner & precond, const Matrix & A, const Vector & b, Vector & x) const;
+
+    /**
+     * Solve the linear systems AX = B (one right-hand side per column of B) using a preconditioner and the block
+     * conjugate gradient method (O'Leary, 1980).
+     *
+     * The search directions P of the block are kept A-conjugate to the previous block using the small s x s matrix
+     * PtAP (s being the number of right-hand sides not yet converged). This matrix is solved with a complete orthogonal
+     * decomposition, hence linearly dependent right-hand sides do not break down the iterations.
+     *
+     * The squared residuals recorded are the squared Frobenius norms of the residual block.
+     *
+     * @param precond The preconditioner
+     * @param A The system matrix as an Eigen matrix
+     * @param B The right-hand side vectors of the systems (one per column)
+     * @param X The solution vectors of the systems. It should be filled with an initial guess or the previous solution.
+     */
+    template <typename Matrix, typename Preconditioner>
+    void solve_block(const Preconditioner & precond, const Matrix & A, const DenseMatrix & B, DenseMatrix & X) const;
+
+    /**
+     * Update the deflation basis W from the Lanczos vectors and coefficients harvested during the last solve.
+     *
+     * The Ritz vectors associated to the smallest eigenvalues of the Lanczos tridiagonal matrix are added to the
+     * current basis, and a Rayleigh-Ritz projection of A onto this enlarged subspace gives the new basis (the
+     * approximate eigenvectors associated to the smallest eigenvalues of A).
+     *
+     * @param A The system matrix of the last solve.
+     */
+    template <typename Matrix>
+    void update_deflation_basis(const Matrix & A) const;
+
+    /**
+     * Solve the linear system Ax = b using a preconditioner and the pipelined variant of the CG iterations.
+     *
+     * This is mathematically equivalent to the classic preconditioned CG, but the recurrences are rearranged
+     * (auxiliary vectors w = Au, m = M^-1 w, n = Am) such that the three dot products (r.u), (w.u) and (r.r) of an
+     * iteration are computed in a single pass, fused with the vector updates of the previous iteration. The
+     * preconditioner application and the matrix-vector product do not depend on these reductions anymore.
+     *
+     * \warning The pipelined recurrences propagate rounding errors slightly more than the classic ones, hence the
+     *          attainable accuracy can be a bit lower for very small residual thresholds.
+     *
+     * @tparam Derived The type of the matrix A, can be a dense or a sparse matrix.
+     * @tparam Preconditioner The type of the preconditioner.
+     *
+     * @param precond The preconditioner
+     * @param A The system matrix as an Eigen matrix
+     * @param b The right-hand side vector of the system
+     * @param x The solution vector of the system. It should be filled with an initial guess or the previous solution.
+     */
+    template <typename Matrix, typename Preconditioner>
+    void solve_pipelined(const Preconditioner & precond, const Matrix & A, const Vector & b, Vector & x) const;
+
+    /**
+     * Solve the linear system Ax = b using a preconditioner, with the matrix-vector products done on a single
+     * precision copy of the matrix A. The vectors and the reductions (dot products) stay in the system's precision.
+     *
+     * Since the sparse matrix-vector product is bounded by the memory bandwidth, reading single precision values
+     * nearly halves its cost. However, the single precision matrix is only an approximation of A, hence the residual
+     * of the CG recurrence can drift away from the true residual b - Ax. The true residual is computed every few
+     * iterations and when the recurrence converges. If it stagnates (it is more than twice the recurrence residual,
+     * or the recurrence converged but not the true residual), the iterations are restarted from the current solution
+     * using the products with the full precision matrix A.
+     *
+     * @param precond The preconditioner
+     * @param A_single The single precision copy of the system matrix
+     * @param A The system matrix
+     * @param b The right-hand side vector of the system
+     * @param x The solution vector of the system. It should be filled with an initial guess or the previous solution.
+     */
+    template <typename Preconditioner>
+    void solve_mixed_precision(const Preconditioner & precond, const SinglePrecisionSparseMatrix & A_single,
+                               const SparseMatrix & A, const Vector & b, Vector & x) const;
 
     /// INPUTS
     Data<bool> d_verbose;
     Data<unsigned int> d_maximum_number_of_iterations;
     Data<FLOATING_POINT_TYPE> d_residual_tolerance_threshold;
     Data< sofa::helper::OptionsGroup > d_preconditioning_method;
+    Data<bool> d_use_contiguous_vectors;
+    Data< sofa::helper::OptionsGroup > d_variant;
+    Data< sofa::helper::OptionsGroup > d_preconditioner_update_strategy;
+    Data<unsigned int> d_preconditioner_update_interval;
+    Data<unsigned int> d_preconditioner_update_iterations_threshold;
+    Data<unsigned int> d_deflation_size;
+    Data<unsigned int> d_deflation_harvest_iterations;
+    Data<bool> d_mixed_precision;
+    Data<unsigned int> d_number_of_threads;
 
 private:
     /// Private methods
@@ -183,6 +416,50 @@ private:
      */
     PreconditioningMethod get_preconditioning_method_from_string(const std::string & preconditioner_name) const;
 
+    /**
+     * @brief Give the coordinates of the top-level mechanical objects to the AMG preconditioner in order to build
+     * the rigid body modes of its near null space. Only translations are used if one of them isn't a 3D object.
+     * @param n The size of the system matrix.
+     */
+    void update_amg_coordinates(Eigen::Index n);
+
+    /**
+     * @brief Check if the preconditioner must be factorized again following the update strategy, or if the
+     * previous factorization can be reused for the current system matrix.
+     */
+    bool preconditioner_must_be_factorized(const PreconditioningMethod & preconditioning_method, Eigen::Index n) const;
+
+    /**
+     * @brief Analyze (when the size of the system changed) and factorize (following the update strategy) the
+     * preconditioner for the given system matrix.
+     * @return True if the preconditioner was successfully factorized or reused, false otherwise.
+     */
+    bool update_preconditioner(const SparseMatrix & A, const PreconditioningMethod & preconditioning_method);
+
+    /**
+     * @brief Call the given function with the preconditioner selected (Identity is used for None). Preconditioners
+     * factorized in single precision are wrapped such that they can be applied on vectors of the system's precision.
+     */
+    template <typename Callback>
+    void with_preconditioner(Callback && callback) const;
+
+    /**
+     * @brief Get the number of threads used by the vector operations and the matrix-vector products of the CG
+     * iterations on the assembled system matrix (always 1 when compiled without OpenMP).
+     */
+    int number_of_threads() const;
+
+    /**
+     * @brief Get the residual tolerance threshold of the CG iterations, which is the largest of the
+     * residual_tolerance_threshold attribute and of the forcing term set by an inexact Newton method.
+     */
+    FLOATING_POINT_TYPE effective_residual_tolerance_threshold() const;
+
+    /**
+     * @brief Solve Ax = b with the CG variant and the preconditioner selected (Identity is used for None).
+     */
+    void solve_with_preconditioner(const SparseMatrix & A, const Vector & b, Vector & x) const;
+
     /// Private members
     ///< The mechanical parameters containing the m, b and k coefficients.
     sofa::core::MechanicalParams p_mechanical_params;
@@ -219,14 +496,69 @@ private:
     ///< Incomplete LU preconditioner
     Eigen::IncompleteLUT<FLOATING_POINT_TYPE> p_iLU;
 
+    ///< Single precision copy of the system matrix and preconditioners (only used in mixed precision)
+    SinglePrecisionSparseMatrix p_A_single;
+    Eigen::DiagonalPreconditioner<float> p_diag_single;
+#if EIGEN_VERSION_AT_LEAST(3,3,0)
+    Eigen::IncompleteCholesky<float> p_ichol_single;
+#endif
+    Eigen::IncompleteLUT<float> p_iLU_single;
+
+    ///< Algebraic multigrid preconditioner
+    AMGPreconditioner p_amg;
+
+    ///< Complete Cholesky factorizations used as preconditioners (possibly factorized from a previous system matrix)
+    Eigen::SimplicialLLT<SparseMatrix, Eigen::Lower, Eigen::AMDOrdering<int>> p_llt;
+    Eigen::SimplicialLDLT<SparseMatrix, Eigen::Lower, Eigen::AMDOrdering<int>> p_ldlt;
+
     ///< Contains the list of available preconditioners with their respective identifier
     std::vector<std::pair<std::string, PreconditioningMethod>> p_preconditioners;
 
+    ///< System matrix given to the last call of factorize (SofaCaribou::solver::LinearSolver interface).
+    const SparseMatrix * p_factorized_A = nullptr;
+
     ///< List of squared residual norms (||r||^2) of every CG iterations of the last solve call.
-    std::vector<FLOATING_POINT_TYPE> p_squared_residuals;
+    mutable std::vector<FLOATING_POINT_TYPE> p_squared_residuals;
 
     ///< Squared residual norm (||r||^2) of the last right-hand side term (b in Ax=b) of the last solve call.
-    FLOATING_POINT_TYPE p_squared_initial_residual;
+    mutable FLOATING_POINT_TYPE p_squared_initial_residual;
+
+    ///< Preconditioning method used for the last factorization of the preconditioner (None if never factorized).
+    PreconditioningMethod p_factorized_preconditioning_method = PreconditioningMethod::None;
+
+    ///< Whether or not the preconditioner was factorized in single precision (mixed precision).
+    bool p_factorized_in_single_precision = false;
+
+    ///< Size of the system matrix used for the last analysis of the preconditioner.
+    Eigen::Index p_preconditioner_dimension = -1;
+
+    ///< Fingerprint of the sparsity pattern of the system matrix used for the last analysis of the preconditioner.
+    std::uint64_t p_preconditioner_pattern_fingerprint = 0;
+
+    ///< Number of assemblies of the system matrix that used the current factorization of the preconditioner.
+    unsigned int p_number_of_assemblies_since_factorization = 0;
+
+    ///< Number of time steps since the last factorization of the preconditioner.
+    unsigned int p_number_of_time_steps_since_factorization = 0;
+
+    ///< Simulation time of the last assembly of the system matrix.
+    double p_time_of_last_assembly = 0;
+
+    ///< Deflation basis (approximate eigenvectors of the smallest eigenvalues of A) recycled between solves.
+    mutable DenseMatrix p_deflation_basis;
+
+    ///< Lanczos vectors (normalized preconditioned residuals) of the first iterations of the last solve.
+    mutable DenseMatrix p_lanczos_vectors;
+
+    ///< CG coefficients alpha and beta of the first iterations of the last solve.
+    mutable std::vector<FLOATING_POINT_TYPE> p_lanczos_alphas;
+    mutable std::vector<FLOATING_POINT_TYPE> p_lanczos_betas;
+
+    ///< Whether or not the last CG solve exceeded the number of iterations threshold (the preconditioner must be refreshed).
+    mutable bool p_preconditioner_needs_refresh = false;
+
+    ///< Forcing term of an inexact Newton method (relative residual tolerance of the next solves), zero if none
+    FLOATING_POINT_TYPE p_forcing_term = 0.;
 };
 
 } // namespace SofaCaribou::solver
@@ -3,6 +3,7 @@
 #include <SofaCaribou/config.h>
 #include <SofaCaribou/Algebra/EigenMatrix.h>
 #include <SofaCaribou/Algebra/EigenVector.h>
+#include <SofaCaribou/Algebra/SparsityPattern.h>
 #include <SofaCaribou/Solver/LinearSolver.h>
 
 DISABLE_ALL_WARNINGS_BEGIN
@@ -13,6 +14,8 @@ DISABLE_ALL_WARNINGS_END
 
 #include <Eigen/Sparse>
 
+#include <memory>
+
 namespace SofaCaribou::solver {
 
 /**
@@ -118,6 +121,23 @@ public:
     template<class Derived>
     static auto canCreate(Derived* o, sofa::core::objectmodel::BaseContext* context, sofa::core::objectmodel::BaseObjectDescription* arg) -> bool;
 
+protected:
+    /**
+     * Check if the sparsity pattern having the given fingerprint (see SofaCaribou::Algebra::pattern_fingerprint) is
+     * the one of the last successful analysis. Derived solvers use it to skip the symbolic analysis (ordering and
+     * symbolic factorization) when the structure of the matrix didn't change, and to redo it before factorizing a
+     * matrix whose structure changed, even if its size is the same.
+     */
+    auto pattern_is_analyzed(std::uint64_t fingerprint) const -> bool {
+        return p_pattern_is_analyzed and fingerprint == p_analyzed_pattern_fingerprint;
+    }
+
+    /** Record the fingerprint of the sparsity pattern that was successfully analyzed. */
+    void set_analyzed_pattern(std::uint64_t fingerprint) {
+        p_analyzed_pattern_fingerprint = fingerprint;
+        p_pattern_is_analyzed = true;
+    }
+
 private:
     /**
      * @see SofaCaribou::solver::LinearSolver::create_new_matrix
@@ -127,6 +147,8 @@ private:
         if (symmetric()) {
             matrix->set_symmetric(symmetric());
         }
+        // The ODE solvers assemble the whole matrix again after each clear, hence its compressed structure can be kept
+        matrix->set_pattern_frozen(true);
         return matrix;
     }
 
@@ -138,6 +160,10 @@ private:
     }
 
 private:
+    /// Map a global system vector over the memory of the vector id of the mechanical object, or null if it isn't
+    /// possible (see SofaCaribou::Algebra::map_mechanical_vector).
+    auto share_mechanical_vector(sofa::core::MultiVecDerivId id) -> std::unique_ptr<SofaCaribou::Algebra::EigenVector<Eigen::Map<Vector>>>;
+
     /// Private members
 
     /// The mechanical parameters containing the m, b and k coefficients.
@@ -161,9 +187,20 @@ private:
     /// Global system right-hand side vector
     SofaCaribou::Algebra::EigenVector<Vector> p_b;
 
+    /// Global system solution and right-hand side vectors sharing the memory of the mechanical object. When they are
+    /// set, they are used instead of p_x and p_b, and the vectors don't need to be copied from (or into) the mechanical object.
+    std::unique_ptr<SofaCaribou::Algebra::EigenVector<Eigen::Map<Vector>>> p_shared_x;
+    std::unique_ptr<SofaCaribou::Algebra::EigenVector<Eigen::Map<Vector>>> p_shared_b;
+
     /// True if the solver has successfully factorize the system matrix
     bool p_A_is_factorized {};
 
+    /// Fingerprint of the sparsity pattern of the last matrix successfully analyzed
+    std::uint64_t p_analyzed_pattern_fingerprint = 0;
+
+    /// True if a matrix pattern was successfully analyzed
+    bool p_pattern_is_analyzed = false;
+
     /// States if the system matrix is symmetric. Note that this value isn't set automatically, the user must
     /// explicitly specify it using set_symmetric(true). When it is true, some optimizations will be enabled.
     bool p_is_symmetric = false;
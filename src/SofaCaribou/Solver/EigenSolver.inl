@@ -2,6 +2,7 @@
 
 #include <SofaCaribou/Solver/EigenSolver.h>
 #include <SofaCaribou/Algebra/EigenMatrix.h>
+#include <SofaCaribou/Algebra/MechanicalVectorMap.h>
 #include <SofaCaribou/Visitor/AssembleGlobalMatrix.h>
 #include <SofaCaribou/Visitor/ConstrainGlobalMatrix.h>
 
@@ -24,9 +25,22 @@ void EigenSolver<EigenMatrix_t>::resetSystem() {
     p_A.resize(0, 0);
     p_x.resize(0);
     p_b.resize(0);
+    p_shared_x.reset();
+    p_shared_b.reset();
     p_accessor.clear();
 }
 
+template <class EigenMatrix_t>
+auto EigenSolver<EigenMatrix_t>::share_mechanical_vector(sofa::core::MultiVecDerivId id) -> std::unique_ptr<SofaCaribou::Algebra::EigenVector<Eigen::Map<Vector>>> {
+    if constexpr (std::is_same_v<Scalar, FLOATING_POINT_TYPE>) {
+        auto v = SofaCaribou::Algebra::map_mechanical_vector(this->getContext(), p_accessor, id);
+        if (v.data() and v.size() == p_A.rowSize()) {
+            return std::make_unique<SofaCaribou::Algebra::EigenVector<Eigen::Map<Vector>>>(v);
+        }
+    }
+    return nullptr;
+}
+
 template <class EigenMatrix_t>
 auto EigenSolver<EigenMatrix_t>::assemble (const sofa::core::MechanicalParams* mparams, SofaCaribou::Algebra::EigenMatrix<Matrix> & A) const -> sofa::component::linearsolver::DefaultMultiMatrixAccessor
 {
@@ -119,12 +133,10 @@ void EigenSolver<EigenMatrix_t>::setSystemMBKMatrix(const sofa::core::Mechanical
     p_mechanical_params = *mparams;
 
     // Step 1. Assemble the system matrix
-    auto previous_dimension = p_A.rowSize();
     p_accessor = assemble(mparams, p_A);
-    auto current_dimension = p_A.rowSize();
 
-    // Step 2. Let the solver analyse the matrix
-    bool matrix_shape_has_changed = previous_dimension != current_dimension;
+    // Step 2. Let the solver analyse the matrix when its sparsity pattern changed
+    bool matrix_shape_has_changed = not pattern_is_analyzed(SofaCaribou::Algebra::pattern_fingerprint(p_A.matrix()));
     if (matrix_shape_has_changed) {
         Timer::stepBegin("MatrixAnalysis");
         if (not this->analyze_pattern(&p_A)) {
@@ -156,9 +168,13 @@ void EigenSolver<EigenMatrix_t>::setSystemRHVector(sofa::core::MultiVecDerivId b
     sofa::simulation::common::MechanicalOperations mop(&p_mechanical_params, this->getContext());
     p_b_id = b_id;
 
-    // Copy the vectors of the mechanical objects into a global eigen vector.
-    p_b.resize(p_A.rowSize());
-    mop.multiVector2BaseVector(p_b_id, &p_b, &p_accessor);
+    // Share the memory of the mechanical object when it is the only one of the system, or copy the vectors of the
+    // mechanical objects into a global eigen vector otherwise.
+    p_shared_b = share_mechanical_vector(p_b_id);
+    if (not p_shared_b) {
+        p_b.resize(p_A.rowSize());
+        mop.multiVector2BaseVector(p_b_id, &p_b, &p_accessor);
+    }
 
     Timer::stepEnd("EigenSolver::AssembleResidualVector");
 }
@@ -175,9 +191,13 @@ void EigenSolver<EigenMatrix_t>::setSystemLHVector(sofa::core::MultiVecDerivId x
     p_x_id = x_id;
 
 
-    // Copy the vectors of the mechanical objects into a global eigen vector.
-    p_x.resize(p_A.rowSize());
-    mop.multiVector2BaseVector(p_x_id, &p_x, &p_accessor);
+    // Share the memory of the mechanical object when it is the only one of the system, or copy the vectors of the
+    // mechanical objects into a global eigen vector otherwise.
+    p_shared_x = share_mechanical_vector(p_x_id);
+    if (not p_shared_x) {
+        p_x.resize(p_A.rowSize());
+        mop.multiVector2BaseVector(p_x_id, &p_x, &p_accessor);
+    }
 
     Timer::stepEnd("EigenSolver::AssembleSolutionVector");
 }
@@ -191,8 +211,10 @@ void EigenSolver<EigenMatrix_t>::solveSystem() {
     sofa::simulation::common::MechanicalOperations mop( &p_mechanical_params, this->getContext() );
 
     Timer::stepBegin("EigenSolver::solve");
-    bool success = this->solve(&p_b, &p_x);
-    if (success) {
+    const sofa::defaulttype::BaseVector * b = p_shared_b ? static_cast<sofa::defaulttype::BaseVector *>(p_shared_b.get()) : &p_b;
+    sofa::defaulttype::BaseVector * x = p_shared_x ? static_cast<sofa::defaulttype::BaseVector *>(p_shared_x.get()) : &p_x;
+    bool success = this->solve(b, x);
+    if (success and not p_shared_x) {
         // Copy the solution into the mechanical objects of the current context sub-graph.
         mop.baseVector2MultiVector(&p_x, p_x_id, &p_accessor);
     }
@@ -0,0 +1,118 @@
+#include <SofaCaribou/Solver/GMRESSolver.h>
+
+DISABLE_ALL_WARNINGS_BEGIN
+#include <sofa/core/ObjectFactory.h>
+#include <sofa/helper/AdvancedTimer.h>
+DISABLE_ALL_WARNINGS_END
+
+#include <Eigen/Dense>
+
+namespace SofaCaribou::solver {
+
+using Timer = sofa::helper::AdvancedTimer;
+
+GMRESSolver::GMRESSolver()
+: d_restart(initData(&d_restart,
+    (unsigned int) 30,
+    "restart",
+    "Number of iterations m between two restarts of the GMRES(m). One vector of the size of the system is stored "
+    "per iteration."))
+{}
+
+bool GMRESSolver::iterate(const SparseMatrix & A, const Vector & b, Vector & x, FLOATING_POINT_TYPE squared_threshold) const {
+    using DenseMatrix = Eigen::Matrix<FLOATING_POINT_TYPE, Eigen::Dynamic, Eigen::Dynamic>;
+
+    // Get the method parameters
+    const auto & maximum_number_of_iterations = d_maximum_number_of_iterations.getValue();
+    const auto & verbose = d_verbose.getValue();
+    const auto m = static_cast<Eigen::Index>(std::max(d_restart.getValue(), 1u));
+
+    // Declare the method variables
+    const auto n = A.cols();
+    UNSIGNED_INTEGER_TYPE iteration_number = 0; // Current iteration number
+    DenseMatrix V(n, m+1); // Orthonormal basis of the Krylov subspace
+    DenseMatrix H(m+1, m); // Hessenberg matrix, reduced to an upper triangular matrix by the Givens rotations
+    Vector g(m+1); // Right-hand side of the least-squares problem min |g - Hy|
+    Vector c(m), s(m); // Cosines and sines of the Givens rotations
+    Vector z(n), w(n);
+
+    // INITIAL RESIDUAL
+    Vector r = b - A*x;
+    FLOATING_POINT_TYPE r_norm_2 = r.squaredNorm();
+
+    while (r_norm_2 >= squared_threshold and iteration_number < maximum_number_of_iterations) {
+        // Restart the Arnoldi process from the current residual
+        const FLOATING_POINT_TYPE beta = sqrt(r_norm_2);
+        V.col(0) = r / beta;
+        g.setZero();
+        g[0] = beta;
+        H.setZero();
+
+        Eigen::Index k = 0; // Size of the Krylov subspace built in this cycle
+        for (Eigen::Index j = 0; j < m and iteration_number < maximum_number_of_iterations; ++j) {
+            Timer::stepBegin("gmres_iteration");
+
+            // 1. w = A M^-1 v_j
+            precondition(V.col(j), z);
+            w.noalias() = A * z;
+
+            // 2. Orthogonalize w against the basis (modified Gram-Schmidt)
+            for (Eigen::Index i = 0; i <= j; ++i) {
+                H(i, j) = w.dot(V.col(i));
+                w.noalias() -= H(i, j) * V.col(i);
+            }
+            const FLOATING_POINT_TYPE h = w.norm();
+
+            // 3. Apply the previous Givens rotations on the new column of H, and compute the one that zeroes h
+            for (Eigen::Index i = 0; i < j; ++i) {
+                const FLOATING_POINT_TYPE t = c[i]*H(i, j) + s[i]*H(i+1, j);
+                H(i+1, j) = -s[i]*H(i, j) + c[i]*H(i+1, j);
+                H(i, j) = t;
+            }
+            const FLOATING_POINT_TYPE d = std::hypot(H(j, j), h);
+            c[j] = H(j, j) / d;
+            s[j] = h / d;
+            H(j, j) = d;
+            g[j+1] = -s[j]*g[j];
+            g[j] = c[j]*g[j];
+
+            // 4. The residual norm of the least-squares solution is given by the last entry of g
+            r_norm_2 = g[j+1]*g[j+1];
+            p_squared_residuals.emplace_back(r_norm_2);
+            k = j+1;
+            ++iteration_number;
+
+            msg_info_when(verbose) << "GMRES iteration #" << iteration_number
+                                   << ": |r|/|b| = " << sqrt(r_norm_2/b.squaredNorm());
+
+            Timer::stepEnd("gmres_iteration");
+
+            if (r_norm_2 < squared_threshold or h <= (std::numeric_limits<FLOATING_POINT_TYPE>::min)()) {
+                // Converged, or the Krylov subspace is invariant (lucky breakdown)
+                break;
+            }
+
+            V.col(j+1) = w / h;
+        }
+
+        // Update the solution x = x + M^-1 V y where y minimizes |g - Hy|
+        const Vector y = H.topLeftCorner(k, k).triangularView<Eigen::Upper>().solve(g.head(k));
+        precondition(V.leftCols(k) * y, z);
+        x += z;
+
+        // Compute the true residual of the new solution before restarting
+        r.noalias() = b - A*x;
+        r_norm_2 = r.squaredNorm();
+    }
+
+    if (not p_squared_residuals.empty()) {
+        p_squared_residuals.back() = r_norm_2;
+    }
+
+    return (r_norm_2 < squared_threshold);
+}
+
+static int GMRESSolverClass = sofa::core::RegisterObject("Caribou restarted GMRES linear solver for non-symmetric systems")
+    .add< GMRESSolver >();
+
+} // namespace SofaCaribou::solver
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <SofaCaribou/config.h>
+#include <SofaCaribou/Solver/KrylovSolver.h>
+
+namespace SofaCaribou::solver {
+
+/**
+ * Restarted GMRES(m) linear solver for general (non-symmetric) sparse systems.
+ *
+ * The solver builds an orthonormal basis of the Krylov subspace (modified Gram-Schmidt) and finds the solution that
+ * minimizes the residual norm in this subspace (Givens rotations on the Hessenberg matrix). Since the memory and the
+ * cost of the orthogonalization grow with the number of iterations, the iterations are restarted from the current
+ * solution every m iterations. The preconditioner is applied on the right, such that the residual minimized is the
+ * true residual of the system.
+ */
+class GMRESSolver : public KrylovSolver {
+public:
+    SOFA_CLASS(GMRESSolver, KrylovSolver);
+
+    CARIBOU_API
+    GMRESSolver();
+
+protected:
+    /**
+     * @see KrylovSolver::iterate
+     */
+    bool iterate(const SparseMatrix & A, const Vector & b, Vector & x, FLOATING_POINT_TYPE squared_threshold) const override;
+
+private:
+    /// INPUTS
+    Data<unsigned int> d_restart;
+};
+
+} // namespace SofaCaribou::solver
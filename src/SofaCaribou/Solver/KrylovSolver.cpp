@@ -0,0 +1,187 @@
+#include <SofaCaribou/Solver/KrylovSolver.h>
+#include <SofaCaribou/Solver/EigenSolver.inl>
+
+DISABLE_ALL_WARNINGS_BEGIN
+#include <sofa/helper/AdvancedTimer.h>
+DISABLE_ALL_WARNINGS_END
+
+namespace SofaCaribou::solver {
+
+KrylovSolver::KrylovSolver()
+: d_verbose(initData(&d_verbose,
+    false,
+    "verbose",
+    "Output convergence status at each iterations."))
+, d_maximum_number_of_iterations(initData(&d_maximum_number_of_iterations,
+    (unsigned int) 1000,
+    "maximum_number_of_iterations",
+    "Maximum number of iterations before diverging."))
+, d_residual_tolerance_threshold(initData(&d_residual_tolerance_threshold,
+    1e-5,
+    "residual_tolerance_threshold",
+    "Convergence criterion: The iterations will stop when the relative residual norm |b - Ax| / |b| is lower than "
+    "this threshold."))
+, d_preconditioning_method(initData(&d_preconditioning_method,
+    "preconditioning_method",
+    R"(
+        Preconditioning method used.
+          None:          No preconditioning.
+          Diagonal:      Preconditioning using an approximation of A.x = b by ignoring all off-diagonal entries of A.
+          IncompleteLU:  Preconditioning based on the incomplete LU factorization (default).
+    )"))
+{
+    d_preconditioning_method.setValue(sofa::helper::OptionsGroup(std::vector < std::string > {
+        "None", "Diagonal", "IncompleteLU"
+    }));
+
+    // Select the default value
+    set_preconditioning_method(PreconditioningMethod::IncompleteLU);
+}
+
+auto KrylovSolver::preconditioning_method() const -> PreconditioningMethod {
+    const auto v = static_cast<PreconditioningMethod>(d_preconditioning_method.getValue().getSelectedId());
+    switch (v) {
+        case PreconditioningMethod::None:
+        case PreconditioningMethod::Diagonal:
+        case PreconditioningMethod::IncompleteLU:
+            return v;
+    }
+
+    // Default value
+    return PreconditioningMethod::IncompleteLU;
+}
+
+void KrylovSolver::set_preconditioning_method(const PreconditioningMethod & method) {
+    using namespace sofa::helper;
+    auto preconditioning_method = WriteOnlyAccessor<Data<OptionsGroup>>(d_preconditioning_method);
+    preconditioning_method->setSelectedItem(static_cast<unsigned int> (method));
+}
+
+bool KrylovSolver::analyze_pattern(const sofa::defaulttype::BaseMatrix * A) {
+    auto A_ = dynamic_cast<const SofaCaribou::Algebra::EigenMatrix<Matrix> *>(A);
+    if (not A_) {
+        throw std::runtime_error("Tried to analyze an incompatible matrix (not an Eigen matrix).");
+    }
+
+    if (preconditioning_method() == PreconditioningMethod::IncompleteLU) {
+        // The ordering of the incomplete LU is only computed again when the structure of the matrix changed
+        const auto fingerprint = SofaCaribou::Algebra::pattern_fingerprint(A_->matrix());
+        if (pattern_is_analyzed(fingerprint)) {
+            return true;
+        }
+
+        p_iLU.analyzePattern(A_->matrix());
+        if (p_iLU.info() != Eigen::Success) {
+            return false;
+        }
+
+        set_analyzed_pattern(fingerprint);
+    }
+
+    return true;
+}
+
+bool KrylovSolver::factorize(const sofa::defaulttype::BaseMatrix * A) {
+    auto A_ = dynamic_cast<const SofaCaribou::Algebra::EigenMatrix<Matrix> *>(A);
+    if (not A_) {
+        throw std::runtime_error("Tried to factorize an incompatible matrix (not an Eigen matrix).");
+    }
+
+    p_factorized_A = &(A_->matrix());
+
+    const auto method = preconditioning_method();
+    if (method == PreconditioningMethod::Diagonal) {
+        p_inverse_diagonal = p_factorized_A->diagonal();
+        for (Eigen::Index i = 0; i < p_inverse_diagonal.size(); ++i) {
+            p_inverse_diagonal[i] = (p_inverse_diagonal[i] != 0) ? 1. / p_inverse_diagonal[i] : 1.;
+        }
+    } else if (method == PreconditioningMethod::IncompleteLU) {
+        // Does nothing when the pattern of the matrix was already analyzed
+        if (not analyze_pattern(A)) {
+            return false;
+        }
+        p_iLU.factorize(*p_factorized_A);
+        return (p_iLU.info() == Eigen::Success);
+    }
+
+    return true;
+}
+
+void KrylovSolver::precondition(const Vector & r, Vector & z) const {
+    switch (preconditioning_method()) {
+        case PreconditioningMethod::Diagonal:
+            z = p_inverse_diagonal.cwiseProduct(r);
+            break;
+        case PreconditioningMethod::IncompleteLU:
+            z = p_iLU.solve(r);
+            break;
+        case PreconditioningMethod::None:
+            z = r;
+            break;
+    }
+}
+
+bool KrylovSolver::solve(const sofa::defaulttype::BaseVector * F, sofa::defaulttype::BaseVector * X) const {
+    auto F_ = SofaCaribou::Algebra::eigen_vector_view<Vector>(F);
+    auto X_ = SofaCaribou::Algebra::eigen_vector_view<Vector>(X);
+    if (not F_ or not X_ or not p_factorized_A) {
+        return false;
+    }
+
+    // The iterations are done directly on the vectors when they own their memory, and on copies otherwise (for
+    // example, when they share the memory of a mechanical object)
+    const auto * F_owner = dynamic_cast<const SofaCaribou::Algebra::EigenVector<Vector> *>(F);
+    auto * X_owner = dynamic_cast<SofaCaribou::Algebra::EigenVector<Vector> *>(X);
+    Vector b_buffer, x_buffer;
+    if (not F_owner) {
+        b_buffer = *F_;
+    }
+    const Vector & b = F_owner ? F_owner->vector() : b_buffer;
+    Vector & x = X_owner ? X_owner->vector() : x_buffer;
+    x.setZero(b.size());
+
+    p_squared_residuals.clear();
+    p_squared_residuals.reserve(d_maximum_number_of_iterations.getValue());
+
+    // Make sure that the right hand side isn't zero
+    p_squared_initial_residual = b.squaredNorm();
+    if (p_squared_initial_residual < EPSILON) {
+        msg_info() << "Right-hand side of the system is zero, hence x = 0.";
+        sofa::helper::AdvancedTimer::valSet("nb_iterations", 0.f);
+        if (not X_owner) {
+            *X_ = x;
+        }
+        return true;
+    }
+
+    // Compute the tolerance w.r.t |b| since |r|/|b| < threshold is equivalent to  r^2 < b^2 * threshold^2
+    const auto residual_tolerance_threshold = std::max(d_residual_tolerance_threshold.getValue(), p_forcing_term);
+    const auto zero = (std::numeric_limits<FLOATING_POINT_TYPE>::min)(); // A numerical floating point zero
+    const auto squared_threshold = std::max(residual_tolerance_threshold*residual_tolerance_threshold*p_squared_initial_residual, zero);
+
+    const bool converged = iterate(*p_factorized_A, b, x, squared_threshold);
+    if (not X_owner) {
+        *X_ = x;
+    }
+
+    const auto r_norm_2 = p_squared_residuals.empty() ? p_squared_initial_residual : p_squared_residuals.back();
+    if (converged) {
+        msg_info() << "Converged in " << p_squared_residuals.size()
+                   << " iterations with a residual of |r|/|b| = " << sqrt(r_norm_2/p_squared_initial_residual)
+                   << " (threshold was " << residual_tolerance_threshold << ")";
+    } else {
+        msg_info() << "Diverged with a residual of |r|/|b| = " << sqrt(r_norm_2/p_squared_initial_residual)
+                   << " (threshold was " << residual_tolerance_threshold << ")";
+    }
+    sofa::helper::AdvancedTimer::valSet("nb_iterations", static_cast<float>(p_squared_residuals.size()));
+
+    // As for the ConjugateGradientSolver, the last iterate is kept as the solution even when the residual threshold
+    // isn't reached.
+    return true;
+}
+
+void KrylovSolver::set_forcing_term(FLOATING_POINT_TYPE forcing_term) {
+    p_forcing_term = std::max(forcing_term, static_cast<FLOATING_POINT_TYPE>(0.));
+}
+
+} // namespace SofaCaribou::solver
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <SofaCaribou/config.h>
+#include <SofaCaribou/Solver/EigenSolver.h>
+
+DISABLE_ALL_WARNINGS_BEGIN
+#include <sofa/helper/OptionsGroup.h>
+DISABLE_ALL_WARNINGS_END
+
+#include <Eigen/Sparse>
+#include <Eigen/IterativeLinearSolvers>
+
+#include <vector>
+
+namespace SofaCaribou::solver {
+
+/**
+ * Base class for the preconditioned Krylov subspace solvers of general (non-symmetric) sparse systems, such as the
+ * GMRESSolver and the BiCGSTABSolver.
+ *
+ * Unlike the direct LU solver, the system matrix is never factorized: only its preconditioner is computed at each
+ * assembly (the same incomplete LU preconditioner as the ConjugateGradientSolver), and the solution is found
+ * iteratively using matrix-vector products. The memory footprint is hence a fraction of the one of a sparse LU, which
+ * suffers from a large fill-in on big three-dimensional models.
+ *
+ * Derived solvers only have to implement the iterations (see KrylovSolver::iterate).
+ */
+class KrylovSolver : public EigenSolver<Eigen::SparseMatrix<FLOATING_POINT_TYPE, Eigen::ColMajor, int>> {
+public:
+    using SparseMatrix = Eigen::SparseMatrix<FLOATING_POINT_TYPE, Eigen::ColMajor, int>;
+    SOFA_ABSTRACT_CLASS(KrylovSolver, SOFA_TEMPLATE(EigenSolver, SparseMatrix));
+
+    template <typename T>
+    using Data = sofa::Data<T>;
+
+    using Base = EigenSolver<SparseMatrix>;
+    using Matrix = typename Base::Matrix;
+    using Vector = typename Base::Vector;
+
+    /**
+     * Preconditioning methods
+     */
+    enum class PreconditioningMethod : unsigned int {
+        /** No preconditioning */
+        None = 0,
+
+        /** Diagonal (Jacobi) preconditioner */
+        Diagonal,
+
+        /** Incomplete LU factorization with dual threshold (Eigen::IncompleteLUT) */
+        IncompleteLU
+    };
+
+    CARIBOU_API
+    KrylovSolver();
+
+    /**
+     * @see SofaCaribou::solver::LinearSolver::analyze_pattern
+     */
+    CARIBOU_API
+    bool analyze_pattern(const sofa::defaulttype::BaseMatrix * A) override;
+
+    /**
+     * Compute the preconditioner of the system matrix. The matrix itself is kept as is, and must remain valid until the
+     * next call to factorize.
+     * @see SofaCaribou::solver::LinearSolver::factorize
+     */
+    CARIBOU_API
+    bool factorize(const sofa::defaulttype::BaseMatrix * A) override;
+
+    /**
+     * Solve the system iteratively, starting from a null solution vector.
+     * @see SofaCaribou::solver::LinearSolver::solve
+     */
+    CARIBOU_API
+    bool solve(const sofa::defaulttype::BaseVector * F, sofa::defaulttype::BaseVector * X) const override;
+
+    /**
+     * @see SofaCaribou::solver::LinearSolver::set_forcing_term
+     */
+    CARIBOU_API
+    void set_forcing_term(FLOATING_POINT_TYPE forcing_term) override;
+
+    /** Get the current preconditioning method. */
+    CARIBOU_API
+    auto preconditioning_method() const -> PreconditioningMethod;
+
+    /** Set the current preconditioning method. */
+    CARIBOU_API
+    void set_preconditioning_method(const PreconditioningMethod & method);
+
+    /**
+     * List of squared residual norms (||r||^2) of every iterations of the last solve call.
+     */
+    auto squared_residuals() const -> const std::vector<FLOATING_POINT_TYPE> & {
+        return p_squared_residuals;
+    }
+
+    /**
+     * Squared residual norm (||r||^2) of the last right-hand side term (b in Ax=b) of the last solve call.
+     */
+    auto squared_initial_residual() const -> const FLOATING_POINT_TYPE & {
+        return p_squared_initial_residual;
+    }
+
+    /** The system solved by the Krylov solvers is not assumed symmetric. */
+    inline bool symmetric() const override {return false;}
+
+    /** The Krylov solvers have no backend choice, hence there is nothing to check here. */
+    template<class Derived>
+    static auto canCreate(Derived*, sofa::core::objectmodel::BaseContext*, sofa::core::objectmodel::BaseObjectDescription*) -> bool {
+        return true;
+    }
+
+protected:
+    /**
+     * Do the iterations of the Krylov method on the system Ax = b.
+     *
+     * Implementations must stop when the squared residual norm |b - Ax|^2 is lower than the given threshold, and
+     * record the squared residual norm of every iterations into p_squared_residuals.
+     *
+     * @param A The system matrix
+     * @param b The right-hand side vector of the system
+     * @param x The solution vector of the system, filled with the initial guess.
+     * @param squared_threshold The squared residual norm under which the iterations stop.
+     * @return True if the iterations converged, false otherwise.
+     */
+    virtual bool iterate(const SparseMatrix & A, const Vector & b, Vector & x, FLOATING_POINT_TYPE squared_threshold) const = 0;
+
+    /**
+     * Apply the preconditioner: z = M^-1 r
+     */
+    void precondition(const Vector & r, Vector & z) const;
+
+    /// INPUTS
+    Data<bool> d_verbose;
+    Data<unsigned int> d_maximum_number_of_iterations;
+    Data<FLOATING_POINT_TYPE> d_residual_tolerance_threshold;
+    Data< sofa::helper::OptionsGroup > d_preconditioning_method;
+
+    /// Private members
+    ///< List of squared residual norms (||r||^2) of every iterations of the last solve call.
+    mutable std::vector<FLOATING_POINT_TYPE> p_squared_residuals;
+
+private:
+    ///< Squared residual norm (||r||^2) of the last right-hand side term (b in Ax=b) of the last solve call.
+    mutable FLOATING_POINT_TYPE p_squared_initial_residual {};
+
+    ///< The system matrix given to the last call of factorize
+    const SparseMatrix * p_factorized_A = nullptr;
+
+    ///< Inverse of the diagonal of the system matrix (Diagonal preconditioner)
+    Vector p_inverse_diagonal;
+
+    ///< Incomplete LU preconditioner
+    Eigen::IncompleteLUT<FLOATING_POINT_TYPE> p_iLU;
+
+    ///< Forcing term of an inexact Newton method (relative residual tolerance of the next solves), zero if none
+    FLOATING_POINT_TYPE p_forcing_term = 0.;
+};
+
+} // namespace SofaCaribou::solver
@@ -2,6 +2,7 @@
 
 #include <SofaCaribou/config.h>
 #include <SofaCaribou/Solver/EigenSolver.h>
+#include <SofaCaribou/Solver/Ordering.h>
 
 DISABLE_ALL_WARNINGS_BEGIN
 #include <sofa/helper/OptionsGroup.h>
@@ -14,7 +15,8 @@ namespace SofaCaribou::solver {
  *
  * This class provides a LDL^T Cholesky factorizations of sparse matrices that are selfadjoint and positive definite.
  * In order to reduce the fill-in, a symmetric permutation P is applied prior to the factorization such that the
- * factorized matrix is P A P^-1.
+ * factorized matrix is P A P^-1. The permutation is computed during the symbolic analysis using the selected ordering
+ * method (see SofaCaribou::solver::OrderingMethod).
  *
  * The component uses the Eigen SimplicialLDLT class as the solver backend.
  *
@@ -43,19 +45,91 @@ public:
     CARIBOU_API
     bool factorize(const sofa::defaulttype::BaseMatrix * A) override;
 
+    /**
+     * Update the current factors with the difference between A and the last factorized matrix when it is of low rank,
+     * or factorize A from scratch otherwise. Only the Eigen backend supports low-rank updates.
+     * @see LinearSolver::refactorize
+     */
+    CARIBOU_API
+    bool refactorize(const sofa::defaulttype::BaseMatrix * A, unsigned int maximum_rank) override;
+
+    /**
+     * Only the Eigen backend supports low-rank updates.
+     * @see LinearSolver::update_factorization
+     */
+    CARIBOU_API
+    bool update_factorization(const sofa::defaulttype::BaseMatrix * W, bool downdate) override;
+
     /**
      * @see SofaCaribou::solver::LinearSolver::solve
      */
     CARIBOU_API
     bool solve(const sofa::defaulttype::BaseVector * F, sofa::defaulttype::BaseVector * X) const override;
 
+    /** Get the current fill-reducing ordering method. */
+    CARIBOU_API
+    auto ordering_method() const -> OrderingMethod;
+
+    /** Set the fill-reducing ordering method. It will be used on the next symbolic analysis. */
+    CARIBOU_API
+    void set_ordering_method(const OrderingMethod & method);
+
+    /** Number of non-zero coefficients of the factors computed by the last numerical factorization. */
+    auto factor_non_zeros() const -> unsigned int { return d_factor_non_zeros.getValue(); }
+
+    /** Number of factorizations done by updating the previous factors with low-rank modifications (see refactorize). */
+    auto number_of_low_rank_updates() const -> unsigned int { return p_number_of_low_rank_updates; }
+
     // Get the backend name of the class derived from the EigenSolver template parameter
     CARIBOU_API
     static std::string BackendName();
 private:
+    /**
+     * Check if the current symbolic analysis was done on a matrix having the sparsity pattern of the given fingerprint,
+     * using the current ordering method (which can be changed at any time).
+     */
+    auto analysis_is_valid(std::uint64_t fingerprint) const -> bool {
+        return this->pattern_is_analyzed(fingerprint) and p_analyzed_ordering == ordering_method();
+    }
+
+    /**
+     * Symbolic analysis (ordering and symbolic factorization) of the matrix A, whose sparsity pattern has the given
+     * fingerprint (see SofaCaribou::Algebra::pattern_fingerprint).
+     */
+    bool analyze(const Matrix & A, std::uint64_t fingerprint);
+
     /// Solver backend used (Eigen or Pardiso)
     Data<sofa::helper::OptionsGroup> d_backend;
 
+    /// Fill-reducing ordering applied prior to the factorization (Eigen backend only)
+    Data<sofa::helper::OptionsGroup> d_ordering;
+
+    /// OUTPUTS
+    /// Number of non-zero coefficients of the factors computed by the last numerical factorization
+    Data<unsigned int> d_factor_non_zeros;
+
+    /// Time (in milliseconds) took by the last numerical factorization
+    Data<double> d_factorization_time;
+
+    /// Fill-reducing permutation P computed during the symbolic analysis, and its inverse (empty for the natural ordering)
+    Eigen::PermutationMatrix<Eigen::Dynamic, Eigen::Dynamic, int> p_P, p_Pinv;
+
+    /// Permuted system matrix P A P^-1 (only its upper triangular part is stored)
+    Matrix p_permuted_A;
+
+    /// States if p_permuted_A is the matrix of the current factors, which is required to update them (see refactorize)
+    bool p_permuted_A_is_factorized = false;
+
+    /// States if the factors of p_solver are valid. They aren't after a failed low-rank update, which may have
+    /// partially modified them, and the matrix must then be factorized again before the next solve.
+    bool p_factors_are_valid = false;
+
+    /// Number of factorizations done by updating the previous factors
+    unsigned int p_number_of_low_rank_updates = 0;
+
+    /// Ordering method used by the last symbolic analysis
+    OrderingMethod p_analyzed_ordering = OrderingMethod::Natural;
+
     /// The actual Eigen solver used (its type is passed as a template parameter and must be derived from Eigen::SparseSolverBase)
     EigenSolver_t p_solver;
 };
@@ -3,11 +3,13 @@
 #include <SofaCaribou/Algebra/EigenMatrix.h>
 #include <SofaCaribou/Solver/LDLTSolver.h>
 #include <SofaCaribou/Solver/EigenSolver.inl>
+#include <SofaCaribou/Solver/CholeskyUpdate.h>
 
 #include<Eigen/SparseCholesky>
 
 #include <algorithm>
 #include <cctype>
+#include <chrono>
 #include <string>
 
 #ifdef CARIBOU_WITH_MKL
@@ -29,12 +31,33 @@ struct solver_traits {};
 template<typename MatrixType, int UpLo, typename Ordering>
 struct solver_traits<Eigen::SimplicialLDLT < MatrixType, UpLo, Ordering>> {
 static auto BackendName() -> std::string { return "Eigen"; }
+static constexpr auto is_eigen() -> bool {return true;}
+
+// The permuted matrix and the low-rank updates only fill and read the upper triangular part of the system matrix
+static_assert(UpLo == Eigen::Upper, "The Eigen backend only supports solvers reading the upper triangular part of the matrix.");
+
+static auto factor_non_zeros(const Eigen::SimplicialLDLT < MatrixType, UpLo, Ordering> & solver) -> Eigen::Index {
+    // The unit diagonal of L isn't stored
+    return solver.matrixL().nestedExpression().nonZeros() + solver.rows();
+}
+
+// Access to the factors stored by the Eigen solver, which are modified in place by the low-rank updates
+struct FactorAccess : Eigen::SimplicialLDLT < MatrixType, UpLo, Ordering> {
+    using Solver = Eigen::SimplicialLDLT < MatrixType, UpLo, Ordering>;
+    using Vector = typename Solver::VectorType;
+    static auto L(Solver & solver) -> auto & { return solver.*(&FactorAccess::m_matrix); }
+    static auto D(Solver & solver) -> Vector * { return &(solver.*(&FactorAccess::m_diag)); }
+};
 };
 
 #ifdef CARIBOU_WITH_MKL
 template<typename MatrixType, int UpLo>
 struct solver_traits <Eigen::PardisoLDLT< MatrixType, UpLo >> {
     static auto BackendName() -> std::string {return "Pardiso";}
+    static constexpr auto is_eigen() -> bool {return false;}
+    static auto factor_non_zeros(Eigen::PardisoLDLT< MatrixType, UpLo > & solver) -> Eigen::Index {
+        return solver.pardisoParameterArray()[17]; // Output: Number of nonzeros in the factors
+    }
 };
 #endif
 }
@@ -46,9 +69,46 @@ bool LDLTSolver<EigenSolver_t>::analyze_pattern(const sofa::defaulttype::BaseMat
         throw std::runtime_error("Tried to analyze an incompatible matrix (not an Eigen matrix).");
     }
 
-    p_solver.analyzePattern(A_->matrix());
+    // The symbolic analysis is skipped when the structure of the matrix didn't change since the last one
+    const auto fingerprint = SofaCaribou::Algebra::pattern_fingerprint(A_->matrix());
+    if (analysis_is_valid(fingerprint)) {
+        return true;
+    }
 
-    return (p_solver.info() == Eigen::Success);
+    return analyze(A_->matrix(), fingerprint);
+}
+
+template<class EigenSolver_t>
+bool LDLTSolver<EigenSolver_t>::analyze(const Matrix & A, std::uint64_t fingerprint) {
+    if constexpr (solver_traits<EigenSolver_t>::is_eigen()) {
+        // The Eigen backend uses the natural ordering, the fill-reducing permutation is applied here instead
+        compute_ordering(ordering_method(), A, p_Pinv);
+        if (p_Pinv.size() > 0) {
+            p_P = p_Pinv.inverse();
+            p_permuted_A.resize(A.rows(), A.cols());
+            p_permuted_A.template selfadjointView<Eigen::Upper>() = A.template selfadjointView<Eigen::Lower>().twistedBy(p_P);
+            p_solver.analyzePattern(p_permuted_A);
+        } else {
+            p_P.resize(0);
+            p_permuted_A.resize(0, 0);
+            p_solver.analyzePattern(A);
+        }
+    } else {
+        // Pardiso computes its own (nested dissection) ordering
+        p_solver.analyzePattern(A);
+    }
+
+    // The current factors (if any) were computed from another symbolic analysis
+    p_permuted_A_is_factorized = false;
+    p_factors_are_valid = false;
+
+    if (p_solver.info() != Eigen::Success) {
+        return false;
+    }
+
+    this->set_analyzed_pattern(fingerprint);
+    p_analyzed_ordering = ordering_method();
+    return true;
 }
 
 template<class EigenSolver_t>
@@ -58,21 +118,191 @@ bool LDLTSolver<EigenSolver_t>::factorize(const sofa::defaulttype::BaseMatrix *A
         throw std::runtime_error("Tried to analyze an incompatible matrix (not an Eigen matrix).");
     }
 
-    p_solver.factorize(A_->matrix());
+    // The structure of the matrix changed since the last symbolic analysis (for example, new contacts appeared), even
+    // if its size may be the same: the analysis must be done again before the numerical factorization
+    const auto fingerprint = SofaCaribou::Algebra::pattern_fingerprint(A_->matrix());
+    if (not analysis_is_valid(fingerprint)) {
+        if (not analyze(A_->matrix(), fingerprint)) {
+            return false;
+        }
+    }
 
-    return (p_solver.info() == Eigen::Success);
+    const auto start = std::chrono::steady_clock::now();
+
+    if (p_P.size() > 0) {
+        p_permuted_A.template selfadjointView<Eigen::Upper>() = A_->matrix().template selfadjointView<Eigen::Lower>().twistedBy(p_P);
+        p_solver.factorize(p_permuted_A);
+    } else {
+        p_solver.factorize(A_->matrix());
+    }
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    d_factorization_time.setValue(static_cast<double>(elapsed) * 1e-6);
+
+    // With the natural ordering, the matrix is factorized without being copied into p_permuted_A
+    p_permuted_A_is_factorized = (p_P.size() > 0 and p_solver.info() == Eigen::Success);
+    p_factors_are_valid = (p_solver.info() == Eigen::Success);
+
+    if (p_solver.info() != Eigen::Success) {
+        return false;
+    }
+
+    d_factor_non_zeros.setValue(static_cast<unsigned int>(solver_traits<EigenSolver_t>::factor_non_zeros(p_solver)));
+    return true;
+}
+
+template<class EigenSolver_t>
+bool LDLTSolver<EigenSolver_t>::refactorize(const sofa::defaulttype::BaseMatrix * A, unsigned int maximum_rank) {
+    if constexpr (not solver_traits<EigenSolver_t>::is_eigen()) {
+        return factorize(A);
+    } else {
+        using FactorAccess = typename solver_traits<EigenSolver_t>::FactorAccess;
+        using Update = CholeskyUpdate<typename Matrix::Scalar, typename Matrix::StorageIndex>;
+
+        auto A_ = dynamic_cast<const SofaCaribou::Algebra::EigenMatrix<Matrix> *>(A);
+        if (not A_) {
+            throw std::runtime_error("Tried to factorize an incompatible matrix (not an Eigen matrix).");
+        }
+
+        // The factors can only be updated if they were computed from the same symbolic analysis as the one of A
+        if (p_permuted_A_is_factorized and analysis_is_valid(SofaCaribou::Algebra::pattern_fingerprint(A_->matrix()))) {
+            const auto start = std::chrono::steady_clock::now();
+
+            Matrix permuted_A;
+            if (p_P.size() > 0) {
+                permuted_A.resize(A_->rows(), A_->cols());
+                permuted_A.template selfadjointView<Eigen::Upper>() = A_->matrix().template selfadjointView<Eigen::Lower>().twistedBy(p_P);
+            } else {
+                permuted_A = A_->matrix().template triangularView<Eigen::Upper>();
+            }
+
+            // Count the modified columns first, such that the modification is only decomposed when it is small enough
+            const auto same_pattern = (permuted_A.nonZeros() == p_permuted_A.nonZeros());
+            if (same_pattern and Update::rank_of_difference(permuted_A, p_permuted_A, maximum_rank) <= maximum_rank) {
+                // Lower triangular part of the modification, without the coefficients that didn't change
+                Matrix dA = (permuted_A - p_permuted_A).transpose();
+                dA.prune([](const Eigen::Index &, const Eigen::Index &, const typename Matrix::Scalar & v) { return v != 0; });
+
+                std::vector<typename Update::SparseVector> updates, downdates;
+                Update::decompose(dA, updates, downdates);
+                const auto rank = updates.size() + downdates.size();
+
+                if (Update::update(FactorAccess::L(p_solver), FactorAccess::D(p_solver), updates, downdates)) {
+                    p_permuted_A = std::move(permuted_A);
+                    ++p_number_of_low_rank_updates;
+
+                    const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+                    d_factorization_time.setValue(static_cast<double>(elapsed) * 1e-6);
+                    msg_info() << "Factorization updated with " << rank << " rank-one modifications.";
+                    return true;
+                }
+
+                // The factors may have been partially updated, they must be computed again
+                p_factors_are_valid = false;
+            }
+        }
+
+        // Complete factorization
+        if (not factorize(A)) {
+            return false;
+        }
+
+        if (not p_permuted_A_is_factorized) {
+            p_permuted_A = A_->matrix().template triangularView<Eigen::Upper>();
+            p_permuted_A_is_factorized = true;
+        }
+
+        return true;
+    }
+}
+
+template<class EigenSolver_t>
+bool LDLTSolver<EigenSolver_t>::update_factorization(const sofa::defaulttype::BaseMatrix * W, bool downdate) {
+    if constexpr (not solver_traits<EigenSolver_t>::is_eigen()) {
+        return false;
+    } else {
+        using FactorAccess = typename solver_traits<EigenSolver_t>::FactorAccess;
+        using Update = CholeskyUpdate<typename Matrix::Scalar, typename Matrix::StorageIndex>;
+
+        auto W_ = dynamic_cast<const SofaCaribou::Algebra::EigenMatrix<Matrix> *>(W);
+        if (not W_) {
+            throw std::runtime_error("Tried to update the factorization with an incompatible matrix (not an Eigen matrix).");
+        }
+
+        if (not p_factors_are_valid or W_->rows() != p_solver.rows()) {
+            return false;
+        }
+
+        // The vectors are expressed in the permuted space of the factors
+        std::vector<typename Update::SparseVector> vectors;
+        vectors.reserve(W_->cols());
+        if (p_P.size() > 0) {
+            const Matrix PW = p_P * W_->matrix();
+            for (Eigen::Index k = 0; k < PW.cols(); ++k) {
+                vectors.emplace_back(PW.col(k));
+            }
+        } else {
+            for (Eigen::Index k = 0; k < W_->matrix().cols(); ++k) {
+                vectors.emplace_back(W_->matrix().col(k));
+            }
+        }
+
+        // The factors won't match the last factorized matrix anymore
+        p_permuted_A_is_factorized = false;
+
+        const std::vector<typename Update::SparseVector> none;
+        if (not Update::update(FactorAccess::L(p_solver), FactorAccess::D(p_solver),
+                               downdate ? none : vectors,
+                               downdate ? vectors : none)) {
+            // The factors may have been partially updated, the matrix must be factorized again before the next solve
+            p_factors_are_valid = false;
+            return false;
+        }
+
+        return true;
+    }
 }
 
 template<class EigenSolver_t>
 bool LDLTSolver<EigenSolver_t>::solve(const sofa::defaulttype::BaseVector * F,
                                       sofa::defaulttype::BaseVector *X) const {
-    auto F_ = dynamic_cast<const SofaCaribou::Algebra::EigenVector<Vector> *>(F);
-    auto X_ = dynamic_cast<SofaCaribou::Algebra::EigenVector<Vector> *>(X);
+    auto F_ = SofaCaribou::Algebra::eigen_vector_view<Vector>(F);
+    auto X_ = SofaCaribou::Algebra::eigen_vector_view<Vector>(X);
+    if (not F_ or not X_ or not p_factors_are_valid) {
+        return false;
+    }
 
-    X_->vector() = p_solver.solve(F_->vector());
+    if (p_P.size() > 0) {
+        // P A P^-1 (P x) = P b
+        *X_ = p_Pinv * p_solver.solve(p_P * (*F_));
+    } else {
+        *X_ = p_solver.solve(*F_);
+    }
     return (p_solver.info() == Eigen::Success);
 }
 
+template<class EigenSolver_t>
+auto LDLTSolver<EigenSolver_t>::ordering_method() const -> OrderingMethod {
+    const auto v = static_cast<OrderingMethod>(d_ordering.getValue().getSelectedId());
+    switch (v) {
+        case OrderingMethod::Natural:
+        case OrderingMethod::AMD:
+        case OrderingMethod::COLAMD:
+        case OrderingMethod::NestedDissection:
+            return v;
+    }
+
+    // Default value
+    return OrderingMethod::AMD;
+}
+
+template<class EigenSolver_t>
+void LDLTSolver<EigenSolver_t>::set_ordering_method(const OrderingMethod & method) {
+    using namespace sofa::helper;
+    auto ordering = WriteOnlyAccessor<Data<OptionsGroup>>(d_ordering);
+    ordering->setSelectedItem(static_cast<unsigned int> (method));
+}
+
 template<class EigenSolver_t>
 std::string LDLTSolver<EigenSolver_t>::BackendName() {
     return solver_traits<EigenSolver_t>::BackendName();
@@ -89,6 +319,28 @@ LDLTSolver<EigenSolver_t>::LDLTSolver()
     Eigen:   Eigen LDLT solver (SimplicialLDLT) [default].
     Pardiso: Pardiso LDLT solver.
   )" , true /*displayed_in_GUI*/, true /*read_only_in_GUI*/))
+, d_ordering(initData(&d_ordering
+, "ordering"
+, R"(
+    Fill-reducing ordering applied to the system matrix prior to its factorization. Ignored by the Pardiso backend,
+    which computes its own ordering.
+
+    Available orderings are:
+    Natural:          No ordering, the matrix is factorized as assembled.
+    AMD:              Approximate minimum degree ordering [default].
+    COLAMD:           Column approximate minimum degree ordering.
+    NestedDissection: Nested dissection of the matrix graph. Usually faster than AMD on large 3D meshes.
+  )"))
+, d_factor_non_zeros(initData(&d_factor_non_zeros
+, (unsigned int) 0
+, "factor_non_zeros"
+, "Number of non-zero coefficients of the factor L computed by the last factorization."
+, true /*displayed_in_GUI*/, true /*read_only_in_GUI*/))
+, d_factorization_time(initData(&d_factorization_time
+, 0.
+, "factorization_time"
+, "Time (in milliseconds) took by the last numerical factorization."
+, true /*displayed_in_GUI*/, true /*read_only_in_GUI*/))
 {
     d_backend.setValue(sofa::helper::OptionsGroup(std::vector < std::string > {
             "Eigen", "Pardiso"
@@ -107,6 +359,9 @@ LDLTSolver<EigenSolver_t>::LDLTSolver()
         backend->setSelectedItem(static_cast<unsigned int>(0));
     }
 
+    d_ordering.setValue(sofa::helper::OptionsGroup(ordering_method_names()));
+    set_ordering_method(OrderingMethod::AMD);
+
     // Explicitly state that the matrix is symmetric (would not be possible to do an LDLT decomposition otherwise)
     this->set_symmetric(true);
 }
@@ -7,7 +7,7 @@ DISABLE_ALL_WARNINGS_END
 namespace SofaCaribou::solver {
 
 static int SparseLLTSolverClass = sofa::core::RegisterObject("Caribou Sparse LLT linear solver")
-    .add< LLTSolver<Eigen::SimplicialLLT<Eigen::SparseMatrix<FLOATING_POINT_TYPE, Eigen::ColMajor, int>, Eigen::Lower, Eigen::AMDOrdering<int>>> >(true)
+    .add< LLTSolver<Eigen::SimplicialLLT<Eigen::SparseMatrix<FLOATING_POINT_TYPE, Eigen::ColMajor, int>, Eigen::Upper, Eigen::NaturalOrdering<int>>> >(true)
 #ifdef CARIBOU_WITH_MKL
     .add< LLTSolver<Eigen::PardisoLLT<Eigen::SparseMatrix<FLOATING_POINT_TYPE, Eigen::RowMajor, int>>> >()
 #endif
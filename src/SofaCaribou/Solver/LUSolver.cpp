@@ -7,7 +7,7 @@ DISABLE_ALL_WARNINGS_END
 namespace SofaCaribou::solver {
 
 static int SparseLUSolverClass = sofa::core::RegisterObject("Caribou Sparse LU linear solver")
-    .add< LUSolver<Eigen::SparseLU<Eigen::SparseMatrix<FLOATING_POINT_TYPE, Eigen::ColMajor, int>, Eigen::AMDOrdering<int>>> >(true)
+    .add< LUSolver<Eigen::SparseLU<Eigen::SparseMatrix<FLOATING_POINT_TYPE, Eigen::ColMajor, int>, Eigen::NaturalOrdering<int>>> >(true)
 #ifdef CARIBOU_WITH_MKL
     .add< LUSolver<Eigen::PardisoLU<Eigen::SparseMatrix<FLOATING_POINT_TYPE, Eigen::RowMajor, int>>> >()
 #endif
@@ -2,6 +2,7 @@
 
 #include <SofaCaribou/config.h>
 #include <SofaCaribou/Solver/EigenSolver.h>
+#include <SofaCaribou/Solver/Ordering.h>
 
 DISABLE_ALL_WARNINGS_BEGIN
 #include <sofa/helper/OptionsGroup.h>
@@ -49,16 +50,60 @@ public:
      */
     inline void set_symmetric(bool is_symmetric) override { d_is_symmetric.setValue(is_symmetric); }
 
+    /** Get the current fill-reducing ordering method. */
+    CARIBOU_API
+    auto ordering_method() const -> OrderingMethod;
+
+    /** Set the fill-reducing ordering method. It will be used on the next symbolic analysis. */
+    CARIBOU_API
+    void set_ordering_method(const OrderingMethod & method);
+
+    /** Number of non-zero coefficients of the factors computed by the last numerical factorization. */
+    auto factor_non_zeros() const -> unsigned int { return d_factor_non_zeros.getValue(); }
+
     // Get the backend name of the class derived from the EigenSolver template parameter
     CARIBOU_API
     static std::string BackendName();
 private:
+    /**
+     * Check if the current symbolic analysis was done on a matrix having the sparsity pattern of the given fingerprint,
+     * using the current ordering method (which can be changed at any time).
+     */
+    auto analysis_is_valid(std::uint64_t fingerprint) const -> bool {
+        return this->pattern_is_analyzed(fingerprint) and p_analyzed_ordering == ordering_method();
+    }
+
+    /**
+     * Symbolic analysis (ordering and symbolic factorization) of the matrix A, whose sparsity pattern has the given
+     * fingerprint (see SofaCaribou::Algebra::pattern_fingerprint).
+     */
+    bool analyze(const Matrix & A, std::uint64_t fingerprint);
+
     /// Solver backend used (Eigen or Pardiso)
     Data<sofa::helper::OptionsGroup> d_backend;
 
     /// States if the system matrix is symmetric. This will enable some optimizations.
     Data<bool> d_is_symmetric;
 
+    /// Fill-reducing ordering applied prior to the factorization (Eigen backend only)
+    Data<sofa::helper::OptionsGroup> d_ordering;
+
+    /// OUTPUTS
+    /// Number of non-zero coefficients of the factors computed by the last numerical factorization
+    Data<unsigned int> d_factor_non_zeros;
+
+    /// Time (in milliseconds) took by the last numerical factorization
+    Data<double> d_factorization_time;
+
+    /// Fill-reducing permutation P computed during the symbolic analysis, and its inverse (empty for the natural ordering)
+    Eigen::PermutationMatrix<Eigen::Dynamic, Eigen::Dynamic, int> p_P, p_Pinv;
+
+    /// Permuted system matrix P A P^-1 (only used when the permutation isn't empty)
+    Matrix p_permuted_A;
+
+    /// Ordering method used by the last symbolic analysis
+    OrderingMethod p_analyzed_ordering = OrderingMethod::Natural;
+
     /// The actual Eigen solver used (its type is passed as a template parameter and must be derived from Eigen::SparseSolverBase)
     EigenSolver_t p_solver;
 };
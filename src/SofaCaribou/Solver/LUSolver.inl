@@ -7,6 +7,7 @@
 
 #include <algorithm>
 #include <cctype>
+#include <chrono>
 #include <string>
 
 #ifdef CARIBOU_WITH_MKL
@@ -29,7 +30,9 @@ template<typename MatrixType, typename Ordering>
 struct solver_traits<Eigen::SparseLU < MatrixType, Ordering>> {
 static auto BackendName() -> std::string { return "Eigen"; }
 static constexpr auto is_eigen() -> bool {return true;}
-
+static auto factor_non_zeros(const Eigen::SparseLU < MatrixType, Ordering> & solver) -> Eigen::Index {
+    return solver.nnzL() + solver.nnzU();
+}
 };
 
 #ifdef CARIBOU_WITH_MKL
@@ -37,6 +40,9 @@ template<typename MatrixType>
 struct solver_traits <Eigen::PardisoLU< MatrixType >> {
     static auto BackendName() -> std::string {return "Pardiso";}
     static constexpr auto is_eigen() -> bool {return false;}
+    static auto factor_non_zeros(Eigen::PardisoLU< MatrixType > & solver) -> Eigen::Index {
+        return solver.pardisoParameterArray()[17]; // Output: Number of nonzeros in the factors
+    }
 };
 #endif
 }
@@ -48,13 +54,44 @@ bool LUSolver<EigenSolver_t>::analyze_pattern(const sofa::defaulttype::BaseMatri
         throw std::runtime_error("Tried to analyze an incompatible matrix (not an Eigen matrix).");
     }
 
+    // The symbolic analysis is skipped when the structure of the matrix didn't change since the last one
+    const auto fingerprint = SofaCaribou::Algebra::pattern_fingerprint(A_->matrix());
+    if (analysis_is_valid(fingerprint)) {
+        return true;
+    }
+
+    return analyze(A_->matrix(), fingerprint);
+}
+
+template<class EigenSolver_t>
+bool LUSolver<EigenSolver_t>::analyze(const Matrix & A, std::uint64_t fingerprint) {
     if constexpr (solver_traits<EigenSolver_t>::is_eigen()) {
         p_solver.isSymmetric(symmetric());
+
+        // The Eigen backend uses the natural ordering, the fill-reducing permutation is applied here instead. The
+        // permutation is symmetric (P A P^-1), which keeps the diagonal entries on the diagonal.
+        compute_ordering(ordering_method(), A, p_Pinv);
+        if (p_Pinv.size() > 0) {
+            p_P = p_Pinv.inverse();
+            p_permuted_A = (p_P * A) * p_Pinv;
+            p_solver.analyzePattern(p_permuted_A);
+        } else {
+            p_P.resize(0);
+            p_permuted_A.resize(0, 0);
+            p_solver.analyzePattern(A);
+        }
+    } else {
+        // Pardiso computes its own (nested dissection) ordering
+        p_solver.analyzePattern(A);
     }
 
-    p_solver.analyzePattern(A_->matrix());
+    if (p_solver.info() != Eigen::Success) {
+        return false;
+    }
 
-    return (p_solver.info() == Eigen::Success);
+    this->set_analyzed_pattern(fingerprint);
+    p_analyzed_ordering = ordering_method();
+    return true;
 }
 
 template<class EigenSolver_t>
@@ -64,21 +101,75 @@ bool LUSolver<EigenSolver_t>::factorize(const sofa::defaulttype::BaseMatrix *A)
         throw std::runtime_error("Tried to analyze an incompatible matrix (not an Eigen matrix).");
     }
 
-    p_solver.factorize(A_->matrix());
+    // The structure of the matrix changed since the last symbolic analysis (for example, new contacts appeared), even
+    // if its size may be the same: the analysis must be done again before the numerical factorization
+    const auto fingerprint = SofaCaribou::Algebra::pattern_fingerprint(A_->matrix());
+    if (not analysis_is_valid(fingerprint)) {
+        if (not analyze(A_->matrix(), fingerprint)) {
+            return false;
+        }
+    }
 
-    return (p_solver.info() == Eigen::Success);
+    const auto start = std::chrono::steady_clock::now();
+
+    if (p_P.size() > 0) {
+        p_permuted_A = (p_P * A_->matrix()) * p_Pinv;
+        p_solver.factorize(p_permuted_A);
+    } else {
+        p_solver.factorize(A_->matrix());
+    }
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    d_factorization_time.setValue(static_cast<double>(elapsed) * 1e-6);
+
+    if (p_solver.info() != Eigen::Success) {
+        return false;
+    }
+
+    d_factor_non_zeros.setValue(static_cast<unsigned int>(solver_traits<EigenSolver_t>::factor_non_zeros(p_solver)));
+    return true;
 }
 
 template<class EigenSolver_t>
 bool LUSolver<EigenSolver_t>::solve(const sofa::defaulttype::BaseVector * F,
                                      sofa::defaulttype::BaseVector *X) const {
-    auto F_ = dynamic_cast<const SofaCaribou::Algebra::EigenVector<Vector> *>(F);
-    auto X_ = dynamic_cast<SofaCaribou::Algebra::EigenVector<Vector> *>(X);
+    auto F_ = SofaCaribou::Algebra::eigen_vector_view<Vector>(F);
+    auto X_ = SofaCaribou::Algebra::eigen_vector_view<Vector>(X);
+    if (not F_ or not X_) {
+        return false;
+    }
 
-    X_->vector() = p_solver.solve(F_->vector());
+    if (p_P.size() > 0) {
+        // P A P^-1 (P x) = P b
+        *X_ = p_Pinv * p_solver.solve(p_P * (*F_));
+    } else {
+        *X_ = p_solver.solve(*F_);
+    }
     return (p_solver.info() == Eigen::Success);
 }
 
+template<class EigenSolver_t>
+auto LUSolver<EigenSolver_t>::ordering_method() const -> OrderingMethod {
+    const auto v = static_cast<OrderingMethod>(d_ordering.getValue().getSelectedId());
+    switch (v) {
+        case OrderingMethod::Natural:
+        case OrderingMethod::AMD:
+        case OrderingMethod::COLAMD:
+        case OrderingMethod::NestedDissection:
+            return v;
+    }
+
+    // Default value
+    return OrderingMethod::AMD;
+}
+
+template<class EigenSolver_t>
+void LUSolver<EigenSolver_t>::set_ordering_method(const OrderingMethod & method) {
+    using namespace sofa::helper;
+    auto ordering = WriteOnlyAccessor<Data<OptionsGroup>>(d_ordering);
+    ordering->setSelectedItem(static_cast<unsigned int> (method));
+}
+
 template<class EigenSolver_t>
 std::string LUSolver<EigenSolver_t>::BackendName() {
     return solver_traits<EigenSolver_t>::BackendName();
@@ -100,6 +191,28 @@ LUSolver<EigenSolver_t>::LUSolver()
     "symmetric",
     "States if the system matrix is symmetric. This will enable some optimizations. Default to false.",
     true /*displayed_in_GUI*/, true /*read_only_in_GUI*/))
+, d_ordering(initData(&d_ordering
+, "ordering"
+,    R"(
+         Fill-reducing ordering applied to the system matrix prior to its factorization. Ignored by the Pardiso
+         backend, which computes its own ordering.
+
+         Available orderings are:
+         Natural:          No ordering, the matrix is factorized as assembled.
+         AMD:              Approximate minimum degree ordering [default].
+         COLAMD:           Column approximate minimum degree ordering.
+         NestedDissection: Nested dissection of the matrix graph. Usually faster than AMD on large 3D meshes.
+     )"))
+, d_factor_non_zeros(initData(&d_factor_non_zeros,
+    (unsigned int) 0,
+    "factor_non_zeros",
+    "Number of non-zero coefficients of the factors L and U computed by the last factorization.",
+    true /*displayed_in_GUI*/, true /*read_only_in_GUI*/))
+, d_factorization_time(initData(&d_factorization_time,
+    0.,
+    "factorization_time",
+    "Time (in milliseconds) took by the last numerical factorization.",
+    true /*displayed_in_GUI*/, true /*read_only_in_GUI*/))
 {
     d_backend.setValue(sofa::helper::OptionsGroup(std::vector < std::string > {
             "Eigen", "Pardiso"
@@ -117,6 +230,9 @@ LUSolver<EigenSolver_t>::LUSolver()
     } else {
         backend->setSelectedItem(static_cast<unsigned int>(0));
     }
+
+    d_ordering.setValue(sofa::helper::OptionsGroup(ordering_method_names()));
+    set_ordering_method(OrderingMethod::AMD);
 }
 
 
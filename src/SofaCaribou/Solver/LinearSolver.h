@@ -2,6 +2,8 @@
 
 #include <SofaCaribou/config.h>
 
+#include <vector>
+
 namespace sofa::defaulttype {
 class BaseMatrix;
 class BaseVector;
@@ -57,12 +59,54 @@ public:
      *
      * @return True when the system has been successfully solved, false otherwise.
      *
-     * @note The vectors must be of the virtual type SofaCaribou::Algebra::EigenVector<Vector>
+     * @note The vectors must be of the virtual type SofaCaribou::Algebra::EigenVector<Vector>, or
+     *       SofaCaribou::Algebra::EigenVector<Eigen::Map<Vector>> (see SofaCaribou::Algebra::eigen_vector_view)
      * @note LinearSolver::factorize must have been called before this method.
      */
     virtual bool solve(const sofa::defaulttype::BaseVector * F,
                        sofa::defaulttype::BaseVector * X) const = 0;
 
+    /**
+     * Solve the linear systems A [X_i] = F_i for many right-hand side vectors sharing the same system matrix.
+     *
+     * The default implementation solves the systems one after the other. Solvers that can handle many right-hand
+     * sides at once (for example, by doing a single pass over the matrix for all the vectors) should override it.
+     *
+     * @param F The right-hand side (RHS) vectors.
+     * @param X The left-hand side (LHS) solution vectors, one for each RHS vector.
+     *
+     * @return True when all the systems have been successfully solved, false otherwise.
+     *
+     * @note The vectors must be of the virtual type SofaCaribou::Algebra::EigenVector<Vector>, or
+     *       SofaCaribou::Algebra::EigenVector<Eigen::Map<Vector>> (see SofaCaribou::Algebra::eigen_vector_view)
+     * @note LinearSolver::factorize must have been called before this method.
+     */
+    virtual bool solve_multiple(const std::vector<const sofa::defaulttype::BaseVector *> & F,
+                                const std::vector<sofa::defaulttype::BaseVector *> & X) const {
+        if (F.size() != X.size()) {
+            return false;
+        }
+
+        for (std::size_t i = 0; i < F.size(); ++i) {
+            if (not solve(F[i], X[i])) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * Set the forcing term of an inexact Newton method.
+     *
+     * Iterative solvers may then stop as soon as the relative residual |F - A X| / |F| of the next calls to solve is
+     * lower than this forcing term, even if it is larger than their own convergence criterion. Solvers never
+     * iterate more than with their own criterion. Direct solvers ignore the forcing term.
+     *
+     * @param forcing_term The relative residual tolerance. Use zero to restore the solver's own criterion.
+     */
+    virtual void set_forcing_term(FLOATING_POINT_TYPE /*forcing_term*/) {}
+
     /**
      * Analyze the pattern of the given matrix.
      *
@@ -80,11 +124,50 @@ public:
      *
      * This should be done before a call to solve.
      *
+     * @note Some solvers (for example, iterative solvers) only keep a reference to the matrix A. Hence, A must stay
+     *       alive and unchanged as long as its factorization is used to solve systems.
+     *
      * @param A The matrix to factorize.
      * @return True if the matrix was successfully factorized, false otherwise.
      */
     virtual bool factorize(const sofa::defaulttype::BaseMatrix * A) = 0;
 
+    /**
+     * Factorize the given matrix, knowing that it is a modification of the matrix given to the last factorization.
+     *
+     * Solvers that support low-rank updates (see LinearSolver::update_factorization) only update their current factors
+     * when the difference between the two matrices can be expressed with at most maximum_rank rank-one modifications,
+     * which is much cheaper than a complete factorization when only a few coefficients changed (for example, when a few
+     * elements were cut). Other solvers, or larger modifications, lead to a complete factorization.
+     *
+     * @param A The matrix to factorize.
+     * @param maximum_rank The maximum number of rank-one modifications for which the factors are updated.
+     * @return True if the matrix was successfully factorized, false otherwise.
+     */
+    virtual bool refactorize(const sofa::defaulttype::BaseMatrix * A, unsigned int /*maximum_rank*/) {
+        return factorize(A);
+    }
+
+    /**
+     * Update the current factorization of the system matrix A into the one of A + W W^T (update), or A - W W^T
+     * (downdate), without factorizing the modified matrix.
+     *
+     * Each of the k columns of W is the vector w of a rank-one modification w w^T. The cost of the update is
+     * proportional to the number of non-zeros of the factors touched by these vectors, which is usually a small
+     * fraction of the cost of a complete factorization when W is sparse and k is small.
+     *
+     * @param W The n x k matrix of the modification, where n is the size of the system matrix.
+     * @param downdate True to subtract the modification (A - W W^T), false to add it (A + W W^T).
+     * @return True if the factors were updated. False if the solver doesn't support low-rank updates, or if the
+     *         modification can't be applied to the current factors (in which case the matrix must be factorized again
+     *         before the next solve).
+     *
+     * @note LinearSolver::factorize must have been called before this method.
+     */
+    virtual bool update_factorization(const sofa::defaulttype::BaseMatrix * /*W*/, bool /*downdate*/) {
+        return false;
+    }
+
 };
 
 } // namespace SofaCaribou::solver
@@ -0,0 +1,315 @@
+#pragma once
+
+#include <SofaCaribou/config.h>
+
+#include <Eigen/Sparse>
+#include <Eigen/OrderingMethods>
+
+#include <algorithm>
+#include <cstdlib>
+#include <numeric>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace SofaCaribou::solver {
+
+/**
+ * Fill-reducing orderings of the direct solvers.
+ *
+ * The ordering is a symmetric permutation P of the system matrix computed during the symbolic analysis, and applied
+ * prior to the numerical factorization such that the factorized matrix is P A P^-1. The amount of fill-in (hence the
+ * memory footprint and the factorization time) of the factors highly depends on it.
+ */
+enum class OrderingMethod : unsigned int {
+    /** No permutation: the matrix is factorized as assembled */
+    Natural = 0,
+
+    /** Approximate minimum degree ordering (Eigen::AMDOrdering) */
+    AMD,
+
+    /** Column approximate minimum degree ordering (Eigen::COLAMDOrdering) */
+    COLAMD,
+
+    /** Nested dissection ordering of the matrix graph (SofaCaribou::solver::NestedDissectionOrdering) */
+    NestedDissection
+};
+
+/** Names of the ordering methods, in the order of the OrderingMethod enumeration (used by the OptionsGroup Data). */
+inline auto ordering_method_names() -> std::vector<std::string> {
+    return {"Natural", "AMD", "COLAMD", "NestedDissection"};
+}
+
+/**
+ * Nested dissection ordering of the symmetric graph of a sparse matrix.
+ *
+ * The graph is recursively split in two parts by a vertex separator found from a level structure: a breadth-first
+ * search is done from a pseudo-peripheral node and the level that best balances the nodes before and after it is
+ * taken as the separator. Both parts are ordered first (recursively), and the separator last, such that no fill-in
+ * can appear between the two parts during the factorization. Disconnected components are split without separator.
+ * Parts having less than leaf_size nodes are kept in their natural order.
+ *
+ * On large three-dimensional meshes, the fill-in of the factors is usually close to the one of the AMD ordering, but
+ * the elimination tree is much more balanced, which tends to speed up the numerical factorization.
+ *
+ * This class follows the interface of the Eigen ordering functors (Eigen::AMDOrdering, Eigen::COLAMDOrdering, ...),
+ * and can hence be given directly to the Eigen solvers.
+ */
+template <typename StorageIndex>
+class NestedDissectionOrdering {
+public:
+    using PermutationType = Eigen::PermutationMatrix<Eigen::Dynamic, Eigen::Dynamic, StorageIndex>;
+
+    /**
+     * Compute the permutation of the matrix mat. Only the pattern of mat is used, and it doesn't have to be symmetric
+     * (the pattern of mat + mat^T is used).
+     * @param mat The sparse matrix
+     * @param perm The permutation, such that perm.indices()[i] is the index of the unknown eliminated in ith position
+     */
+    template <typename MatrixType>
+    void operator()(const MatrixType & mat, PermutationType & perm) {
+        const auto n = static_cast<StorageIndex>(mat.rows());
+        build_graph(mat);
+
+        p_part.assign(n, 0);
+        p_level.assign(n, -1);
+        p_order.clear();
+        p_order.reserve(n);
+        p_number_of_parts = 1;
+
+        std::vector<StorageIndex> nodes(n);
+        std::iota(nodes.begin(), nodes.end(), 0);
+        dissect(std::move(nodes));
+
+        perm.resize(n);
+        std::copy(p_order.begin(), p_order.end(), perm.indices().data());
+    }
+
+    /** Parts having this number of nodes or less are not dissected further. */
+    Eigen::Index leaf_size = 64;
+
+private:
+    /**
+     * Build the adjacency lists (in compressed format) of the graph of mat + mat^T, without self loops.
+     */
+    template <typename MatrixType>
+    void build_graph(const MatrixType & mat) {
+        const auto n = static_cast<StorageIndex>(mat.rows());
+        std::vector<std::vector<StorageIndex>> neighbors(n);
+        for (Eigen::Index j = 0; j < mat.outerSize(); ++j) {
+            for (typename MatrixType::InnerIterator it(mat, j); it; ++it) {
+                const auto row = static_cast<StorageIndex>(it.row());
+                const auto col = static_cast<StorageIndex>(it.col());
+                if (row != col) {
+                    neighbors[row].push_back(col);
+                    neighbors[col].push_back(row);
+                }
+            }
+        }
+
+        p_xadj.assign(n+1, 0);
+        for (StorageIndex i = 0; i < n; ++i) {
+            auto & list = neighbors[i];
+            std::sort(list.begin(), list.end());
+            list.erase(std::unique(list.begin(), list.end()), list.end());
+            p_xadj[i+1] = p_xadj[i] + static_cast<StorageIndex>(list.size());
+        }
+
+        p_adj.resize(p_xadj[n]);
+        for (StorageIndex i = 0; i < n; ++i) {
+            std::copy(neighbors[i].begin(), neighbors[i].end(), p_adj.begin() + p_xadj[i]);
+        }
+    }
+
+    /**
+     * Breadth-first search from the node root, restricted to the nodes of the given part. The visited nodes are
+     * stored level by level, the level l being visited[level_start[l]] to visited[level_start[l+1]-1].
+     */
+    void bfs(StorageIndex root, StorageIndex part, std::vector<StorageIndex> & visited, std::vector<StorageIndex> & level_start) {
+        visited.clear();
+        level_start.assign(1, 0);
+
+        visited.push_back(root);
+        p_level[root] = 0;
+        for (std::size_t head = 0; head < visited.size(); ++head) {
+            const auto v = visited[head];
+            if (p_level[v] != p_level[visited[level_start.back()]]) {
+                level_start.push_back(static_cast<StorageIndex>(head));
+            }
+            for (auto k = p_xadj[v]; k < p_xadj[v+1]; ++k) {
+                const auto w = p_adj[k];
+                if (p_part[w] == part and p_level[w] < 0) {
+                    p_level[w] = p_level[v] + 1;
+                    visited.push_back(w);
+                }
+            }
+        }
+        level_start.push_back(static_cast<StorageIndex>(visited.size()));
+    }
+
+    /**
+     * Compute the elimination order of the given nodes (the part 0).
+     *
+     * The parts still to be ordered are kept on an explicit stack instead of recursing, since a graph made of many
+     * disconnected components (a diagonal matrix, for example) would otherwise need one nested call per component. The
+     * elimination order is built backward and reversed at the end: the separator of a part comes after both sub-parts.
+     */
+    void dissect(std::vector<StorageIndex> nodes) {
+        std::vector<std::pair<std::vector<StorageIndex>, StorageIndex>> parts;
+        parts.emplace_back(std::move(nodes), 0);
+
+        const auto degree = [this] (StorageIndex v) { return p_xadj[v+1] - p_xadj[v]; };
+        const auto reset_levels = [this] (const std::vector<StorageIndex> & list) {
+            for (const auto v : list) {
+                p_level[v] = -1;
+            }
+        };
+        const auto eliminate = [this] (const std::vector<StorageIndex> & list) {
+            p_order.insert(p_order.end(), list.rbegin(), list.rend());
+        };
+        const auto push = [this, &parts] (std::vector<StorageIndex> && list) {
+            const auto new_part = p_number_of_parts++;
+            for (const auto v : list) {
+                p_part[v] = new_part;
+            }
+            parts.emplace_back(std::move(list), new_part);
+        };
+
+        std::vector<StorageIndex> visited, level_start;
+        while (not parts.empty()) {
+            auto part_nodes = std::move(parts.back().first);
+            const auto part = parts.back().second;
+            parts.pop_back();
+
+            if (static_cast<Eigen::Index>(part_nodes.size()) <= leaf_size) {
+                eliminate(part_nodes);
+                continue;
+            }
+
+            bfs(part_nodes[0], part, visited, level_start);
+
+            if (visited.size() < part_nodes.size()) {
+                // Disconnected part: all of its connected components are ordered independently, without separator
+                std::vector<std::vector<StorageIndex>> components {visited};
+                for (const auto v : part_nodes) {
+                    if (p_level[v] < 0) {
+                        bfs(v, part, visited, level_start);
+                        components.push_back(visited);
+                    }
+                }
+                reset_levels(part_nodes);
+                for (auto & component : components) {
+                    push(std::move(component));
+                }
+                continue;
+            }
+
+            // Find a pseudo-peripheral node: the node of lowest degree in the last level of the first breadth-first search
+            auto root = visited[level_start[level_start.size()-2]];
+            for (auto k = level_start[level_start.size()-2]; k < level_start.back(); ++k) {
+                if (degree(visited[k]) < degree(root)) {
+                    root = visited[k];
+                }
+            }
+            reset_levels(visited);
+
+            // Level structure rooted at the pseudo-peripheral node
+            bfs(root, part, visited, level_start);
+            const auto number_of_levels = static_cast<StorageIndex>(level_start.size()) - 1;
+
+            if (number_of_levels < 3) {
+                // Too narrow to be dissected
+                reset_levels(visited);
+                eliminate(part_nodes);
+                continue;
+            }
+
+            // Take the level that best balances the two remaining parts as the separator
+            const auto N = static_cast<StorageIndex>(visited.size());
+            StorageIndex m = 1;
+            StorageIndex best_imbalance = N;
+            for (StorageIndex l = 1; l < number_of_levels-1; ++l) {
+                const auto imbalance = std::abs(level_start[l] - (N - level_start[l+1]));
+                if (imbalance < best_imbalance) {
+                    best_imbalance = imbalance;
+                    m = l;
+                }
+            }
+
+            std::vector<StorageIndex> first(visited.begin(), visited.begin()+level_start[m]);
+            std::vector<StorageIndex> second(visited.begin()+level_start[m+1], visited.end());
+            std::vector<StorageIndex> separator;
+
+            // Separator nodes that are not connected to the second part are moved to the first one
+            for (auto k = level_start[m]; k < level_start[m+1]; ++k) {
+                const auto s = visited[k];
+                bool touches_second_part = false;
+                for (auto j = p_xadj[s]; j < p_xadj[s+1] and not touches_second_part; ++j) {
+                    const auto w = p_adj[j];
+                    touches_second_part = (p_part[w] == part and p_level[w] == m+1);
+                }
+                (touches_second_part ? separator : first).push_back(s);
+            }
+
+            reset_levels(visited);
+            part_nodes.clear();
+            part_nodes.shrink_to_fit();
+
+            for (const auto v : separator) {
+                p_part[v] = -1;
+            }
+            eliminate(separator);
+            push(std::move(first));
+            push(std::move(second));
+        }
+
+        std::reverse(p_order.begin(), p_order.end());
+    }
+
+    ///< Adjacency lists of the graph (compressed format)
+    std::vector<StorageIndex> p_xadj, p_adj;
+
+    ///< Part of every nodes (-1 for separator nodes), level of every nodes during a breadth-first search (-1 if not visited)
+    std::vector<StorageIndex> p_part, p_level;
+
+    ///< Elimination order
+    std::vector<StorageIndex> p_order;
+    StorageIndex p_number_of_parts = 0;
+};
+
+/**
+ * Compute the fill-reducing ordering of the sparse matrix A using the given method.
+ *
+ * The permutation follows the convention of the Eigen ordering functors (Pinv.indices()[i] is the index of the unknown
+ * eliminated in ith position). It is left empty for the natural ordering.
+ */
+template <typename Scalar, int Options, typename StorageIndex>
+void compute_ordering(const OrderingMethod & method,
+                      const Eigen::SparseMatrix<Scalar, Options, StorageIndex> & A,
+                      Eigen::PermutationMatrix<Eigen::Dynamic, Eigen::Dynamic, StorageIndex> & Pinv) {
+    switch (method) {
+        case OrderingMethod::AMD: {
+            Eigen::AMDOrdering<StorageIndex> ordering;
+            ordering(A, Pinv);
+            break;
+        }
+        case OrderingMethod::COLAMD: {
+            // COLAMD reads the raw column arrays, hence the matrix needs to be compressed and column major
+            Eigen::SparseMatrix<Scalar, Eigen::ColMajor, StorageIndex> C = A;
+            C.makeCompressed();
+            Eigen::COLAMDOrdering<StorageIndex> ordering;
+            ordering(C, Pinv);
+            break;
+        }
+        case OrderingMethod::NestedDissection: {
+            NestedDissectionOrdering<StorageIndex> ordering;
+            ordering(A, Pinv);
+            break;
+        }
+        case OrderingMethod::Natural:
+            Pinv.resize(0);
+            break;
+    }
+}
+
+} // namespace SofaCaribou::solver
@@ -1,8 +1,22 @@
 #include <SofaCaribou/Visitor/ConstrainGlobalMatrix.h>
+#include <SofaCaribou/Algebra/BatchedClearing.h>
 
 namespace SofaCaribou::visitor {
 using namespace sofa::core;
 
+void ConstrainGlobalMatrix::execute(sofa::core::objectmodel::BaseContext * context, bool precomputedOrder) {
+    auto * batched_matrix = dynamic_cast<SofaCaribou::Algebra::BatchedClearing *>(p_global_matrix);
+    if (batched_matrix) {
+        batched_matrix->begin_batched_clearing();
+    }
+
+    Base::execute(context, precomputedOrder);
+
+    if (batched_matrix) {
+        batched_matrix->end_batched_clearing();
+    }
+}
+
 auto ConstrainGlobalMatrix::fwdProjectiveConstraintSet(sofa::simulation::Node* /*node*/, sofa::core::behavior::BaseProjectiveConstraintSet* c) -> Result {
     c->applyConstraint(this->mparams, p_multi_matrix);
     return RESULT_CONTINUE;
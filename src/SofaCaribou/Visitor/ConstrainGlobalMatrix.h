@@ -22,6 +22,9 @@ namespace SofaCaribou::visitor {
  *      found for which `BaseMapping::areMatricesMapped` is true, call
  *      `BaseProjectiveConstraintSet::applyConstraint(mparams, matrix)` on every
  *      projective constraint sets found in the context node of the mapped mechanical object.
+ *
+ * When the global matrix is given and supports it (see SofaCaribou::Algebra::BatchedClearing), the rows and columns
+ * cleared by the constraints are all cleared at once with a single pass over the matrix at the end of the traversal.
  */
 class ConstrainGlobalMatrix : public sofa::simulation::MechanicalVisitor {
     using Base = sofa::simulation::MechanicalVisitor;
@@ -32,6 +35,12 @@ public:
     ConstrainGlobalMatrix(const MechanicalParams* mparams, const MultiMatrixAccessor* matrix )
         : Base(mparams), p_multi_matrix(matrix) {}
 
+    ConstrainGlobalMatrix(const MechanicalParams* mparams, const MultiMatrixAccessor* matrix, sofa::defaulttype::BaseMatrix * global_matrix)
+        : Base(mparams), p_multi_matrix(matrix), p_global_matrix(global_matrix) {}
+
+    CARIBOU_API
+    void execute(sofa::core::objectmodel::BaseContext * context, bool precomputedOrder = false) override;
+
     CARIBOU_API
     Result fwdProjectiveConstraintSet(sofa::simulation::Node * node, sofa::core::behavior::BaseProjectiveConstraintSet * c) override;
 
@@ -41,6 +50,7 @@ public:
     const char* getClassName() const override { return "ConstrainGlobalMatrix"; }
 private:
     const sofa::core::behavior::MultiMatrixAccessor * p_multi_matrix;
+    sofa::defaulttype::BaseMatrix * p_global_matrix = nullptr;
 };
 
 } // namespace SofaCaribou::visitor
\ No newline at end of file
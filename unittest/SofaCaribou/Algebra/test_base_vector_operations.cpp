@@ -5,6 +5,7 @@
 DISABLE_ALL_WARNINGS_BEGIN
 #include <SofaBaseLinearSolver/FullVector.h>
 #include <SofaCaribou/Algebra/BaseVectorOperations.h>
+#include <SofaCaribou/Algebra/EigenVector.h>
 DISABLE_ALL_WARNINGS_END
 
 #include <Eigen/Dense>
@@ -55,4 +56,33 @@ TEST(Algebra, SofaFullFFullDDotProduct) {
     }
 
     EXPECT_NEAR(SofaCaribou::Algebra::dot(&sofa_v1, &sofa_v2), v1.cast<double>().dot(v2), 1e-10);
-}
\ No newline at end of file
+}
+
+TEST(Algebra, EigenVectorFullDKernels) {
+    // Large enough to be split into many blocks
+    const auto n = 100000;
+    const Eigen::VectorXd v1 = Eigen::VectorXd::Random(n);
+    const Eigen::VectorXd v2 = Eigen::VectorXd::Random(n);
+
+    SofaCaribou::Algebra::EigenVector<Eigen::VectorXd> caribou_v1 (n);
+    sofa::component::linearsolver::FullVector<double> sofa_v2 (n);
+
+    caribou_v1.vector() = v1;
+    for (sofa::Index i = 0; i < n; ++i) {
+        sofa_v2[i] = v2[static_cast<Eigen::Index>(i)];
+    }
+
+    EXPECT_NEAR(SofaCaribou::Algebra::dot(&caribou_v1, &sofa_v2), v1.dot(v2), 1e-8);
+    EXPECT_NEAR(SofaCaribou::Algebra::squared_norm(&caribou_v1), v1.squaredNorm(), 1e-8);
+    EXPECT_NEAR(SofaCaribou::Algebra::norm(&sofa_v2), v2.norm(), 1e-8);
+
+    // v1 = v1 + 2*v2
+    SofaCaribou::Algebra::axpy(2., &sofa_v2, &caribou_v1);
+    EXPECT_NEAR((caribou_v1.vector() - (v1 + 2*v2)).norm(), 0, 1e-10);
+
+    // v2 = 0.5*v2
+    SofaCaribou::Algebra::scale(0.5, &sofa_v2);
+    for (sofa::Index i = 0; i < n; ++i) {
+        EXPECT_DOUBLE_EQ(sofa_v2[i], 0.5*v2[static_cast<Eigen::Index>(i)]);
+    }
+}
@@ -23,6 +23,9 @@ DISABLE_ALL_WARNINGS_END
 #include <Eigen/Dense>
 #include <Eigen/Sparse>
 
+#include <cstdlib>
+#include <vector>
+
 template<int nRows, int nColumns>
 using Matrix = Eigen::Matrix<FLOATING_POINT_TYPE, nRows, nColumns>;
 
@@ -196,3 +199,127 @@ TEST(Algebra, SparseMatrixByReference) {
     EXPECT_EQ(mm(30, 30), 200);
     EXPECT_EQ(m.coeff(30, 30), 200);
 }
+
+TEST(Algebra, SparseMatrixFrozenPattern) {
+    using EigenSparse = Eigen::SparseMatrix<double>;
+    using EigenMatrix = SofaCaribou::Algebra::EigenMatrix<EigenSparse>;
+
+    const int N = 30;
+    EigenMatrix frozen(N, N), reference(N, N);
+    frozen.set_pattern_frozen(true);
+    EXPECT_TRUE(frozen.pattern_is_frozen());
+    EXPECT_FALSE(reference.pattern_is_frozen());
+
+    // Assemble a few times the same matrix in the same order, once with a coefficient outside of the initial pattern
+    for (int assembly = 0; assembly < 4; ++assembly) {
+        frozen.clear();
+        reference.clear();
+        for (auto * m : {&frozen, &reference}) {
+            for (int i = 0; i < N-3; i += 3) {
+                m->add(i, i, Mat3x3d(assembly+1));
+                m->add(i, i+3, Mat3x3d(-1));
+                m->add(i+3, i, Mat3x3d(-1));
+            }
+            if (assembly == 2) {
+                m->add(0, N-1, 2.);
+            }
+            m->clearRowCol(4);
+            m->set(4, 4, 1.);
+            m->compress();
+        }
+
+        EXPECT_TRUE(frozen.matrix().isCompressed());
+        EXPECT_DOUBLE_EQ((Eigen::MatrixXd(frozen.matrix()) - Eigen::MatrixXd(reference.matrix())).norm(), 0.);
+    }
+
+    // The pattern is the union of the patterns of all the assemblies, the coefficient inserted being stored as a zero
+    EXPECT_EQ(frozen.matrix().nonZeros(), reference.matrix().nonZeros() + 1);
+    EXPECT_EQ(frozen(0, N-1), 0.);
+}
+
+template <typename EigenSparse>
+void test_counting_sort_conversion() {
+    using EigenMatrix = SofaCaribou::Algebra::EigenMatrix<EigenSparse>;
+
+    const int N = 50;
+    EigenMatrix counting_sort(N, N), reference(N, N);
+    counting_sort.set_parallel_conversion_threshold(0);
+
+    // Random coefficients with many duplicates, an empty row and an empty column
+    std::vector<Eigen::Triplet<double>> triplets;
+    for (int k = 0; k < 2000; ++k) {
+        const auto i = std::rand() % N;
+        const auto j = std::rand() % N;
+        if (i != 7 and j != 13) {
+            triplets.emplace_back(i, j, static_cast<double>(std::rand()) / RAND_MAX - 0.5);
+        }
+    }
+
+    for (auto * m : {&counting_sort, &reference}) {
+        for (const auto & t : triplets) {
+            m->add(t.row(), t.col(), t.value());
+        }
+        m->compress();
+    }
+
+    const EigenSparse & A = counting_sort.matrix();
+    const EigenSparse & B = reference.matrix();
+    EXPECT_TRUE(A.isCompressed());
+    ASSERT_EQ(A.nonZeros(), B.nonZeros());
+    for (Eigen::Index i = 0; i <= A.outerSize(); ++i) {
+        EXPECT_EQ(A.outerIndexPtr()[i], B.outerIndexPtr()[i]);
+    }
+    for (Eigen::Index k = 0; k < A.nonZeros(); ++k) {
+        EXPECT_EQ(A.innerIndexPtr()[k], B.innerIndexPtr()[k]);
+        EXPECT_EQ(A.valuePtr()[k], B.valuePtr()[k]);
+    }
+}
+
+TEST(Algebra, SparseMatrixCountingSortConversion) {
+    test_counting_sort_conversion<Eigen::SparseMatrix<double, Eigen::ColMajor>>();
+    test_counting_sort_conversion<Eigen::SparseMatrix<double, Eigen::RowMajor>>();
+}
+
+TEST(Algebra, SparseMatrixBatchedClearing) {
+    using EigenSparse = Eigen::SparseMatrix<double>;
+    using EigenMatrix = SofaCaribou::Algebra::EigenMatrix<EigenSparse>;
+
+    const int N = 30;
+    EigenMatrix batched(N, N), reference(N, N);
+    for (auto * m : {&batched, &reference}) {
+        for (int i = 0; i < N-3; i += 3) {
+            m->add(i, i, Mat3x3d(4));
+            m->add(i, i+3, Mat3x3d(-1));
+            m->add(i+3, i, Mat3x3d(-1));
+        }
+        m->compress();
+    }
+
+    // Same calls than the ones of a projective constraint, the last set of the DOF 3 being overridden by a clearing
+    batched.begin_batched_clearing();
+    for (auto * m : {&batched, &reference}) {
+        m->clearRowCol(3);
+        m->set(3, 3, 1.);
+        m->clearRow(10);
+        m->clearCols(20, 22);
+        m->add(21, 21, 2.);
+        m->set(4, 4, 5.);
+        m->clearRowCol(4);
+    }
+
+    // Nothing is cleared until the end of the batch
+    EXPECT_EQ(batched(3, 3), 4.);
+    batched.end_batched_clearing();
+    EXPECT_DOUBLE_EQ((Eigen::MatrixXd(batched.matrix()) - Eigen::MatrixXd(reference.matrix())).norm(), 0.);
+    EXPECT_EQ(batched(3, 3), 1.);
+    EXPECT_EQ(batched(21, 21), 2.);
+    EXPECT_EQ(batched(4, 4), 0.);
+
+    // Masks of rows and columns
+    std::vector<bool> rows (N, false), columns (N, false);
+    rows[0] = columns[5] = true;
+    batched.clear_rows_and_columns(rows, columns);
+    reference.clearRow(0);
+    reference.clearCol(5);
+    EXPECT_DOUBLE_EQ((Eigen::MatrixXd(batched.matrix()) - Eigen::MatrixXd(reference.matrix())).norm(), 0.);
+}
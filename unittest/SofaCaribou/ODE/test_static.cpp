@@ -1,4 +1,10 @@
 #include <array>
+#include <cmath>
+#include <map>
+#include <numeric>
+#include <string>
+#include <tuple>
+#include <vector>
 
 #include <SofaCaribou/config.h>
 #include <SofaCaribou/Ode/StaticODESolver.h>
@@ -20,6 +26,98 @@ using namespace sofa::helper::logging;
 using namespace sofa::testing;
 #endif
 
+namespace {
+/**
+ * Beam fixed on one end and bent by a traction applied on the other end, solved by a StaticODESolver. The scene is
+ * unloaded when the object is destroyed.
+ */
+struct BeamScene {
+    /**
+     * @param solver_options Data fields of the StaticODESolver.
+     * @param linear_solver Type of the linear solver component.
+     * @param linear_solver_options Data fields of the linear solver.
+     * @param slope Slope of the load increments of the traction (0 to apply the whole load at once).
+     * @param mapped_forcefield If true, the hyperelastic force field is applied on a mechanical object mapped on the
+     *                          beam through an identity mapping.
+     * @param line_projection_direction If not empty, the node at the center of the end-surface of the beam is
+     *                                  constrained to move on the line of this direction passing through it.
+     */
+    explicit BeamScene(const std::map<std::string, std::string> & solver_options,
+                       const std::string & linear_solver = "LDLTSolver",
+                       const std::map<std::string, std::string> & linear_solver_options = {},
+                       const std::string & slope = "0.2",
+                       bool mapped_forcefield = false,
+                       const std::string & line_projection_direction = "") {
+        setSimulation(new sofa::simulation::graph::DAGSimulation());
+        root = getSimulation()->createNewNode("root");
+        createObject(root, "RequiredPlugin", {{"pluginName", "SofaBoundaryCondition SofaEngine"}});
+#if (defined(SOFA_VERSION) && SOFA_VERSION > 201299)
+        createObject(root, "RequiredPlugin", {{"pluginName", "SofaTopologyMapping"}});
+#endif
+        createObject(root, "RegularGridTopology", {{"name", "grid"}, {"min", "-7.5 -7.5 0"}, {"max", "7.5 7.5 80"}, {"n", "3 3 9"}});
+
+        auto meca = createChild(root, "meca");
+        solver = dynamic_cast<SofaCaribou::ode::StaticODESolver *>(createObject(meca, "StaticODESolver", solver_options).get());
+        createObject(meca, linear_solver, linear_solver_options);
+        mo = dynamic_cast<sofa::component::container::MechanicalObject<sofa::defaulttype::Vec3Types> *>(
+            createObject(meca, "MechanicalObject", {{"name", "mo"}, {"src", "@../grid"}}).get()
+        );
+        createObject(meca, "HexahedronSetTopologyContainer", {{"name", "mechanical_topology"}, {"src", "@../grid"}});
+
+        auto forcefield_node = meca;
+        if (mapped_forcefield) {
+            forcefield_node = createChild(meca, "mapped");
+            createObject(forcefield_node, "MechanicalObject", {{"name", "mapped_mo"}, {"src", "@../../grid"}});
+            createObject(forcefield_node, "IdentityMapping", {{"input", "@../mo"}, {"output", "@mapped_mo"}});
+        }
+        createObject(forcefield_node, "SaintVenantKirchhoffMaterial", {{"young_modulus", "3000"}, {"poisson_ratio", "0.3"}});
+        createObject(forcefield_node, "HyperelasticForcefield", {{"topology", "@/meca/mechanical_topology"}});
+
+        createObject(meca, "BoxROI", {{"name", "fixed_roi"}, {"box", "-7.5 -7.5 -0.9 7.5 7.5 0.1"}});
+        createObject(meca, "FixedConstraint", {{"indices", "@fixed_roi.indices"}});
+        if (not line_projection_direction.empty()) {
+            createObject(meca, "ProjectToLineConstraint", {{"indices", "76"}, {"origin", "0 0 80"}, {"direction", line_projection_direction}});
+        }
+        createObject(meca, "BoxROI", {{"name", "top_roi"}, {"quad", "@mechanical_topology.quads"}, {"box", "-7.5 -7.5 79.9 7.5 7.5 80.1"}});
+        createObject(meca, "QuadSetTopologyContainer", {{"name", "traction_container"}, {"quads", "@top_roi.quadInROI"}});
+        createObject(meca, "TractionForce", {{"traction", "0 -30 0"}, {"slope", slope}, {"quads", "@traction_container.quads"}});
+
+        getSimulation()->init(root.get());
+    }
+
+    BeamScene(const BeamScene &) = delete;
+    BeamScene & operator=(const BeamScene &) = delete;
+
+    ~BeamScene() {
+        getSimulation()->unload(root);
+    }
+
+    /** Do one time step (one load increment) */
+    void step() const {
+        getSimulation()->animate(root.get(), 1);
+    }
+
+    /** Whether or not the last time step converged */
+    bool converged() const {
+        return solver->findData("converged")->getValueString() == "1";
+    }
+
+    /** Position of the node at the center of the end-surface of the beam (where the traction is applied) */
+    auto middle_point() const {
+        return mo->read(sofa::core::ConstVecCoordId::position())->getValue()[76];
+    }
+
+    /** Position of a node on the fixed end-surface of the beam */
+    auto fixed_point() const {
+        return mo->read(sofa::core::ConstVecCoordId::position())->getValue()[0];
+    }
+
+    sofa::simulation::Node::SPtr root;
+    SofaCaribou::ode::StaticODESolver * solver = nullptr;
+    sofa::component::container::MechanicalObject<sofa::defaulttype::Vec3Types> * mo = nullptr;
+};
+} // namespace
+
 /** Initialization without any linear solver (expecting an error) */
 TEST(StaticODESolver, InitWithoutSolver) {
     MessageDispatcher::addHandler( MainGtestMessageHandler::getInstance() ) ;
@@ -129,6 +227,8 @@ TEST(StaticODESolver, Beam) {
 
     for (unsigned int step_id = 0; step_id < force_residuals.size(); ++step_id) {
         getSimulation()->animate(root.get(), 1);
+        // The beam being the only mechanical object, the system vectors share its memory
+        EXPECT_TRUE(solver->system_vectors_are_shared());
         EXPECT_EQ(solver->squared_residuals().size(), force_residuals[step_id].size());
         for (unsigned int newton_step_id = 0; newton_step_id < solver->squared_residuals().size(); ++newton_step_id) {
             double residual = solver->squared_residuals()[newton_step_id] / solver->squared_residuals()[0];
@@ -144,4 +244,288 @@ TEST(StaticODESolver, Beam) {
     EXPECT_NEAR(middle_point[2],  76.190, 1e-3); // z
 
     getSimulation()->unload(root);
-}
\ No newline at end of file
+}
+
+/** Inexact Newton (Eisenstat-Walker forcing terms) must converge to the same solution as the exact Newton */
+TEST(StaticODESolver, BeamInexactNewton) {
+    MessageDispatcher::addHandler( MainGtestMessageHandler::getInstance() ) ;
+    EXPECT_MSG_NOEMIT(Error);
+
+    const auto simulate = [](const std::string & strategy) {
+        BeamScene beam ({{"newton_iterations", "20"}, {"correction_tolerance_threshold", "-1"}, {"residual_tolerance_threshold", "1e-8"},
+                         {"linear_solver_tolerance_strategy", strategy}},
+                        "ConjugateGradientSolver", {{"preconditioning_method", "Diagonal"}, {"maximum_number_of_iterations", "1000"}, {"residual_tolerance_threshold", "1e-10"}});
+        beam.step();
+
+        EXPECT_TRUE(beam.converged());
+        if (strategy == "EISENSTAT_WALKER") {
+            // One forcing term per Newton iteration, the first one being the maximum, and all of them within (0, 0.5]
+            EXPECT_EQ(beam.solver->forcing_terms().size(), beam.solver->squared_residuals().size());
+            EXPECT_DOUBLE_EQ(beam.solver->forcing_terms().front(), 0.5);
+            for (const auto & forcing_term : beam.solver->forcing_terms()) {
+                EXPECT_GT(forcing_term, 0.);
+                EXPECT_LE(forcing_term, 0.5);
+            }
+        } else {
+            EXPECT_TRUE(beam.solver->forcing_terms().empty());
+        }
+
+        return beam.middle_point();
+    };
+
+    const auto exact = simulate("FIXED");
+    const auto inexact = simulate("EISENSTAT_WALKER");
+    for (unsigned int i = 0; i < 3; ++i) {
+        EXPECT_NEAR(inexact[i], exact[i], 1e-5);
+    }
+}
+
+/** Eliminating the fixed DOFs from the system must give the same Newton iterations as zeroing their rows and columns */
+TEST(StaticODESolver, BeamEliminateConstrainedDofs) {
+    MessageDispatcher::addHandler( MainGtestMessageHandler::getInstance() ) ;
+    EXPECT_MSG_NOEMIT(Error);
+
+    const auto simulate = [](const std::string & eliminate_constrained_dofs) {
+        BeamScene beam ({{"newton_iterations", "10"}, {"correction_tolerance_threshold", "1e-5"}, {"residual_tolerance_threshold", "1e-5"},
+                         {"eliminate_constrained_dofs", eliminate_constrained_dofs}});
+        beam.step();
+
+        EXPECT_TRUE(beam.converged());
+        return std::make_tuple(beam.solver->squared_residuals(), beam.middle_point(), beam.fixed_point());
+    };
+
+    const auto [full_residuals, full_middle_point, full_fixed_point] = simulate("false");
+    const auto [reduced_residuals, reduced_middle_point, reduced_fixed_point] = simulate("true");
+
+    ASSERT_EQ(reduced_residuals.size(), full_residuals.size());
+    for (std::size_t i = 0; i < full_residuals.size(); ++i) {
+        EXPECT_NEAR(sqrt(reduced_residuals[i] / reduced_residuals[0]), sqrt(full_residuals[i] / full_residuals[0]), 1e-10);
+    }
+
+    for (unsigned int i = 0; i < 3; ++i) {
+        EXPECT_NEAR(reduced_middle_point[i], full_middle_point[i], 1e-8);
+        EXPECT_DOUBLE_EQ(reduced_fixed_point[i], full_fixed_point[i]);
+    }
+}
+
+/**
+ * The DOFs projected onto a line must be kept in the reduced system, even when the direction of the line is orthogonal
+ * to the constant probe vector (1, 1, 1) and to the probe vector (1, 2, 3).
+ */
+TEST(StaticODESolver, BeamEliminateConstrainedDofsLineProjection) {
+    MessageDispatcher::addHandler( MainGtestMessageHandler::getInstance() ) ;
+    EXPECT_MSG_NOEMIT(Error);
+
+    const auto simulate = [](const std::string & eliminate_constrained_dofs) {
+        BeamScene beam ({{"newton_iterations", "10"}, {"correction_tolerance_threshold", "1e-5"}, {"residual_tolerance_threshold", "1e-5"},
+                         {"eliminate_constrained_dofs", eliminate_constrained_dofs}},
+                        "LDLTSolver", {}, "0.2", false, "1 -2 1");
+        beam.step();
+
+        EXPECT_TRUE(beam.converged());
+        return std::make_tuple(beam.solver->squared_residuals(), beam.middle_point());
+    };
+
+    const auto [full_residuals, full_middle_point] = simulate("false");
+    const auto [reduced_residuals, reduced_middle_point] = simulate("true");
+
+    ASSERT_EQ(reduced_residuals.size(), full_residuals.size());
+    for (std::size_t i = 0; i < full_residuals.size(); ++i) {
+        EXPECT_NEAR(sqrt(reduced_residuals[i] / reduced_residuals[0]), sqrt(full_residuals[i] / full_residuals[0]), 1e-10);
+    }
+
+    for (unsigned int i = 0; i < 3; ++i) {
+        EXPECT_NEAR(reduced_middle_point[i], full_middle_point[i], 1e-8);
+    }
+
+    // The node moved along the line (1, -2, 1) passing through its rest position (0, 0, 80)
+    EXPECT_GT(std::abs(reduced_middle_point[1]), 1e-3);
+    EXPECT_NEAR(reduced_middle_point[0], -reduced_middle_point[1] / 2., 1e-8);
+    EXPECT_NEAR(reduced_middle_point[2] - 80., -reduced_middle_point[1] / 2., 1e-8);
+}
+
+/** The modified and quasi-Newton strategies must converge to the same solution while factorizing the system matrix less often */
+TEST(StaticODESolver, BeamModifiedNewton) {
+    MessageDispatcher::addHandler( MainGtestMessageHandler::getInstance() ) ;
+    EXPECT_MSG_NOEMIT(Error);
+
+    const auto simulate = [](const std::string & strategy) {
+        BeamScene beam ({{"newton_iterations", "50"}, {"correction_tolerance_threshold", "-1"}, {"residual_tolerance_threshold", "1e-8"},
+                         {"jacobian_update_strategy", strategy}, {"maximum_contraction_rate", "0.5"}});
+
+        // Total number of factorizations over a few load increments
+        UNSIGNED_INTEGER_TYPE number_of_factorizations = 0;
+        for (unsigned int step_id = 0; step_id < 3; ++step_id) {
+            beam.step();
+            EXPECT_TRUE(beam.converged());
+            if (strategy == "FULL_NEWTON") {
+                EXPECT_EQ(beam.solver->number_of_factorizations(), beam.solver->squared_residuals().size());
+            } else {
+                EXPECT_LE(beam.solver->number_of_factorizations(), beam.solver->squared_residuals().size());
+            }
+            number_of_factorizations += beam.solver->number_of_factorizations();
+        }
+
+        return std::make_pair(beam.middle_point(), number_of_factorizations);
+    };
+
+    const auto [full_middle_point, full_number_of_factorizations] = simulate("FULL_NEWTON");
+    const auto [modified_middle_point, modified_number_of_factorizations] = simulate("MODIFIED_NEWTON");
+    const auto [quasi_middle_point, quasi_number_of_factorizations] = simulate("QUASI_NEWTON");
+    EXPECT_LT(modified_number_of_factorizations, full_number_of_factorizations);
+    EXPECT_LT(quasi_number_of_factorizations, full_number_of_factorizations);
+    for (unsigned int i = 0; i < 3; ++i) {
+        EXPECT_NEAR(modified_middle_point[i], full_middle_point[i], 1e-5);
+        EXPECT_NEAR(quasi_middle_point[i], full_middle_point[i], 1e-5);
+    }
+}
+
+/** The modified and quasi-Newton strategies must also work with an iterative solver, which only keeps a reference to the system matrix */
+TEST(StaticODESolver, BeamModifiedNewtonIterativeSolver) {
+    MessageDispatcher::addHandler( MainGtestMessageHandler::getInstance() ) ;
+    EXPECT_MSG_NOEMIT(Error);
+
+    const auto simulate = [](const std::string & strategy) {
+        BeamScene beam ({{"newton_iterations", "50"}, {"correction_tolerance_threshold", "-1"}, {"residual_tolerance_threshold", "1e-8"},
+                         {"jacobian_update_strategy", strategy}, {"maximum_contraction_rate", "0.5"}},
+                        "ConjugateGradientSolver", {{"preconditioning_method", "Diagonal"}, {"maximum_number_of_iterations", "1000"}, {"residual_tolerance_threshold", "1e-10"}});
+
+        UNSIGNED_INTEGER_TYPE number_of_factorizations = 0;
+        for (unsigned int step_id = 0; step_id < 3; ++step_id) {
+            beam.step();
+            EXPECT_TRUE(beam.converged());
+            number_of_factorizations += beam.solver->number_of_factorizations();
+        }
+
+        return std::make_pair(beam.middle_point(), number_of_factorizations);
+    };
+
+    const auto [full_middle_point, full_number_of_factorizations] = simulate("FULL_NEWTON");
+    const auto [modified_middle_point, modified_number_of_factorizations] = simulate("MODIFIED_NEWTON");
+    const auto [quasi_middle_point, quasi_number_of_factorizations] = simulate("QUASI_NEWTON");
+    EXPECT_LT(modified_number_of_factorizations, full_number_of_factorizations);
+    EXPECT_LT(quasi_number_of_factorizations, full_number_of_factorizations);
+    for (unsigned int i = 0; i < 3; ++i) {
+        EXPECT_NEAR(modified_middle_point[i], full_middle_point[i], 1e-5);
+        EXPECT_NEAR(quasi_middle_point[i], full_middle_point[i], 1e-5);
+    }
+}
+
+/** The backtracking line search must converge to the same solution as the full Newton steps */
+TEST(StaticODESolver, BeamLineSearch) {
+    MessageDispatcher::addHandler( MainGtestMessageHandler::getInstance() ) ;
+    EXPECT_MSG_NOEMIT(Error);
+
+    const auto simulate = [](const std::string & strategy) {
+        BeamScene beam ({{"newton_iterations", "20"}, {"correction_tolerance_threshold", "-1"}, {"residual_tolerance_threshold", "1e-8"},
+                         {"line_search_strategy", strategy}});
+
+        for (unsigned int step_id = 0; step_id < 5; ++step_id) {
+            beam.step();
+            EXPECT_TRUE(beam.converged());
+            if (strategy == "BACKTRACKING") {
+                EXPECT_EQ(beam.solver->step_lengths().size(), beam.solver->squared_residuals().size());
+                for (const auto & alpha : beam.solver->step_lengths()) {
+                    EXPECT_GT(alpha, 0);
+                    EXPECT_LE(alpha, 1);
+                }
+            } else {
+                EXPECT_TRUE(beam.solver->step_lengths().empty());
+            }
+        }
+
+        return beam.middle_point();
+    };
+
+    const auto full_steps = simulate("NONE");
+    const auto line_search = simulate("BACKTRACKING");
+    for (unsigned int i = 0; i < 3; ++i) {
+        EXPECT_NEAR(line_search[i], full_steps[i], 1e-5);
+    }
+}
+
+/** The adaptive load stepping must split a load that can't be solved at once, and reach the same equilibrium */
+TEST(StaticODESolver, BeamAdaptiveStepping) {
+    MessageDispatcher::addHandler( MainGtestMessageHandler::getInstance() ) ;
+    EXPECT_MSG_NOEMIT(Error);
+
+    const auto simulate = [](const std::string & newton_iterations, const std::string & slope, const std::string & adaptive_stepping, unsigned int number_of_steps) {
+        BeamScene beam ({{"newton_iterations", newton_iterations}, {"correction_tolerance_threshold", "-1"}, {"residual_tolerance_threshold", "1e-8"},
+                         {"adaptive_stepping", adaptive_stepping}},
+                        "LDLTSolver", {}, slope);
+
+        for (unsigned int step_id = 0; step_id < number_of_steps; ++step_id) {
+            beam.step();
+            EXPECT_TRUE(beam.converged());
+        }
+
+        const auto accepted_steps = dynamic_cast<sofa::core::objectmodel::Data<sofa::helper::vector<double>> *>(beam.solver->findData("accepted_steps"))->getValue();
+        return std::make_pair(beam.middle_point(), accepted_steps);
+    };
+
+    // Reference: the load is applied in 5 increments
+    const auto [reference_middle_point, reference_accepted_steps] = simulate("20", "0.2", "false", 5);
+    EXPECT_TRUE(reference_accepted_steps.empty());
+
+    // The whole load is applied at once, with too few Newton iterations to solve it in a single increment
+    const auto [adaptive_middle_point, adaptive_accepted_steps] = simulate("3", "0", "true", 1);
+    EXPECT_GT(adaptive_accepted_steps.size(), 1);
+    EXPECT_NEAR(std::accumulate(adaptive_accepted_steps.begin(), adaptive_accepted_steps.end(), 0.), 1., 1e-10);
+    for (unsigned int i = 0; i < 3; ++i) {
+        EXPECT_NEAR(adaptive_middle_point[i], reference_middle_point[i], 1e-5);
+    }
+
+    // With a single Newton iteration per step, the adaptive stepping is not used and the step is solved as usual
+    const auto single_iteration = [](const std::string & adaptive_stepping) {
+        BeamScene beam ({{"newton_iterations", "1"}, {"adaptive_stepping", adaptive_stepping}});
+        beam.step();
+
+        const auto accepted_steps = dynamic_cast<sofa::core::objectmodel::Data<sofa::helper::vector<double>> *>(beam.solver->findData("accepted_steps"))->getValue();
+        EXPECT_TRUE(accepted_steps.empty());
+        EXPECT_EQ(beam.solver->squared_residuals().size(), 1);
+        return beam.middle_point();
+    };
+
+    const auto single_iteration_middle_point = single_iteration("false");
+    const auto single_iteration_adaptive_middle_point = single_iteration("true");
+    EXPECT_GT(std::abs(single_iteration_middle_point[1]), 1e-3);
+    for (unsigned int i = 0; i < 3; ++i) {
+        EXPECT_DOUBLE_EQ(single_iteration_adaptive_middle_point[i], single_iteration_middle_point[i]);
+    }
+}
+
+/** The stiffness of a mapped force field must not accumulate from one assembly to the other */
+TEST(StaticODESolver, BeamMappedForcefield) {
+    MessageDispatcher::addHandler( MainGtestMessageHandler::getInstance() ) ;
+    EXPECT_MSG_NOEMIT(Error);
+
+    const auto simulate = [](bool mapped_forcefield) {
+        BeamScene beam ({{"newton_iterations", "20"}, {"correction_tolerance_threshold", "-1"}, {"residual_tolerance_threshold", "1e-8"}},
+                        "LDLTSolver", {}, "0.2", mapped_forcefield);
+
+        std::vector<std::vector<FLOATING_POINT_TYPE>> residuals;
+        for (unsigned int step_id = 0; step_id < 5; ++step_id) {
+            beam.step();
+            EXPECT_TRUE(beam.converged());
+            residuals.push_back(beam.solver->squared_residuals());
+        }
+
+        return std::make_pair(beam.middle_point(), residuals);
+    };
+
+    const auto [direct_middle_point, direct_residuals] = simulate(false);
+    const auto [mapped_middle_point, mapped_residuals] = simulate(true);
+
+    // Same Newton iterations at every time step
+    ASSERT_EQ(mapped_residuals.size(), direct_residuals.size());
+    for (std::size_t step_id = 0; step_id < direct_residuals.size(); ++step_id) {
+        ASSERT_EQ(mapped_residuals[step_id].size(), direct_residuals[step_id].size());
+        for (std::size_t i = 0; i < direct_residuals[step_id].size(); ++i) {
+            EXPECT_NEAR(sqrt(mapped_residuals[step_id][i]), sqrt(direct_residuals[step_id][i]), 1e-8 + 1e-6*sqrt(direct_residuals[step_id][i]));
+        }
+    }
+
+    for (unsigned int i = 0; i < 3; ++i) {
+        EXPECT_NEAR(mapped_middle_point[i], direct_middle_point[i], 1e-8);
+    }
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <SofaCaribou/config.h>
+
+DISABLE_ALL_WARNINGS_BEGIN
+#include <sofa/defaulttype/BaseMatrix.h>
+DISABLE_ALL_WARNINGS_END
+
+/**
+ * Fill the matrix A with the 5-points finite difference Laplacian of a n x n grid, and compress it. When
+ * diagonal_couplings is true, the diagonal neighbours of each node are also coupled, which changes the pattern but not
+ * the size of the matrix.
+ */
+inline void assemble_laplacian(int n, sofa::defaulttype::BaseMatrix * A, bool diagonal_couplings = false) {
+    const auto node = [n](int i, int j) { return j*n + i; };
+    for (int j = 0; j < n; ++j) for (int i = 0; i < n; ++i) {
+        A->add(node(i, j), node(i, j), diagonal_couplings ? 6. : 4.);
+        if (i > 0)   A->add(node(i, j), node(i-1, j), -1.);
+        if (i < n-1) A->add(node(i, j), node(i+1, j), -1.);
+        if (j > 0)   A->add(node(i, j), node(i, j-1), -1.);
+        if (j < n-1) A->add(node(i, j), node(i, j+1), -1.);
+        if (diagonal_couplings) {
+            if (i > 0   and j > 0)   A->add(node(i, j), node(i-1, j-1), -0.5);
+            if (i < n-1 and j < n-1) A->add(node(i, j), node(i+1, j+1), -0.5);
+            if (i > 0   and j < n-1) A->add(node(i, j), node(i-1, j+1), -0.5);
+            if (i < n-1 and j > 0)   A->add(node(i, j), node(i+1, j-1), -0.5);
+        }
+    }
+    A->compress();
+}
@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+
+#include <SofaCaribou/config.h>
+#include <SofaCaribou/Solver/AMGPreconditioner.h>
+
+#include <Eigen/Dense>
+#include <Eigen/Sparse>
+#include <Eigen/IterativeLinearSolvers>
+
+using SparseMatrix = Eigen::SparseMatrix<FLOATING_POINT_TYPE>;
+using Vector = Eigen::Matrix<FLOATING_POINT_TYPE, Eigen::Dynamic, 1>;
+
+namespace {
+/**
+ * Assemble the linear elastic stiffness matrix of a unit cube beam discretized with n x n x 3n cubes (each one
+ * divided into 5 linear tetrahedrons). The nodes of the bottom face are fixed: their rows and columns are cleared and
+ * their diagonal is set to one, as it is done by the projective constraints.
+ */
+void assemble_beam(int n, FLOATING_POINT_TYPE poisson_ratio, SparseMatrix & K, Vector & X) {
+    const int nx = n+1, ny = n+1, nz = 3*n+1;
+    const auto node = [&](int i, int j, int k) { return (k*ny + j)*nx + i; };
+    const auto h = static_cast<FLOATING_POINT_TYPE>(1. / n);
+
+    X.resize(3*nx*ny*nz);
+    for (int k = 0; k < nz; ++k) for (int j = 0; j < ny; ++j) for (int i = 0; i < nx; ++i) {
+        X.segment<3>(3*node(i,j,k)) << i*h, j*h, k*h;
+    }
+
+    const FLOATING_POINT_TYPE young_modulus = 1000.;
+    const FLOATING_POINT_TYPE l = young_modulus*poisson_ratio / ((1 + poisson_ratio) * (1 - 2*poisson_ratio));
+    const FLOATING_POINT_TYPE m = young_modulus / (2 * (1 + poisson_ratio));
+    Eigen::Matrix<FLOATING_POINT_TYPE, 6, 6> C = Eigen::Matrix<FLOATING_POINT_TYPE, 6, 6>::Zero();
+    C.topLeftCorner<3,3>().setConstant(l);
+    C.diagonal() << l+2*m, l+2*m, l+2*m, m, m, m;
+
+    constexpr int tetrahedrons[5][4] = {{0,1,2,4}, {1,2,3,7}, {1,4,5,7}, {2,4,6,7}, {1,2,4,7}};
+    std::vector<Eigen::Triplet<FLOATING_POINT_TYPE>> triplets;
+    for (int k = 0; k < nz-1; ++k) for (int j = 0; j < ny-1; ++j) for (int i = 0; i < nx-1; ++i) {
+        int corners[8];
+        for (int c = 0; c < 8; ++c) {
+            corners[c] = node(i + (c&1), j + ((c>>1)&1), k + ((c>>2)&1));
+        }
+        for (const auto & tetrahedron : tetrahedrons) {
+            Eigen::Matrix<FLOATING_POINT_TYPE, 4, 4> M;
+            for (int a = 0; a < 4; ++a) {
+                M.row(a) << 1, X.segment<3>(3*corners[tetrahedron[a]]).transpose();
+            }
+            const FLOATING_POINT_TYPE volume = std::abs(M.determinant()) / 6.;
+            const Eigen::Matrix<FLOATING_POINT_TYPE, 4, 4> dN = M.inverse();
+
+            Eigen::Matrix<FLOATING_POINT_TYPE, 6, 12> B = Eigen::Matrix<FLOATING_POINT_TYPE, 6, 12>::Zero();
+            for (int a = 0; a < 4; ++a) {
+                const auto dx = dN(1, a), dy = dN(2, a), dz = dN(3, a);
+                B(0, 3*a) = dx; B(1, 3*a+1) = dy; B(2, 3*a+2) = dz;
+                B(3, 3*a) = dy; B(3, 3*a+1) = dx;
+                B(4, 3*a+1) = dz; B(4, 3*a+2) = dy;
+                B(5, 3*a) = dz; B(5, 3*a+2) = dx;
+            }
+            const Eigen::Matrix<FLOATING_POINT_TYPE, 12, 12> Ke = volume * B.transpose() * C * B;
+            for (int a = 0; a < 4; ++a) for (int b = 0; b < 4; ++b) for (int d = 0; d < 3; ++d) for (int e = 0; e < 3; ++e) {
+                triplets.emplace_back(3*corners[tetrahedron[a]]+d, 3*corners[tetrahedron[b]]+e, Ke(3*a+d, 3*b+e));
+            }
+        }
+    }
+
+    K.resize(X.size(), X.size());
+    K.setFromTriplets(triplets.begin(), triplets.end());
+
+    // Fixed bottom face
+    const auto is_fixed = [&](Eigen::Index dof) { return dof < 3*nx*ny; };
+    for (Eigen::Index col = 0; col < K.outerSize(); ++col) {
+        for (SparseMatrix::InnerIterator it(K, col); it; ++it) {
+            if (is_fixed(it.row()) or is_fixed(it.col())) {
+                it.valueRef() = (it.row() == it.col()) ? 1. : 0.;
+            }
+        }
+    }
+    K.prune(0.);
+}
+} // namespace
+
+TEST(AMGPreconditioner, Hierarchy) {
+    SparseMatrix K; Vector X;
+    assemble_beam(6, 0.3, K, X);
+
+    SofaCaribou::solver::AMGPreconditioner amg;
+    amg.set_coordinates(X, 3);
+    amg.set_maximum_coarse_size(100);
+    amg.compute(K);
+
+    ASSERT_EQ(amg.info(), Eigen::Success);
+    ASSERT_GE(amg.levels().size(), 2);
+    for (std::size_t i = 1; i < amg.levels().size(); ++i) {
+        const auto & level = amg.levels()[i];
+        // Six rigid body modes per aggregate
+        EXPECT_EQ(level.A.rows() % 6, 0);
+        EXPECT_LT(level.A.rows(), amg.levels()[i-1].A.rows());
+        // The Galerkin product must keep the symmetry
+        EXPECT_NEAR((Eigen::MatrixXd(level.A) - Eigen::MatrixXd(level.A).transpose()).norm() / level.A.norm(), 0, 1e-10);
+    }
+}
+
+TEST(AMGPreconditioner, ConjugateGradient) {
+    using CG = Eigen::ConjugateGradient<SparseMatrix, Eigen::Lower|Eigen::Upper, SofaCaribou::solver::AMGPreconditioner>;
+    using DiagonalCG = Eigen::ConjugateGradient<SparseMatrix, Eigen::Lower|Eigen::Upper, Eigen::DiagonalPreconditioner<FLOATING_POINT_TYPE>>;
+
+    std::vector<Eigen::Index> iterations;
+    for (const int n : {4, 8}) {
+        SparseMatrix K; Vector X;
+        assemble_beam(n, 0.3, K, X);
+        const Vector b = Vector::Random(K.rows());
+
+        CG cg;
+        cg.setTolerance(1e-8);
+        cg.setMaxIterations(1000);
+        cg.preconditioner().set_coordinates(X, 3);
+        cg.preconditioner().set_maximum_coarse_size(200);
+        cg.compute(K);
+        const Vector x = cg.solve(b);
+
+        EXPECT_EQ(cg.info(), Eigen::Success);
+        EXPECT_LT((K*x - b).norm() / b.norm(), 1e-7);
+
+        DiagonalCG diagonal_cg;
+        diagonal_cg.setTolerance(1e-8);
+        diagonal_cg.setMaxIterations(5000);
+        diagonal_cg.compute(K);
+        const Vector y = diagonal_cg.solve(b);
+        EXPECT_LT(cg.iterations(), diagonal_cg.iterations());
+
+        iterations.emplace_back(cg.iterations());
+    }
+
+    // The number of iterations should stay nearly flat as the mesh is refined (8 times more nodes here)
+    EXPECT_LE(iterations[1], iterations[0] + 5);
+}
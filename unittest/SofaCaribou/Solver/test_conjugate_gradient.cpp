@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+
+#include <SofaCaribou/config.h>
+#include <SofaCaribou/Algebra/EigenMatrix.h>
+#include <SofaCaribou/Algebra/EigenVector.h>
+#include <SofaCaribou/Solver/ConjugateGradientSolver.h>
+
+DISABLE_ALL_WARNINGS_BEGIN
+#include <sofa/core/objectmodel/BaseObject.h>
+DISABLE_ALL_WARNINGS_END
+
+#include <memory>
+
+#include <Eigen/Sparse>
+
+#include "solver_test.h"
+
+using SofaCaribou::solver::ConjugateGradientSolver;
+using SparseMatrix = ConjugateGradientSolver::SparseMatrix;
+using Vector = ConjugateGradientSolver::Vector;
+using EigenMatrix = SofaCaribou::Algebra::EigenMatrix<SparseMatrix>;
+using EigenVector = SofaCaribou::Algebra::EigenVector<Vector>;
+
+TEST(ConjugateGradientSolver, MultipleRightHandSides) {
+    constexpr int n = 30;
+    constexpr int number_of_rhs = 6;
+    auto solver = sofa::core::objectmodel::New<ConjugateGradientSolver>();
+    solver->findData("preconditioning_method")->read("Diagonal");
+    solver->findData("maximum_number_of_iterations")->read("1000");
+    solver->findData("residual_tolerance_threshold")->read("1e-10");
+
+    std::unique_ptr<sofa::defaulttype::BaseMatrix> A (solver->create_new_matrix(n*n, n*n));
+    assemble_laplacian(n, A.get());
+    ASSERT_TRUE(solver->analyze_pattern(A.get()));
+    ASSERT_TRUE(solver->factorize(A.get()));
+
+    // Right-hand sides, with a linearly dependent one and a null one
+    std::vector<std::unique_ptr<sofa::defaulttype::BaseVector>> F, X;
+    for (int i = 0; i < number_of_rhs; ++i) {
+        F.emplace_back(solver->create_new_vector(n*n));
+        X.emplace_back(solver->create_new_vector(n*n));
+        dynamic_cast<EigenVector *>(F.back().get())->vector() = Vector::Random(n*n);
+    }
+    dynamic_cast<EigenVector *>(F[1].get())->vector() = 2 * dynamic_cast<EigenVector *>(F[0].get())->vector();
+    dynamic_cast<EigenVector *>(F[2].get())->vector().setZero();
+
+    // Independent solves
+    std::size_t maximum_number_of_iterations = 0;
+    std::vector<Vector> solutions;
+    for (int i = 0; i < number_of_rhs; ++i) {
+        ASSERT_TRUE(solver->solve(F[i].get(), X[i].get()));
+        maximum_number_of_iterations = std::max(maximum_number_of_iterations, solver->squared_residuals().size());
+        solutions.emplace_back(dynamic_cast<EigenVector *>(X[i].get())->vector());
+    }
+
+    // Block solve
+    std::vector<const sofa::defaulttype::BaseVector *> F_ptr;
+    std::vector<sofa::defaulttype::BaseVector *> X_ptr;
+    for (int i = 0; i < number_of_rhs; ++i) {
+        F_ptr.emplace_back(F[i].get());
+        X_ptr.emplace_back(X[i].get());
+        dynamic_cast<EigenVector *>(X[i].get())->vector().setRandom(); // Must be overridden by the solve
+    }
+    ASSERT_TRUE(solver->solve_multiple(F_ptr, X_ptr));
+    EXPECT_LT(solver->squared_residuals().size(), maximum_number_of_iterations);
+
+    const auto & K = dynamic_cast<EigenMatrix *>(A.get())->matrix();
+    for (int i = 0; i < number_of_rhs; ++i) {
+        const auto & f = dynamic_cast<EigenVector *>(F[i].get())->vector();
+        const auto & x = dynamic_cast<EigenVector *>(X[i].get())->vector();
+        if (i == 2) {
+            EXPECT_EQ(x.norm(), 0);
+        } else {
+            EXPECT_LT((K*x - f).norm() / f.norm(), 1e-9);
+            EXPECT_LT((x - solutions[i]).norm() / solutions[i].norm(), 1e-7);
+        }
+    }
+}
+
+TEST(ConjugateGradientSolver, LaggedCholeskyPreconditioner) {
+    constexpr int n = 30;
+    for (const std::string method : {"LLT", "LDLT"}) {
+        auto solver = sofa::core::objectmodel::New<ConjugateGradientSolver>();
+        solver->findData("preconditioning_method")->read(method);
+        solver->findData("preconditioner_update_strategy")->read("EVERY_N_ASSEMBLIES");
+        solver->findData("preconditioner_update_interval")->read("10");
+        solver->findData("maximum_number_of_iterations")->read("100");
+        solver->findData("residual_tolerance_threshold")->read("1e-10");
+
+        std::unique_ptr<sofa::defaulttype::BaseMatrix> A (solver->create_new_matrix(n*n, n*n));
+        std::unique_ptr<sofa::defaulttype::BaseVector> F (solver->create_new_vector(n*n));
+        std::unique_ptr<sofa::defaulttype::BaseVector> X (solver->create_new_vector(n*n));
+        assemble_laplacian(n, A.get());
+        dynamic_cast<EigenVector *>(F.get())->vector() = Vector::Random(n*n);
+
+        // With the exact factorization of the current matrix, a single iteration is needed
+        ASSERT_TRUE(solver->analyze_pattern(A.get()));
+        ASSERT_TRUE(solver->factorize(A.get()));
+        ASSERT_TRUE(solver->solve(F.get(), X.get()));
+        EXPECT_LE(solver->squared_residuals().size(), 2) << method;
+
+        // Slightly modify the matrix (as a tangent stiffness would between two Newton iterations): the factorization
+        // of the previous matrix is reused, and only a few iterations are needed
+        for (int i = 0; i < n*n; ++i) {
+            A->add(i, i, 0.2);
+        }
+        A->compress();
+        ASSERT_TRUE(solver->factorize(A.get()));
+        ASSERT_TRUE(solver->solve(F.get(), X.get()));
+        EXPECT_LE(solver->squared_residuals().size(), 10) << method;
+
+        const auto & K = dynamic_cast<EigenMatrix *>(A.get())->matrix();
+        const auto & f = dynamic_cast<EigenVector *>(F.get())->vector();
+        const auto & x = dynamic_cast<EigenVector *>(X.get())->vector();
+        EXPECT_LT((K*x - f).norm() / f.norm(), 1e-9) << method;
+    }
+}
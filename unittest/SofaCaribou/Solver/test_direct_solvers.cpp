@@ -0,0 +1,210 @@
+#include <gtest/gtest.h>
+
+#include <SofaCaribou/config.h>
+#include <SofaCaribou/Algebra/EigenMatrix.h>
+#include <SofaCaribou/Algebra/EigenVector.h>
+#include <SofaCaribou/Algebra/SparsityPattern.h>
+#include <SofaCaribou/Solver/LLTSolver.inl>
+
+DISABLE_ALL_WARNINGS_BEGIN
+#include <sofa/core/objectmodel/BaseObject.h>
+DISABLE_ALL_WARNINGS_END
+
+#include <map>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+#include <Eigen/Sparse>
+#include <Eigen/SparseCholesky>
+
+#include "solver_test.h"
+
+using SparseMatrix = Eigen::SparseMatrix<FLOATING_POINT_TYPE, Eigen::ColMajor, int>;
+using Vector = Eigen::Matrix<FLOATING_POINT_TYPE, Eigen::Dynamic, 1>;
+using LLTSolver = SofaCaribou::solver::LLTSolver<Eigen::SimplicialLLT<SparseMatrix, Eigen::Upper, Eigen::NaturalOrdering<int>>>;
+using EigenMatrix = SofaCaribou::Algebra::EigenMatrix<SparseMatrix>;
+using EigenVector = SofaCaribou::Algebra::EigenVector<Vector>;
+
+TEST(DirectSolvers, PatternFingerprint) {
+    constexpr int n = 10;
+    EigenMatrix A(n*n, n*n), B(n*n, n*n), C(n*n, n*n);
+    assemble_laplacian(n, &A);
+    assemble_laplacian(n, &B);
+    assemble_laplacian(n, &C, true);
+
+    // Same pattern with different values
+    B.add(0, 0, 10.);
+    EXPECT_EQ(SofaCaribou::Algebra::pattern_fingerprint(A.matrix()), SofaCaribou::Algebra::pattern_fingerprint(B.matrix()));
+
+    // Same size with a different pattern
+    EXPECT_NE(SofaCaribou::Algebra::pattern_fingerprint(A.matrix()), SofaCaribou::Algebra::pattern_fingerprint(C.matrix()));
+}
+
+TEST(DirectSolvers, PatternChangeAtSameSize) {
+    constexpr int n = 20;
+    auto solver = sofa::core::objectmodel::New<LLTSolver>();
+    SofaCaribou::solver::LinearSolver * linear_solver = solver.get();
+
+    std::unique_ptr<sofa::defaulttype::BaseVector> F (linear_solver->create_new_vector(n*n));
+    std::unique_ptr<sofa::defaulttype::BaseVector> X (linear_solver->create_new_vector(n*n));
+    dynamic_cast<EigenVector *>(F.get())->vector() = Vector::Random(n*n);
+    const auto & f = dynamic_cast<EigenVector *>(F.get())->vector();
+    const auto & x = dynamic_cast<EigenVector *>(X.get())->vector();
+
+    bool analyzed = false;
+    for (const bool diagonal_couplings : {false, true, true, false}) {
+        std::unique_ptr<sofa::defaulttype::BaseMatrix> A (linear_solver->create_new_matrix(n*n, n*n));
+        assemble_laplacian(n, A.get(), diagonal_couplings);
+
+        // The pattern is analyzed only once (as with the NEVER pattern analysis strategy of the ODE solvers), hence
+        // the solver must detect the structural changes by itself
+        if (not analyzed) {
+            ASSERT_TRUE(linear_solver->analyze_pattern(A.get()));
+            analyzed = true;
+        }
+        ASSERT_TRUE(linear_solver->factorize(A.get()));
+        ASSERT_TRUE(linear_solver->solve(F.get(), X.get()));
+
+        const auto & K = dynamic_cast<EigenMatrix *>(A.get())->matrix();
+        EXPECT_LT((K*x - f).norm() / f.norm(), 1e-10);
+    }
+}
+
+TEST(DirectSolvers, Orderings) {
+    using SofaCaribou::solver::OrderingMethod;
+    constexpr int n = 20;
+    auto solver = sofa::core::objectmodel::New<LLTSolver>();
+    SofaCaribou::solver::LinearSolver * linear_solver = solver.get();
+
+    std::unique_ptr<sofa::defaulttype::BaseMatrix> A (linear_solver->create_new_matrix(n*n, n*n));
+    std::unique_ptr<sofa::defaulttype::BaseVector> F (linear_solver->create_new_vector(n*n));
+    std::unique_ptr<sofa::defaulttype::BaseVector> X (linear_solver->create_new_vector(n*n));
+    assemble_laplacian(n, A.get());
+    dynamic_cast<EigenVector *>(F.get())->vector() = Vector::Random(n*n);
+    const auto & K = dynamic_cast<EigenMatrix *>(A.get())->matrix();
+    const auto & f = dynamic_cast<EigenVector *>(F.get())->vector();
+    const auto & x = dynamic_cast<EigenVector *>(X.get())->vector();
+
+    std::map<OrderingMethod, unsigned int> factor_non_zeros;
+    for (const auto method : {OrderingMethod::Natural, OrderingMethod::AMD, OrderingMethod::COLAMD, OrderingMethod::NestedDissection}) {
+        // The pattern of the matrix doesn't change, but the new ordering must still trigger a new symbolic analysis
+        solver->set_ordering_method(method);
+
+        ASSERT_TRUE(linear_solver->analyze_pattern(A.get()));
+        ASSERT_TRUE(linear_solver->factorize(A.get()));
+        ASSERT_TRUE(linear_solver->solve(F.get(), X.get()));
+        EXPECT_LT((K*x - f).norm() / f.norm(), 1e-10);
+
+        factor_non_zeros[method] = solver->factor_non_zeros();
+    }
+
+    // The fill-reducing orderings must do better than the natural (banded) ordering of the grid
+    EXPECT_LT(factor_non_zeros[OrderingMethod::AMD], factor_non_zeros[OrderingMethod::Natural]);
+    EXPECT_LT(factor_non_zeros[OrderingMethod::NestedDissection], factor_non_zeros[OrderingMethod::Natural]);
+}
+
+TEST(DirectSolvers, NestedDissectionOfDisconnectedGraph) {
+    // Every unknown of a diagonal matrix is its own connected component
+    constexpr int n = 100000;
+    SparseMatrix D(n, n);
+    D.setIdentity();
+
+    Eigen::PermutationMatrix<Eigen::Dynamic, Eigen::Dynamic, int> P;
+    SofaCaribou::solver::NestedDissectionOrdering<int> ordering;
+    ordering(D, P);
+
+    ASSERT_EQ(P.size(), n);
+    std::vector<bool> eliminated(n, false);
+    for (int i = 0; i < n; ++i) {
+        const auto unknown = P.indices()[i];
+        ASSERT_TRUE(unknown >= 0 and unknown < n);
+        EXPECT_FALSE(eliminated[unknown]);
+        eliminated[unknown] = true;
+    }
+}
+
+TEST(DirectSolvers, LowRankUpdate) {
+    constexpr int n = 20;
+    auto solver = sofa::core::objectmodel::New<LLTSolver>();
+    SofaCaribou::solver::LinearSolver * linear_solver = solver.get();
+
+    std::unique_ptr<sofa::defaulttype::BaseVector> F (linear_solver->create_new_vector(n*n));
+    std::unique_ptr<sofa::defaulttype::BaseVector> X (linear_solver->create_new_vector(n*n));
+    dynamic_cast<EigenVector *>(F.get())->vector() = Vector::Random(n*n);
+    const auto & f = dynamic_cast<EigenVector *>(F.get())->vector();
+    const auto & x = dynamic_cast<EigenVector *>(X.get())->vector();
+
+    // Weaken the couplings between a few neighbour nodes (as if the elements between them were cut), which changes the
+    // values of the matrix but not its pattern. The first factorization is complete, the next ones are updates, except
+    // the last one for which the modification has a higher rank than the one allowed.
+    const std::vector<std::tuple<double, unsigned int, bool>> cuts {
+        // cut, maximum rank, factors updated
+        {0.,  50, false},
+        {0.5, 50, true},
+        {0.9, 50, true},
+        {0.,  50, true},
+        {0.5, 2,  false}
+    };
+    unsigned int expected_number_of_low_rank_updates = 0;
+    for (const auto & [cut, maximum_rank, factors_updated] : cuts) {
+        std::unique_ptr<sofa::defaulttype::BaseMatrix> A (linear_solver->create_new_matrix(n*n, n*n));
+        assemble_laplacian(n, A.get());
+        for (int i = 100; i < 105; ++i) {
+            A->add(i, i+1, cut);
+            A->add(i+1, i, cut);
+            A->add(i, i, -cut);
+            A->add(i+1, i+1, -cut);
+        }
+        A->compress();
+
+        ASSERT_TRUE(linear_solver->analyze_pattern(A.get()));
+        ASSERT_TRUE(linear_solver->refactorize(A.get(), maximum_rank));
+        ASSERT_TRUE(linear_solver->solve(F.get(), X.get()));
+
+        const auto & K = dynamic_cast<EigenMatrix *>(A.get())->matrix();
+        EXPECT_LT((K*x - f).norm() / f.norm(), 1e-10);
+
+        if (factors_updated) {
+            ++expected_number_of_low_rank_updates;
+        }
+        EXPECT_EQ(solver->number_of_low_rank_updates(), expected_number_of_low_rank_updates);
+    }
+
+    // Explicit update with two rank-one modifications coupling neighbour nodes
+    std::unique_ptr<sofa::defaulttype::BaseMatrix> A (linear_solver->create_new_matrix(n*n, n*n));
+    std::unique_ptr<sofa::defaulttype::BaseMatrix> W (linear_solver->create_new_matrix(n*n, 2));
+    assemble_laplacian(n, A.get());
+    W->add(3, 0, 1.);
+    W->add(4, 0, 0.5);
+    W->add(3, 1, 0.2);
+    W->add(3+n, 1, 1.);
+    W->compress();
+
+    ASSERT_TRUE(linear_solver->factorize(A.get()));
+    ASSERT_TRUE(linear_solver->update_factorization(W.get(), false));
+    ASSERT_TRUE(linear_solver->solve(F.get(), X.get()));
+
+    const auto & K = dynamic_cast<EigenMatrix *>(A.get())->matrix();
+    const auto & w = dynamic_cast<EigenMatrix *>(W.get())->matrix();
+    const SparseMatrix updated_K = K + SparseMatrix(w * w.transpose());
+    EXPECT_LT((updated_K*x - f).norm() / f.norm(), 1e-10);
+
+    // And back
+    ASSERT_TRUE(linear_solver->update_factorization(W.get(), true));
+    ASSERT_TRUE(linear_solver->solve(F.get(), X.get()));
+    EXPECT_LT((K*x - f).norm() / f.norm(), 1e-10);
+
+    // A downdate that makes the matrix indefinite fails, and the partially updated factors can't be used anymore
+    std::unique_ptr<sofa::defaulttype::BaseMatrix> V (linear_solver->create_new_matrix(n*n, 1));
+    V->add(0, 0, 10.);
+    V->compress();
+    EXPECT_FALSE(linear_solver->update_factorization(V.get(), true));
+    EXPECT_FALSE(linear_solver->solve(F.get(), X.get()));
+    EXPECT_FALSE(linear_solver->update_factorization(W.get(), false));
+
+    // Until the matrix is factorized again
+    ASSERT_TRUE(linear_solver->refactorize(A.get(), 50));
+    ASSERT_TRUE(linear_solver->solve(F.get(), X.get()));
+    EXPECT_LT((K*x - f).norm() / f.norm(), 1e-10);
+}
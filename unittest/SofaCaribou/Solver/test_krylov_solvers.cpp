@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+
+#include <SofaCaribou/config.h>
+#include <SofaCaribou/Algebra/EigenMatrix.h>
+#include <SofaCaribou/Algebra/EigenVector.h>
+#include <SofaCaribou/Solver/BiCGSTABSolver.h>
+#include <SofaCaribou/Solver/GMRESSolver.h>
+
+DISABLE_ALL_WARNINGS_BEGIN
+#include <sofa/core/objectmodel/BaseObject.h>
+DISABLE_ALL_WARNINGS_END
+
+#include <memory>
+
+#include <Eigen/Sparse>
+
+using SofaCaribou::solver::KrylovSolver;
+using SparseMatrix = KrylovSolver::SparseMatrix;
+using Vector = KrylovSolver::Vector;
+using EigenMatrix = SofaCaribou::Algebra::EigenMatrix<SparseMatrix>;
+using EigenVector = SofaCaribou::Algebra::EigenVector<Vector>;
+
+namespace {
+/**
+ * Fill the matrix A with the finite difference convection-diffusion operator -Δu + c.∇u of a n x n grid. The
+ * upwind discretization of the convection term makes the matrix non-symmetric.
+ */
+void assemble_convection_diffusion(int n, FLOATING_POINT_TYPE c, sofa::defaulttype::BaseMatrix * A) {
+    const auto node = [n](int i, int j) { return j*n + i; };
+    for (int j = 0; j < n; ++j) for (int i = 0; i < n; ++i) {
+        A->add(node(i, j), node(i, j), 4. + 2*c);
+        if (i > 0)   A->add(node(i, j), node(i-1, j), -1. - c);
+        if (i < n-1) A->add(node(i, j), node(i+1, j), -1.);
+        if (j > 0)   A->add(node(i, j), node(i, j-1), -1. - c);
+        if (j < n-1) A->add(node(i, j), node(i, j+1), -1.);
+    }
+    dynamic_cast<EigenMatrix *>(A)->compress();
+}
+
+/** Solve a non-symmetric system with the given solver and check its residual */
+void solve_and_check(KrylovSolver * solver, const std::string & preconditioning_method) {
+    constexpr int n = 40;
+    solver->findData("preconditioning_method")->read(preconditioning_method);
+    solver->findData("maximum_number_of_iterations")->read("1000");
+    solver->findData("residual_tolerance_threshold")->read("1e-10");
+
+    // Use the solver through the generic interface of the Caribou linear solvers
+    SofaCaribou::solver::LinearSolver * linear_solver = solver;
+    std::unique_ptr<sofa::defaulttype::BaseMatrix> A (linear_solver->create_new_matrix(n*n, n*n));
+    std::unique_ptr<sofa::defaulttype::BaseVector> F (linear_solver->create_new_vector(n*n));
+    std::unique_ptr<sofa::defaulttype::BaseVector> X (linear_solver->create_new_vector(n*n));
+    assemble_convection_diffusion(n, 5., A.get());
+    dynamic_cast<EigenVector *>(F.get())->vector() = Vector::Random(n*n);
+
+    ASSERT_TRUE(linear_solver->analyze_pattern(A.get()));
+    ASSERT_TRUE(linear_solver->factorize(A.get()));
+    ASSERT_TRUE(linear_solver->solve(F.get(), X.get()));
+
+    const auto & K = dynamic_cast<EigenMatrix *>(A.get())->matrix();
+    const auto & f = dynamic_cast<EigenVector *>(F.get())->vector();
+    const auto & x = dynamic_cast<EigenVector *>(X.get())->vector();
+    EXPECT_LT((K*x - f).norm() / f.norm(), 1e-9) << preconditioning_method;
+    EXPECT_LT(solver->squared_residuals().size(), 1000) << preconditioning_method;
+}
+} // namespace
+
+TEST(KrylovSolvers, GMRES) {
+    auto solver = sofa::core::objectmodel::New<SofaCaribou::solver::GMRESSolver>();
+    solve_and_check(solver.get(), "None");
+    solve_and_check(solver.get(), "Diagonal");
+    solve_and_check(solver.get(), "IncompleteLU");
+}
+
+TEST(KrylovSolvers, BiCGSTAB) {
+    auto solver = sofa::core::objectmodel::New<SofaCaribou::solver::BiCGSTABSolver>();
+    solve_and_check(solver.get(), "None");
+    solve_and_check(solver.get(), "Diagonal");
+    solve_and_check(solver.get(), "IncompleteLU");
+}